@@ -0,0 +1,32 @@
+/**
+ * @copyright 2021 the libaermre authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef INTERNAL_ASSET_H
+#define INTERNAL_ASSET_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* ----- INTERNAL FUNCTIONS ----- */
+
+void AssetManPrescan(void);
+
+bool AssetManValidate(const char* path, uint32_t* width, uint32_t* height);
+
+void AssetManConstructor(void);
+
+void AssetManDestructor(void);
+
+#endif /* INTERNAL_ASSET_H */
@@ -0,0 +1,54 @@
+/**
+ * @copyright 2021 the libaermre authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef INTERNAL_ATLAS_H
+#define INTERNAL_ATLAS_H
+
+/*
+ * This header describes the sprite atlas manifest format, so it is also used
+ * by the host-side packer. A manifest is a text file with one entry per line,
+ * whose fields are separated by single spaces:
+ *
+ *     aeratlas <version>
+ *     page <image filename relative to the manifest>
+ *     ...
+ *     sprite <name> <frames> <width> <height> <origin x> <origin y>
+ *     frame <page> <left> <top>
+ *     ...
+ *
+ * The header comes first and all pages come before any sprite. Each sprite is
+ * followed by exactly `<frames>` frame entries, each of which gives where that
+ * frame's `<width>` by `<height>` pixels are in one of the pages. Neither
+ * names nor filenames may contain whitespace.
+ */
+
+/* ----- INTERNAL MACROS ----- */
+
+#define ATLAS_MAGIC "aeratlas"
+
+#define ATLAS_VERSION 1
+
+#define ATLAS_MAX_LINE_SIZE 1024
+
+/*
+ * Pages, frames and origins must lie within this many pixels per side, and a
+ * sprite may have at most this many frames, which keeps all offsets well
+ * within 32 bits.
+ */
+#define ATLAS_MAX_PAGE_SIZE 16384
+
+#define ATLAS_MAX_FRAMES 16384
+
+#endif /* INTERNAL_ATLAS_H */
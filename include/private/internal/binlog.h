@@ -0,0 +1,112 @@
+/**
+ * @copyright 2021 the libaermre authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef INTERNAL_BINLOG_H
+#define INTERNAL_BINLOG_H
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "internal/log.h"
+
+/*
+ * This header describes the binary log file layout, so it is also used by the
+ * host-side decoder. All fields are little-endian.
+ *
+ * A file starts with a `BinLogHeader` and is followed by records, each of
+ * which starts with a `BinLogRecordHeader` whose `size` includes itself.
+ * Records are published by writing `kind` last, so a record with kind
+ * `BINLOG_NONE` marks the end of the usable data.
+ *
+ * Message arguments follow the message record header in format string order:
+ *  - integers (including `*` widths and precisions): `int64_t`, as read from
+ *    the argument list with their C type and then converted;
+ *  - floating point numbers: `double`;
+ *  - pointers: `uint64_t`;
+ *  - strings: `uint32_t` length followed by that many bytes (no terminator).
+ */
+
+/* ----- INTERNAL MACROS ----- */
+
+#define BINLOG_MAGIC "AERBLOG"
+
+#define BINLOG_VERSION 1
+
+/* ----- INTERNAL TYPES ----- */
+
+typedef enum BinLogKind {
+    BINLOG_NONE,
+    BINLOG_FORMAT,
+    BINLOG_MODULE,
+    BINLOG_MESSAGE,
+    BINLOG_TEXT
+} BinLogKind;
+
+typedef struct __attribute__((packed)) BinLogHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    uint64_t capacity;
+    uint64_t numDropped;
+    uint8_t sizeofInt;
+    uint8_t sizeofLong;
+    uint8_t sizeofSize;
+    uint8_t sizeofPtr;
+    uint32_t reserved;
+} BinLogHeader;
+
+typedef struct __attribute__((packed)) BinLogRecordHeader {
+    uint8_t kind;
+    uint8_t level;
+    uint16_t reserved;
+    uint32_t size;
+} BinLogRecordHeader;
+
+/* Followed by a terminated format string. */
+typedef struct __attribute__((packed)) BinLogFormatRecord {
+    BinLogRecordHeader base;
+    uint32_t formatId;
+} BinLogFormatRecord;
+
+/* Followed by a terminated module name. */
+typedef struct __attribute__((packed)) BinLogModuleRecord {
+    BinLogRecordHeader base;
+    uint32_t moduleId;
+} BinLogModuleRecord;
+
+/* Followed by arguments. `BINLOG_TEXT` records are followed by a terminated,
+ * preformatted message instead and ignore `formatId`. */
+typedef struct __attribute__((packed)) BinLogMessageRecord {
+    BinLogRecordHeader base;
+    uint32_t formatId;
+    uint32_t moduleId;
+    int64_t time;
+} BinLogMessageRecord;
+
+/* ----- INTERNAL FUNCTIONS ----- */
+
+bool BinLogIsOpen(void);
+
+void BinLogWrite(LogLevel logLvl,
+                 const char* moduleName,
+                 const char* fmt,
+                 va_list va);
+
+void BinLogConstructor(void);
+
+void BinLogDestructor(void);
+
+#endif /* INTERNAL_BINLOG_H */
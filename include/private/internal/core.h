@@ -25,12 +25,18 @@ typedef enum CoreStage {
     STAGE_OBJECT_REG,
     STAGE_LISTENER_REG,
     STAGE_ACTION,
+    /* Parallel listeners: getters only (mutators use EnsureStageMut). */
+    STAGE_READ_ONLY,
     STAGE_DRAW
 } CoreStage;
 
 /* ----- INTERNAL GLOBALS ----- */
 
-extern CoreStage stage;
+/*
+ * Each thread has its own stage, so worker threads never pass stage checks
+ * unless given one explicitly (as read-only game step listeners are).
+ */
+extern __thread CoreStage stage;
 
 /* ----- INTERNAL FUNCTIONS ----- */
 
@@ -0,0 +1,38 @@
+/**
+ * @copyright 2021 the libaermre authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef INTERNAL_DRAW_H
+#define INTERNAL_DRAW_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "internal/hld.h"
+
+/* ----- INTERNAL FUNCTIONS ----- */
+
+bool DrawManIsRectVisible(float left, float top, float right, float bottom);
+
+bool DrawManIsInstanceVisible(HLDInstance* inst);
+
+size_t DrawManGetVisibleInstances(size_t bufSize, HLDInstance** instBuf);
+
+void DrawManUpdateVisibility(void);
+
+void DrawManUpdateDrawVisibility(void);
+
+void DrawManDestructor(void);
+
+#endif /* INTERNAL_DRAW_H */
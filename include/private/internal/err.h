@@ -26,36 +26,30 @@
 
 /* ----- INTERNAL MACROS ----- */
 
+/* Skip the function call that the public macro expands to. */
+#undef aererr
+#define aererr (*errLocation)
+
 #define Ok(...)             \
     do {                    \
         aererr = AER_OK;    \
         return __VA_ARGS__; \
     } while (0)
 
-#define Err(err)                                                   \
-    do {                                                           \
-        if (aererr != AER_TRY) {                                   \
-            Mod* Err_mod = ModManGetCurrentMod();                  \
-            if (Err_mod) {                                         \
-                LogWarn(                                           \
-                    "Potentially unhandled error \"%s\" occurred " \
-                    "during call to "                              \
-                    "function \"%s\" by mod \"%s\".",              \
-                    #err, __func__, Err_mod->name);                \
-            } else {                                               \
-                LogWarn(                                           \
-                    "Potentially unhandled error \"%s\" occurred " \
-                    "during internal "                             \
-                    "call to function \"%s\".",                    \
-                    #err, __func__);                               \
-            }                                                      \
-            if (opts.promoteUnhandledErrors) {                     \
-                LogErr("Promoting potentially unhandled error.");  \
-                abort();                                           \
-            }                                                      \
-        }                                                          \
-        aererr = (err);                                            \
-        return errRet;                                             \
+/*
+ * Each call site caches the aggregates it reports into, so an unhandled error
+ * that repeats only costs a cached caller lookup and an atomic increment.
+ */
+#define Err(err)                                                        \
+    do {                                                                \
+        if (aererr != AER_TRY) {                                        \
+            static ErrSite Err_site = {                                 \
+                .func = __func__, .errName = #err, .code = (err)};      \
+            ErrReport(&Err_site, __builtin_extract_return_addr(         \
+                                     __builtin_return_address(0)));     \
+        }                                                               \
+        aererr = (err);                                                 \
+        return errRet;                                                  \
     } while (0)
 
 #define Ensure(cond, err) \
@@ -65,9 +59,21 @@
         }                 \
     } while (0)
 
+/*
+ * Unchecked builds trust mods to pass valid arguments, so argument checks
+ * compile away (but their operands still count as used). Stage checks are
+ * kept, since they are what stops job and parallel listener threads from
+ * calling functions that are only safe on the main thread.
+ */
+#ifdef AER_UNCHECKED
+#define EnsureArg(arg) ((void)sizeof(arg))
+
+#define EnsureArgBuf(buf, size) ((void)sizeof(buf), (void)sizeof(size))
+#else
 #define EnsureArg(arg) Ensure((arg), AER_NULL_ARG)
 
 #define EnsureArgBuf(buf, size) Ensure(((buf) || (size) == 0), AER_NULL_ARG)
+#endif
 
 #define EnsureLookup(item) Ensure((item), AER_FAILED_LOOKUP)
 
@@ -103,4 +109,36 @@
 
 #define EnsureStagePast(pastStage) Ensure((stage > (pastStage)), AER_SEQ_BREAK)
 
+/* Functions that change state must also refuse parallel listener threads. */
+#define EnsureStageMut(curStage) \
+    Ensure((stage >= (curStage) && stage != STAGE_READ_ONLY), AER_SEQ_BREAK)
+
+#define EnsureStagePastMut(pastStage) \
+    Ensure((stage > (pastStage) && stage != STAGE_READ_ONLY), AER_SEQ_BREAK)
+
+/* ----- INTERNAL TYPES ----- */
+
+typedef struct ErrSite {
+    const char* func;
+    const char* errName;
+    AERErrCode code;
+    /* Aggregates are shared by every site with the same function and error. */
+    struct ErrSiteCache* cache;
+    struct ErrSite* next;
+} ErrSite;
+
+/* ----- INTERNAL GLOBALS ----- */
+
+extern __thread AERErrCode* errLocation;
+
+/* ----- INTERNAL FUNCTIONS ----- */
+
+void ErrUseThreadLocal(void);
+
+void ErrReport(ErrSite* site, void* caller);
+
+void ErrFlushReports(void);
+
+void ErrDestructor(void);
+
 #endif /* INTERNAL_ERR_H */
@@ -16,6 +16,8 @@
 #ifndef INTERNAL_EVENT_H
 #define INTERNAL_EVENT_H
 
+#include <stdbool.h>
+
 #include "aer/event.h"
 #include "aer/instance.h"
 #include "internal/hld.h"
@@ -38,7 +40,11 @@ void EventManRegisterEventListener(HLDObject* obj,
                                    EventKey key,
                                    bool (*listener)(AEREvent*,
                                                     AERInstance*,
-                                                    AERInstance*));
+                                                    AERInstance*),
+                                   int32_t modIdx,
+                                   bool cull);
+
+void EventManRemoveModListeners(int32_t modIdx);
 
 void EventManRecordDrawTargets(void);
 
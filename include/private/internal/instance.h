@@ -17,11 +17,17 @@
 #define INTERNAL_INSTANCE_H
 
 #include <stddef.h>
+#include <stdint.h>
 
 /* ----- INTERNAL FUNCTIONS ----- */
 
 void InstanceManPruneModLocals(void);
 
+void InstanceManRelocateModLocalDestructors(int32_t modIdx,
+                                            void* (*relocate)(void* sym,
+                                                              void* ctx),
+                                            void* ctx);
+
 void InstanceManRecordHLDLocals(void);
 
 void InstanceManConstructor(void);
@@ -16,7 +16,11 @@
 #ifndef INTERNAL_LOG_H
 #define INTERNAL_LOG_H
 
-/* ----- INTERNAL MACROS ----- */
+/* ----- INTERNAL TYPES ----- */
+
+typedef enum LogLevel { LOG_INFO, LOG_WARN, LOG_ERR, LOG_NONE } LogLevel;
+
+/* ----- INTERNAL FUNCTIONS ----- */
 
 void LogInfo(const char* fmt, ...);
 
@@ -24,4 +28,8 @@ void LogWarn(const char* fmt, ...);
 
 void LogErr(const char* fmt, ...);
 
+void LogFlush(void);
+
+void LogDestructor(void);
+
 #endif /* INTERNAL_LOG_H */
@@ -34,6 +34,10 @@
 
 typedef struct Mod {
     void* libHandle;
+    void* libBase;
+    char* libPath;
+    int32_t watchDesc;
+    bool reloadPending;
     int32_t idx;
     const char* name;
     void (*constructor)(void);
@@ -44,6 +48,13 @@ typedef struct Mod {
     void (*registerObjectListeners)(void);
 } Mod;
 
+typedef struct ModListener {
+    void* func;
+    int32_t modIdx;
+    /* Only used by draw listeners; skip them for off-screen instances. */
+    bool cull;
+} ModListener;
+
 /* ----- INTERNAL CONSTANTS ----- */
 
 extern const int32_t MOD_NULL;
@@ -56,6 +67,16 @@ Mod* ModManGetMod(int32_t modIdx);
 
 Mod* ModManGetOwningMod(void* sym);
 
+Mod* ModManGetCallerMod(void* caller);
+
+uint32_t ModManGetGeneration(void);
+
+ModListener* ModManInsertListener(FoxArray* listeners,
+                                  void* func,
+                                  int32_t modIdx);
+
+void ModManRemoveListeners(FoxArray* listeners, int32_t modIdx);
+
 void ModManExecuteGameStepListeners(void);
 
 void ModManExecuteGamePauseListeners(bool paused);
@@ -72,6 +93,8 @@ void ModManLoadMods(void);
 
 void ModManUnloadMods(void);
 
+void ModManReloadChangedMods(void);
+
 void ModManConstructor(void);
 
 void ModManDestructor(void);
@@ -18,6 +18,9 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
+
+#include "internal/log.h"
 
 /* ----- INTERNAL TYPES ----- */
 
@@ -25,6 +28,20 @@ typedef struct Options {
     size_t numModNames;
     const char** modNames;
     bool promoteUnhandledErrors;
+    uint32_t loadThreads;
+    uint32_t jobThreads;
+    bool hotReload;
+    double* modFrameBudgets;
+    uint32_t budgetSkipSteps;
+    uint32_t drawReportSteps;
+    bool assetPrescan;
+    bool lazySpriteReplace;
+    bool prefetchRoomSprites;
+    uint32_t prefetchSpritesPerRoom;
+    LogLevel logLevel;
+    LogLevel* modLogLevels;
+    const char* binLogPath;
+    uint32_t binLogMaxSize;
 } Options;
 
 /* ----- INTERNAL GLOBALS ----- */
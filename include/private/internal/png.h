@@ -0,0 +1,67 @@
+/**
+ * @copyright 2021 the libaermre authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef INTERNAL_PNG_H
+#define INTERNAL_PNG_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * This header is also used by the host-side atlas packer. Only non-interlaced
+ * images with 8 bits per channel (or fewer for grayscale and palette images)
+ * are supported.
+ */
+
+/* ----- INTERNAL MACROS ----- */
+
+/*
+ * Larger images are rejected, which keeps the size of a whole decoded image
+ * (including filter bytes) below 2^32 bytes even on 32-bit hosts.
+ */
+#define PNG_MAX_SIZE 16384
+
+/* ----- INTERNAL TYPES ----- */
+
+typedef struct PNGImage {
+    uint32_t width;
+    uint32_t height;
+    /* Non-premultiplied RGBA, row by row. */
+    uint8_t* pixels;
+} PNGImage;
+
+/*
+ * Called with each row of non-premultiplied RGBA pixels, from top to bottom.
+ * Returning `false` stops decoding.
+ */
+typedef bool (*PNGRowCallback)(void* ctx,
+                               uint32_t width,
+                               uint32_t height,
+                               uint32_t y,
+                               const uint8_t* pixels);
+
+/* ----- INTERNAL FUNCTIONS ----- */
+
+/* Only keeps a few rows in memory, however large the image is. */
+bool PNGDecodeRows(const uint8_t* data,
+                   size_t size,
+                   PNGRowCallback callback,
+                   void* ctx);
+
+bool PNGDecode(const uint8_t* data, size_t size, PNGImage* image);
+
+#endif /* INTERNAL_PNG_H */
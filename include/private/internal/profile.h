@@ -0,0 +1,51 @@
+/**
+ * @copyright 2021 the libaermre authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef INTERNAL_PROFILE_H
+#define INTERNAL_PROFILE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "aer/draw.h"
+
+/* ----- INTERNAL FUNCTIONS ----- */
+
+void ProfileManEnterMod(int32_t modIdx);
+
+void ProfileManLeaveMod(void);
+
+void ProfileManAddModTime(int32_t modIdx, uint64_t elapsedNs);
+
+bool ProfileManShouldSkip(int32_t modIdx);
+
+double ProfileManGetFrameTime(int32_t modIdx);
+
+AERDrawStats* ProfileManGetDrawStats(int32_t modIdx);
+
+const AERDrawStats* ProfileManGetPrevDrawStats(int32_t modIdx);
+
+size_t ProfileManGetDrawHistogram(int32_t modIdx,
+                                  size_t bufSize,
+                                  uint32_t* histBuf);
+
+void ProfileManEndStep(void);
+
+void ProfileManConstructor(void);
+
+void ProfileManDestructor(void);
+
+#endif /* INTERNAL_PROFILE_H */
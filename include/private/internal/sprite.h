@@ -16,8 +16,57 @@
 #ifndef INTERNAL_SPRITE_H
 #define INTERNAL_SPRITE_H
 
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "internal/hld.h"
+
+/* ----- INTERNAL MACROS ----- */
+
+/*
+ * Sprites packed into atlases have no engine sprite of their own, so they are
+ * given indices far past any the engine will hand out.
+ */
+#define SPRITE_PACKED_BASE 0x40000000
+
+/* ----- INTERNAL TYPES ----- */
+
+typedef struct PackedFrame {
+    HLDSprite* page;
+    int32_t pageIdx;
+    int32_t left;
+    int32_t top;
+} PackedFrame;
+
+typedef struct PackedSprite {
+    char* name;
+    uint32_t numFrames;
+    HLDVecIntegral size;
+    HLDVecIntegral origin;
+    PackedFrame* frames;
+} PackedSprite;
+
 /* ----- INTERNAL FUNCTIONS ----- */
 
+PackedSprite* SpriteManLookupPacked(int32_t spriteIdx);
+
+bool SpriteManLoadPending(int32_t spriteIdx);
+
+void SpriteManLoadRoomPending(void);
+
+void SpriteManPrefetchPending(void);
+
+void SpriteManBuildMasks(void);
+
+bool SpriteManMasksOverlap(int32_t spriteIdxA,
+                           float frameA,
+                           float xA,
+                           float yA,
+                           int32_t spriteIdxB,
+                           float frameB,
+                           float xB,
+                           float yB);
+
 void SpriteManBuildNameTable(void);
 
 void SpriteManConstructor(void);
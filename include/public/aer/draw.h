@@ -37,8 +37,380 @@
 #define AER_DRAW_H
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
+/* ----- PUBLIC TYPES ----- */
+
+/**
+ * @brief Axis-aligned rectangle for batched drawing.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERDrawRectangles
+ */
+typedef struct AERDrawRect {
+    /**
+     * @var left
+     *
+     * @brief Position of left side.
+     *
+     * @since 1.6.0
+     *
+     * @memberof AERDrawRect
+     */
+    float left;
+    /**
+     * @var top
+     *
+     * @brief Position of top side.
+     *
+     * @since 1.6.0
+     *
+     * @memberof AERDrawRect
+     */
+    float top;
+    /**
+     * @var right
+     *
+     * @brief Position of right side.
+     *
+     * @since 1.6.0
+     *
+     * @memberof AERDrawRect
+     */
+    float right;
+    /**
+     * @var bottom
+     *
+     * @brief Position of bottom side.
+     *
+     * @since 1.6.0
+     *
+     * @memberof AERDrawRect
+     */
+    float bottom;
+} AERDrawRect;
+
+/**
+ * @brief Line segment for batched drawing.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERDrawLines
+ */
+typedef struct AERDrawSegment {
+    /**
+     * @var x1
+     *
+     * @brief Horizontal position of first endpoint.
+     *
+     * @since 1.6.0
+     *
+     * @memberof AERDrawSegment
+     */
+    float x1;
+    /**
+     * @var y1
+     *
+     * @brief Vertical position of first endpoint.
+     *
+     * @since 1.6.0
+     *
+     * @memberof AERDrawSegment
+     */
+    float y1;
+    /**
+     * @var x2
+     *
+     * @brief Horizontal position of second endpoint.
+     *
+     * @since 1.6.0
+     *
+     * @memberof AERDrawSegment
+     */
+    float x2;
+    /**
+     * @var y2
+     *
+     * @brief Vertical position of second endpoint.
+     *
+     * @since 1.6.0
+     *
+     * @memberof AERDrawSegment
+     */
+    float y2;
+} AERDrawSegment;
+
+/**
+ * @brief Triangle for batched drawing.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERDrawTriangles
+ */
+typedef struct AERDrawTri {
+    /**
+     * @var x1
+     *
+     * @brief Horizontal position of first vertex.
+     *
+     * @since 1.6.0
+     *
+     * @memberof AERDrawTri
+     */
+    float x1;
+    /**
+     * @var y1
+     *
+     * @brief Vertical position of first vertex.
+     *
+     * @since 1.6.0
+     *
+     * @memberof AERDrawTri
+     */
+    float y1;
+    /**
+     * @var x2
+     *
+     * @brief Horizontal position of second vertex.
+     *
+     * @since 1.6.0
+     *
+     * @memberof AERDrawTri
+     */
+    float x2;
+    /**
+     * @var y2
+     *
+     * @brief Vertical position of second vertex.
+     *
+     * @since 1.6.0
+     *
+     * @memberof AERDrawTri
+     */
+    float y2;
+    /**
+     * @var x3
+     *
+     * @brief Horizontal position of third vertex.
+     *
+     * @since 1.6.0
+     *
+     * @memberof AERDrawTri
+     */
+    float x3;
+    /**
+     * @var y3
+     *
+     * @brief Vertical position of third vertex.
+     *
+     * @since 1.6.0
+     *
+     * @memberof AERDrawTri
+     */
+    float y3;
+} AERDrawTri;
+
+/**
+ * @brief Opaque type for text that is drawn repeatedly.
+ *
+ * Drawing a string with AERDrawText copies it first, so that the engine only
+ * ever sees text owned by the MRE. A text handle makes that copy once, when it
+ * is created, and can then be drawn any number of times without copying.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERTextHandleNew
+ * @sa AERDrawTextHandle
+ */
+typedef void AERTextHandle;
+
+/**
+ * @brief Opaque type for a list of deferred draw commands.
+ *
+ * Draw commands recorded into a list are not drawn until the list is flushed
+ * using AERDrawListFlush. Flushing draws the commands in ascending order of
+ * layer. Within a layer, commands are grouped so that those drawing from the
+ * same sprite or font with the same alpha are drawn together, which lets the
+ * engine batch their vertices. Apart from that grouping, commands are drawn in
+ * the order they were recorded.
+ *
+ * @warning Commands in the same layer may be drawn in a different order than
+ * they were recorded. Put commands that must overlap in a fixed order in
+ * different layers.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERDrawListNew
+ */
+typedef void AERDrawList;
+
+/**
+ * @brief Statistics about the most recent flush of a draw list.
+ *
+ * A state change is counted between two consecutive commands which draw from
+ * a different sprite, font or alpha, or where only one draws from a texture.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERDrawListGetStats
+ */
+typedef struct AERDrawListStats {
+    /**
+     * @var numCmds
+     *
+     * @brief Number of commands drawn.
+     *
+     * @since 1.6.0
+     *
+     * @memberof AERDrawListStats
+     */
+    size_t numCmds;
+    /**
+     * @var numChangesRecorded
+     *
+     * @brief Number of state changes if the commands had been drawn in the
+     * order they were recorded.
+     *
+     * @since 1.6.0
+     *
+     * @memberof AERDrawListStats
+     */
+    size_t numChangesRecorded;
+    /**
+     * @var numChangesFlushed
+     *
+     * @brief Number of state changes when the commands were actually drawn.
+     *
+     * @since 1.6.0
+     *
+     * @memberof AERDrawListStats
+     */
+    size_t numChangesFlushed;
+} AERDrawListStats;
+
+/**
+ * @brief Statistics about the draw calls made by a mod during one step.
+ *
+ * Each sprite, text or primitive drawn counts as one draw call, including
+ * each element drawn by a batched draw function and each command drawn by
+ * AERDrawListFlush. Draw calls made from a draw list are counted against the
+ * mod which flushed it.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERDrawGetStats
+ */
+typedef struct AERDrawStats {
+    /**
+     * @var numCalls
+     *
+     * @brief Total number of draw calls.
+     *
+     * @since 1.6.0
+     *
+     * @memberof AERDrawStats
+     */
+    uint32_t numCalls;
+    /**
+     * @var numSprites
+     *
+     * @brief Number of sprites drawn.
+     *
+     * @since 1.6.0
+     *
+     * @memberof AERDrawStats
+     */
+    uint32_t numSprites;
+    /**
+     * @var numTexts
+     *
+     * @brief Number of texts drawn.
+     *
+     * @since 1.6.0
+     *
+     * @memberof AERDrawStats
+     */
+    uint32_t numTexts;
+    /**
+     * @var numLines
+     *
+     * @brief Number of lines drawn.
+     *
+     * @since 1.6.0
+     *
+     * @memberof AERDrawStats
+     */
+    uint32_t numLines;
+    /**
+     * @var numEllipses
+     *
+     * @brief Number of ellipses drawn.
+     *
+     * @since 1.6.0
+     *
+     * @memberof AERDrawStats
+     */
+    uint32_t numEllipses;
+    /**
+     * @var numTriangles
+     *
+     * @brief Number of triangles drawn.
+     *
+     * @since 1.6.0
+     *
+     * @memberof AERDrawStats
+     */
+    uint32_t numTriangles;
+    /**
+     * @var numRectangles
+     *
+     * @brief Number of rectangles drawn.
+     *
+     * @since 1.6.0
+     *
+     * @memberof AERDrawStats
+     */
+    uint32_t numRectangles;
+    /**
+     * @var numTextureSwitches
+     *
+     * @brief Number of sprite and text draws which used a different texture
+     * than the mod draw before them.
+     *
+     * Each sprite (or page of a sprite atlas) and font counts as a texture.
+     * Drawing many sprites packed into the same atlas page back to back (see
+     * ::AERSpriteRegisterAtlas) is what keeps this low.
+     *
+     * @since 1.6.0
+     *
+     * @memberof AERDrawStats
+     */
+    uint32_t numTextureSwitches;
+    /**
+     * @var numSpritePixels
+     *
+     * @brief Number of pixels covered by sprites after scaling. A pixel
+     * covered by several sprites is counted once for each of them.
+     *
+     * @since 1.6.0
+     *
+     * @memberof AERDrawStats
+     */
+    uint64_t numSpritePixels;
+    /**
+     * @var numTextChars
+     *
+     * @brief Number of bytes of text drawn.
+     *
+     * @since 1.6.0
+     *
+     * @memberof AERDrawStats
+     */
+    uint64_t numTextChars;
+} AERDrawStats;
+
 /* ----- PUBLIC FUNCTIONS ----- */
 
 /**
@@ -154,6 +526,41 @@ void AERDrawSpriteAdv(int32_t spriteIdx,
                       uint32_t blendSW,
                       float alpha);
 
+/**
+ * @brief Draw many copies of a sprite to the screen.
+ *
+ * The stage is checked once for the whole batch, after which the engine is
+ * called in a tight loop.
+ *
+ * @param[in] numSprites Number of copies to draw.
+ * @param[in] spriteIdx Sprite to draw.
+ * @param[in] frames Frame of sprite to draw for each copy.
+ * @param[in] xs Horizontal position at which to draw each copy.
+ * @param[in] ys Vertical position at which to draw each copy.
+ * @param[in] scales Horizontal and vertical scale of each copy or `NULL` to
+ * draw every copy at a scale of `1.0f`.
+ * @param[in] blends Color to blend with each copy or `NULL` to blend every
+ * copy with white (`0xffffff`). See @ref DrawColors for more infomation.
+ *
+ * @throw ::AER_SEQ_BREAK if called outside draw stage.
+ * @throw ::AER_NULL_ARG if argument `frames`, `xs` or `ys` is `NULL` and
+ * argument `numSprites` is greater than `0`.
+ * @throw ::AER_FAILED_LOOKUP if argument `spriteIdx` is an invalid sprite.
+ * @throw ::AER_BAD_VAL if any frame is greater than or equal to the number of
+ * frames in sprite. In this case nothing is drawn.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERDrawSprite
+ */
+void AERDrawSprites(size_t numSprites,
+                    int32_t spriteIdx,
+                    const uint32_t* frames,
+                    const float* xs,
+                    const float* ys,
+                    const float* scales,
+                    const uint32_t* blends);
+
 /**
  * @brief Draw a line to the screen.
  *
@@ -202,6 +609,31 @@ void AERDrawLineAdv(float x1,
                     uint32_t color1,
                     uint32_t color2);
 
+/**
+ * @brief Draw many lines to the screen.
+ *
+ * The stage is checked once for the whole batch, after which the engine is
+ * called in a tight loop.
+ *
+ * @param[in] numLines Number of lines to draw.
+ * @param[in] segments Endpoints of each line.
+ * @param[in] width Width of every line in pixels.
+ * @param[in] colors Color of each line. See @ref DrawColors for more
+ * infomation.
+ *
+ * @throw ::AER_SEQ_BREAK if called outside draw stage.
+ * @throw ::AER_NULL_ARG if argument `segments` or `colors` is `NULL` and
+ * argument `numLines` is greater than `0`.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERDrawLineAdv
+ */
+void AERDrawLines(size_t numLines,
+                  const AERDrawSegment* segments,
+                  float width,
+                  const uint32_t* colors);
+
 /**
  * @brief Draw an ellipse to the screen.
  *
@@ -325,6 +757,32 @@ void AERDrawTriangleAdv(float x1,
                         uint32_t color3,
                         bool outline);
 
+/**
+ * @brief Draw many triangles to the screen.
+ *
+ * The stage is checked once for the whole batch, after which the engine is
+ * called in a tight loop.
+ *
+ * @param[in] numTris Number of triangles to draw.
+ * @param[in] tris Vertices of each triangle.
+ * @param[in] colors Color of each triangle. See @ref DrawColors for more
+ * infomation.
+ * @param[in] outline Whether to render solid triangles (`false`) or `1` pixel
+ * wide outlines of triangles (`true`).
+ *
+ * @throw ::AER_SEQ_BREAK if called outside draw stage.
+ * @throw ::AER_NULL_ARG if argument `tris` or `colors` is `NULL` and argument
+ * `numTris` is greater than `0`.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERDrawTriangle
+ */
+void AERDrawTriangles(size_t numTris,
+                      const AERDrawTri* tris,
+                      const uint32_t* colors,
+                      bool outline);
+
 /**
  * @brief Draw a rectangle to the screen.
  *
@@ -387,13 +845,38 @@ void AERDrawRectangleAdv(float left,
                          uint32_t colorSW,
                          bool outline);
 
+/**
+ * @brief Draw many rectangles to the screen.
+ *
+ * The stage is checked once for the whole batch, after which the engine is
+ * called in a tight loop.
+ *
+ * @param[in] numRects Number of rectangles to draw.
+ * @param[in] rects Sides of each rectangle.
+ * @param[in] colors Color of each rectangle. See @ref DrawColors for more
+ * infomation.
+ * @param[in] outline Whether to render solid rectangles (`false`) or `1`
+ * pixel wide outlines of rectangles (`true`).
+ *
+ * @throw ::AER_SEQ_BREAK if called outside draw stage.
+ * @throw ::AER_NULL_ARG if argument `rects` or `colors` is `NULL` and argument
+ * `numRects` is greater than `0`.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERDrawRectangle
+ */
+void AERDrawRectangles(size_t numRects,
+                       const AERDrawRect* rects,
+                       const uint32_t* colors,
+                       bool outline);
+
 /**
  * @brief Draw text to the screen.
  *
  * See @ref DrawTextEscape for more information about text escape sequences.
  *
- * @param[in] text String to draw. Maximum size is 8192 characters including
- * null terminator (will not cause error if larger).
+ * @param[in] text String to draw.
  * @param[in] x Horizontal position at which to draw text.
  * @param[in] y Vertical position at which to draw text.
  * @param[in] width Maximum line width before line break in pixels (not
@@ -427,8 +910,7 @@ void AERDrawText(const char* text,
  * The game maker engine chose to use the hashtag ('#') character to represent
  * linebreaks. To display a literal hashtag, preceed it with a backslash.
  *
- * @param[in] text String to draw. Maximum size is 8192 characters including
- * null terminator (will not cause error if larger).
+ * @param[in] text String to draw.
  * @param[in] x Horizontal position at which to draw text.
  * @param[in] y Vertical position at which to draw text.
  * @param[in] height Space between each line of text in pixels.
@@ -470,4 +952,427 @@ void AERDrawTextAdv(const char* text,
                     uint32_t colorSW,
                     float alpha);
 
+/**
+ * @brief Allocate a text handle holding a copy of a string.
+ *
+ * When no longer needed, free this handle using AERTextHandleFree.
+ *
+ * @note Unlike the drawing functions, this may be called at any stage.
+ *
+ * @param[in] text String to copy. See @ref DrawTextEscape for more
+ * information about text escape sequences.
+ *
+ * @return New text handle or `NULL` if unsuccessful.
+ *
+ * @throw ::AER_NULL_ARG if argument `text` is `NULL`.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERTextHandleFree
+ */
+AERTextHandle* AERTextHandleNew(const char* text);
+
+/**
+ * @brief Free a text handle.
+ *
+ * @param[in] handle Text handle of interest.
+ *
+ * @throw ::AER_NULL_ARG if argument `handle` is `NULL`.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERTextHandleNew
+ */
+void AERTextHandleFree(AERTextHandle* handle);
+
+/**
+ * @brief Query the string held by a text handle.
+ *
+ * @param[in] handle Text handle of interest.
+ *
+ * @return String held by handle or `NULL` if unsuccessful. It remains valid
+ * until the handle is freed.
+ *
+ * @throw ::AER_NULL_ARG if argument `handle` is `NULL`.
+ *
+ * @since 1.6.0
+ */
+const char* AERTextHandleGetText(const AERTextHandle* handle);
+
+/**
+ * @brief Draw the text of a text handle to the screen.
+ *
+ * Equivalent to AERDrawText, but without copying the text.
+ *
+ * @param[in] handle Text handle of interest.
+ * @param[in] x Horizontal position at which to draw text.
+ * @param[in] y Vertical position at which to draw text.
+ * @param[in] width Maximum line width before line break in pixels (not
+ * characters).
+ * @param[in] scale Horizontal and vertical scale of text.
+ * @param[in] color Color of text. See @ref DrawColors for more
+ * infomation.
+ *
+ * @throw ::AER_SEQ_BREAK if called outside draw stage.
+ * @throw ::AER_NULL_ARG if argument `handle` is `NULL`.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERDrawTextHandleAdv
+ */
+void AERDrawTextHandle(const AERTextHandle* handle,
+                       float x,
+                       float y,
+                       uint32_t width,
+                       float scale,
+                       uint32_t color);
+
+/**
+ * @brief Draw the text of a text handle to the screen.
+ *
+ * Equivalent to AERDrawTextAdv, but without copying the text.
+ *
+ * @param[in] handle Text handle of interest.
+ * @param[in] x Horizontal position at which to draw text.
+ * @param[in] y Vertical position at which to draw text.
+ * @param[in] height Space between each line of text in pixels.
+ * @param[in] width Maximum line width before line break in pixels (not
+ * characters).
+ * @param[in] scaleX Horizontal scale of text.
+ * @param[in] scaleY Vertical scale of text.
+ * @param[in] angle Text offset angle in degrees.
+ * @param[in] colorNW Color of northwest corner. See @ref DrawColors for more
+ * infomation.
+ * @param[in] colorNE Color of northeast corner. See @ref DrawColors for more
+ * infomation.
+ * @param[in] colorSE Color of southeast corner. See @ref DrawColors for more
+ * infomation.
+ * @param[in] colorSW Color of southwest corner. See @ref DrawColors for more
+ * infomation.
+ * @param[in] alpha Text alpha (transparency).
+ *
+ * @throw ::AER_SEQ_BREAK if called outside draw stage.
+ * @throw ::AER_NULL_ARG if argument `handle` is `NULL`.
+ * @throw ::AER_BAD_VAL if argument `alpha` is less than `0.0f` or greater
+ * than `1.0f`.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERDrawTextHandle
+ */
+void AERDrawTextHandleAdv(const AERTextHandle* handle,
+                          float x,
+                          float y,
+                          int32_t height,
+                          uint32_t width,
+                          float scaleX,
+                          float scaleY,
+                          float angle,
+                          uint32_t colorNW,
+                          uint32_t colorNE,
+                          uint32_t colorSE,
+                          uint32_t colorSW,
+                          float alpha);
+
+/**
+ * @brief Allocate a new, empty draw list.
+ *
+ * When no longer needed, free this list using AERDrawListFree.
+ *
+ * @return New draw list.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERDrawListFree
+ */
+AERDrawList* AERDrawListNew(void);
+
+/**
+ * @brief Free a draw list, discarding any commands not yet flushed.
+ *
+ * @param[in] list Draw list of interest.
+ *
+ * @throw ::AER_NULL_ARG if argument `list` is `NULL`.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERDrawListNew
+ */
+void AERDrawListFree(AERDrawList* list);
+
+/**
+ * @brief Record drawing a sprite into a draw list.
+ *
+ * The current draw alpha is recorded with the command.
+ *
+ * @param[in] list Draw list of interest.
+ * @param[in] layer Layer to draw in. Lower layers are drawn first.
+ * @param[in] spriteIdx Sprite to draw.
+ * @param[in] frame Frame of sprite to draw.
+ * @param[in] x Horizontal position at which to draw sprite.
+ * @param[in] y Vertical position at which to draw sprite.
+ * @param[in] scale Horizontal and vertical scale of sprite.
+ * @param[in] blend Color to blend with sprite. See @ref DrawColors for more
+ * infomation.
+ *
+ * @throw ::AER_SEQ_BREAK if called outside draw stage.
+ * @throw ::AER_NULL_ARG if argument `list` is `NULL`.
+ * @throw ::AER_FAILED_LOOKUP if argument `spriteIdx` is an invalid sprite.
+ * @throw ::AER_BAD_VAL if argument `frame` is greater than or equal to the
+ * number of frames in sprite.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERDrawListFlush
+ */
+void AERDrawListAddSprite(AERDrawList* list,
+                          int32_t layer,
+                          int32_t spriteIdx,
+                          uint32_t frame,
+                          float x,
+                          float y,
+                          float scale,
+                          uint32_t blend);
+
+/**
+ * @brief Record drawing the text of a text handle into a draw list.
+ *
+ * The current font and draw alpha are recorded with the command.
+ *
+ * @param[in] list Draw list of interest.
+ * @param[in] layer Layer to draw in. Lower layers are drawn first.
+ * @param[in] handle Text handle of interest. It must not be freed until the
+ * list has been flushed.
+ * @param[in] x Horizontal position at which to draw text.
+ * @param[in] y Vertical position at which to draw text.
+ * @param[in] width Maximum line width before line break in pixels (not
+ * characters).
+ * @param[in] scale Horizontal and vertical scale of text.
+ * @param[in] color Color of text. See @ref DrawColors for more
+ * infomation.
+ *
+ * @throw ::AER_SEQ_BREAK if called outside draw stage.
+ * @throw ::AER_NULL_ARG if argument `list` or `handle` is `NULL`.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERDrawListFlush
+ */
+void AERDrawListAddText(AERDrawList* list,
+                        int32_t layer,
+                        const AERTextHandle* handle,
+                        float x,
+                        float y,
+                        uint32_t width,
+                        float scale,
+                        uint32_t color);
+
+/**
+ * @brief Record drawing a rectangle into a draw list.
+ *
+ * The current draw alpha is recorded with the command.
+ *
+ * @param[in] list Draw list of interest.
+ * @param[in] layer Layer to draw in. Lower layers are drawn first.
+ * @param[in] left Position of left side of rectangle.
+ * @param[in] top Position of top side of rectangle.
+ * @param[in] right Position of right side of rectangle.
+ * @param[in] bottom Position of bottom side of rectangle.
+ * @param[in] color Color of rectangle. See @ref DrawColors for more
+ * infomation.
+ * @param[in] outline Whether to render a solid rectangle (`false`) or a `1`
+ * pixel wide outline of a rectangle (`true`).
+ *
+ * @throw ::AER_SEQ_BREAK if called outside draw stage.
+ * @throw ::AER_NULL_ARG if argument `list` is `NULL`.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERDrawListFlush
+ */
+void AERDrawListAddRectangle(AERDrawList* list,
+                             int32_t layer,
+                             float left,
+                             float top,
+                             float right,
+                             float bottom,
+                             uint32_t color,
+                             bool outline);
+
+/**
+ * @brief Record drawing a line into a draw list.
+ *
+ * The current draw alpha is recorded with the command.
+ *
+ * @param[in] list Draw list of interest.
+ * @param[in] layer Layer to draw in. Lower layers are drawn first.
+ * @param[in] x1 Horizontal position of first endpoint.
+ * @param[in] y1 Vertical position of first endpoint.
+ * @param[in] x2 Horizontal position of second endpoint.
+ * @param[in] y2 Vertical position of second endpoint.
+ * @param[in] width Width of line in pixels.
+ * @param[in] color Color of line. See @ref DrawColors for more infomation.
+ *
+ * @throw ::AER_SEQ_BREAK if called outside draw stage.
+ * @throw ::AER_NULL_ARG if argument `list` is `NULL`.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERDrawListFlush
+ */
+void AERDrawListAddLine(AERDrawList* list,
+                        int32_t layer,
+                        float x1,
+                        float y1,
+                        float x2,
+                        float y2,
+                        float width,
+                        uint32_t color);
+
+/**
+ * @brief Record drawing a triangle into a draw list.
+ *
+ * The current draw alpha is recorded with the command.
+ *
+ * @param[in] list Draw list of interest.
+ * @param[in] layer Layer to draw in. Lower layers are drawn first.
+ * @param[in] x1 Horizontal position of first vertex.
+ * @param[in] y1 Vertical position of first vertex.
+ * @param[in] x2 Horizontal position of second vertex.
+ * @param[in] y2 Vertical position of second vertex.
+ * @param[in] x3 Horizontal position of third vertex.
+ * @param[in] y3 Vertical position of third vertex.
+ * @param[in] color Color of triangle. See @ref DrawColors for more
+ * infomation.
+ * @param[in] outline Whether to render a solid triangle (`false`) or a `1`
+ * pixel wide outline of a triangle (`true`).
+ *
+ * @throw ::AER_SEQ_BREAK if called outside draw stage.
+ * @throw ::AER_NULL_ARG if argument `list` is `NULL`.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERDrawListFlush
+ */
+void AERDrawListAddTriangle(AERDrawList* list,
+                            int32_t layer,
+                            float x1,
+                            float y1,
+                            float x2,
+                            float y2,
+                            float x3,
+                            float y3,
+                            uint32_t color,
+                            bool outline);
+
+/**
+ * @brief Draw and then remove every command recorded into a draw list.
+ *
+ * The draw alpha and font are restored to their values from before the flush
+ * once it is done.
+ *
+ * @param[in] list Draw list of interest.
+ *
+ * @throw ::AER_SEQ_BREAK if called outside draw stage.
+ * @throw ::AER_NULL_ARG if argument `list` is `NULL`.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERDrawListGetStats
+ */
+void AERDrawListFlush(AERDrawList* list);
+
+/**
+ * @brief Query statistics about the most recent flush of a draw list.
+ *
+ * @param[in] list Draw list of interest.
+ * @param[out] stats Statistics about the most recent flush, or all zeroes if
+ * the list has never been flushed.
+ *
+ * @throw ::AER_NULL_ARG if argument `list` or `stats` is `NULL`.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERDrawListFlush
+ */
+void AERDrawListGetStats(const AERDrawList* list, AERDrawListStats* stats);
+
+/**
+ * @brief Query whether a rectangle in the current room is visible.
+ *
+ * A rectangle is visible if it overlaps any visible view of the current room,
+ * or if the room has no visible views. Rotated views are treated as their
+ * axis-aligned bounding box.
+ *
+ * This can be used to skip drawing effects which would end up off-screen.
+ *
+ * @param[in] left Position of left side relative to the room's origin.
+ * @param[in] top Position of top side relative to the room's origin.
+ * @param[in] right Position of right side relative to the room's origin.
+ * @param[in] bottom Position of bottom side relative to the room's origin.
+ *
+ * @return Whether rectangle is visible or `false` if unsuccessful.
+ *
+ * @throw ::AER_SEQ_BREAK if called outside action stage.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERInstanceIsOnScreen
+ */
+bool AERDrawIsRectVisible(float left, float top, float right, float bottom);
+
+/**
+ * @brief Query statistics about the draw calls a mod made during the
+ * previous step.
+ *
+ * @param[in] modIdx Mod of interest.
+ * @param[out] stats Statistics about the previous step.
+ *
+ * @throw ::AER_SEQ_BREAK if called outside action stage.
+ * @throw ::AER_FAILED_LOOKUP if argument `modIdx` is an invalid mod.
+ * @throw ::AER_NULL_ARG if argument `stats` is `NULL`.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERDrawGetCallHistogram
+ * @sa AERModGetFrameTime
+ */
+void AERDrawGetStats(int32_t modIdx, AERDrawStats* stats);
+
+/**
+ * @brief Query a histogram of the number of draw calls a mod made per step
+ * over the last `256` steps.
+ *
+ * Element `0` of the histogram is the number of steps in which the mod made
+ * no draw calls. Element `N > 0` is the number of steps in which it made
+ * between `2^(N-1)` and `2^N - 1` draw calls, except for the last element
+ * which has no upper bound.
+ *
+ * @warning Argument `histBuf` must be large enough to hold at least
+ * `bufSize` elements.
+ *
+ * @note Argument `bufSize` may be `0` in which case argument `histBuf` may
+ * be `NULL`. This may be used to efficiently query the number of elements in
+ * the histogram.
+ *
+ * @param[in] modIdx Mod of interest.
+ * @param[in] bufSize Maximum number of elements to write to argument
+ * `histBuf`.
+ * @param[out] histBuf Buffer to write histogram to.
+ *
+ * @return Total number of elements in histogram or `0` if unsuccessful.
+ *
+ * @throw ::AER_SEQ_BREAK if called outside action stage.
+ * @throw ::AER_FAILED_LOOKUP if argument `modIdx` is an invalid mod.
+ * @throw ::AER_NULL_ARG if argument `histBuf` is `NULL` and argument
+ * `bufSize` is greater than `0`.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERDrawGetStats
+ */
+size_t AERDrawGetCallHistogram(int32_t modIdx,
+                               size_t bufSize,
+                               uint32_t* histBuf);
+
 #endif /* AER_DRAW_H */
\ No newline at end of file
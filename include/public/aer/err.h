@@ -22,6 +22,9 @@
 #ifndef AER_ERR_H
 #define AER_ERR_H
 
+#include <stddef.h>
+#include <stdint.h>
+
 /* ----- PUBLIC TYPES ----- */
 
 #define AER_OUT_OF_MEM AER_OUT_OF_MEM __attribute__((deprecated))
@@ -98,16 +101,122 @@ typedef enum AERErrCode {
 } AERErrCode;
 #undef AER_OUT_OF_MEM
 
+/**
+ * @brief Aggregated occurrences of a potentially unhandled error.
+ *
+ * Potentially unhandled errors (those reported without ::aererr first being
+ * set to ::AER_TRY) are aggregated by the function that reported them, the
+ * error and the mod that called the function.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERErrGetReports
+ */
+typedef struct AERErrReport {
+    /**
+     * @var function
+     *
+     * @brief Name of the MRE function that reported the error.
+     *
+     * @since 1.6.0
+     *
+     * @memberof AERErrReport
+     */
+    const char* function;
+    /**
+     * @var code
+     *
+     * @brief Error that was reported.
+     *
+     * @since 1.6.0
+     *
+     * @memberof AERErrReport
+     */
+    AERErrCode code;
+    /**
+     * @var modIdx
+     *
+     * @brief Mod that called the function or `-1` if the call was internal to
+     * the MRE.
+     *
+     * @since 1.6.0
+     *
+     * @memberof AERErrReport
+     */
+    int32_t modIdx;
+    /**
+     * @var count
+     *
+     * @brief Number of times the error occurred.
+     *
+     * @since 1.6.0
+     *
+     * @memberof AERErrReport
+     */
+    uint32_t count;
+} AERErrReport;
+
 /* ----- PUBLIC GLOBALS ----- */
 
 /**
- * @brief Error state of most recently called MRE function.
+ * @brief Error state of most recently called MRE function on the main
+ * thread.
  *
  * @note Always reset this global to ::AER_TRY before calling the
  * function to be error-checked.
  *
+ * @note Since 1.6.0 this symbol is shadowed by a macro of the same name which
+ * refers to the error state of the calling thread. The symbol remains for
+ * compatibility with mods built against earlier versions.
+ *
  * @since 1.0.0
+ *
+ * @sa AERErrLocation
  */
 extern AERErrCode aererr;
 
+/* ----- PUBLIC FUNCTIONS ----- */
+
+/**
+ * @brief Query the location of the calling thread's error state.
+ *
+ * On the main thread this is the address of the global ::aererr. Worker
+ * threads each have their own error state.
+ *
+ * @note Prefer using ::aererr, which expands to a call to this function.
+ *
+ * @return Location of error state.
+ *
+ * @since 1.6.0
+ */
+AERErrCode* AERErrLocation(void);
+
+#define aererr (*AERErrLocation())
+
+/**
+ * @brief Query aggregated occurrences of potentially unhandled errors.
+ *
+ * Only the first occurrence of each potentially unhandled error is logged
+ * right away. Later occurrences are counted and logged periodically.
+ *
+ * @warning Argument `reportBuf` must be large enough to hold at least
+ * `bufSize` elements.
+ *
+ * @note Argument `bufSize` may be `0` in which case argument `reportBuf` may
+ * be `NULL`. This may be used to efficiently query the total number of
+ * reports.
+ *
+ * @param[in] bufSize Maximum number of elements to write to argument
+ * `reportBuf`.
+ * @param[out] reportBuf Buffer to write reports to.
+ *
+ * @return Total number of reports or `0` if unsuccessful.
+ *
+ * @throw ::AER_NULL_ARG if argument `reportBuf` is `NULL` and argument
+ * `bufSize` is greater than `0`.
+ *
+ * @since 1.6.0
+ */
+size_t AERErrGetReports(size_t bufSize, AERErrReport* reportBuf);
+
 #endif /* AER_ERR_H */
@@ -0,0 +1,489 @@
+/**
+ * @file
+ *
+ * @brief Unchecked, inlinable accessors for hot instance fields.
+ *
+ * Each accessor here mirrors a function in instance.h, but compiles down to a
+ * single load or store. Field offsets are read from a table exported by the
+ * MRE, so mods using this header keep working if the game's instance layout
+ * changes between MRE releases.
+ *
+ * @warning These accessors perform no stage or argument checks and never
+ * set ::aererr. Only call them from the main thread during the action stage
+ * and with valid instances. Getters may also be called from read-only game
+ * step listeners, but never from jobs.
+ *
+ * @note The MRE refuses to load a mod built against a newer version of this
+ * header than the MRE itself provides.
+ *
+ * @since 1.6.0
+ *
+ * @copyright 2021 the libaermre authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef AER_FAST_H
+#define AER_FAST_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "aer/instance.h"
+
+/* ----- PUBLIC MACROS ----- */
+
+/**
+ * @brief Version of ::AERFastLayout this header was written against.
+ *
+ * @since 1.6.0
+ */
+#define AER_FAST_LAYOUT_VERSION 1
+
+/* ----- PUBLIC TYPES ----- */
+
+/**
+ * @brief Byte offsets of hot fields within an instance.
+ *
+ * @note New fields are only ever appended, alongside an increase of
+ * ::AER_FAST_LAYOUT_VERSION.
+ *
+ * @since 1.6.0
+ */
+typedef struct AERFastLayout {
+    /**
+     * @var version
+     *
+     * @brief Layout version provided by the MRE.
+     *
+     * @since 1.6.0
+     *
+     * @memberof AERFastLayout
+     */
+    uint32_t version;
+    /**
+     * @var depth
+     *
+     * @brief Offset of field read by ::AERInstanceGetDepth.
+     *
+     * @since 1.6.0
+     *
+     * @memberof AERFastLayout
+     */
+    uint32_t depth;
+    /**
+     * @var id
+     *
+     * @brief Offset of field read by ::AERInstanceGetId.
+     *
+     * @since 1.6.0
+     *
+     * @memberof AERFastLayout
+     */
+    uint32_t id;
+    /**
+     * @var objectIndex
+     *
+     * @brief Offset of field read by ::AERInstanceGetObject.
+     *
+     * @since 1.6.0
+     *
+     * @memberof AERFastLayout
+     */
+    uint32_t objectIndex;
+    /**
+     * @var visible
+     *
+     * @brief Offset of field read by ::AERInstanceGetVisible.
+     *
+     * @since 1.6.0
+     *
+     * @memberof AERFastLayout
+     */
+    uint32_t visible;
+    /**
+     * @var spriteIndex
+     *
+     * @brief Offset of field read by ::AERInstanceGetSprite.
+     *
+     * @since 1.6.0
+     *
+     * @memberof AERFastLayout
+     */
+    uint32_t spriteIndex;
+    /**
+     * @var imageIndex
+     *
+     * @brief Offset of field read by ::AERInstanceGetSpriteFrame.
+     *
+     * @since 1.6.0
+     *
+     * @memberof AERFastLayout
+     */
+    uint32_t imageIndex;
+    /**
+     * @var imageSpeed
+     *
+     * @brief Offset of field read by ::AERInstanceGetSpriteSpeed.
+     *
+     * @since 1.6.0
+     *
+     * @memberof AERFastLayout
+     */
+    uint32_t imageSpeed;
+    /**
+     * @var imageAlpha
+     *
+     * @brief Offset of field read by ::AERInstanceGetSpriteAlpha.
+     *
+     * @since 1.6.0
+     *
+     * @memberof AERFastLayout
+     */
+    uint32_t imageAlpha;
+    /**
+     * @var imageAngle
+     *
+     * @brief Offset of field read by ::AERInstanceGetSpriteAngle.
+     *
+     * @since 1.6.0
+     *
+     * @memberof AERFastLayout
+     */
+    uint32_t imageAngle;
+    /**
+     * @var imageBlend
+     *
+     * @brief Offset of field read by ::AERInstanceGetSpriteBlend.
+     *
+     * @since 1.6.0
+     *
+     * @memberof AERFastLayout
+     */
+    uint32_t imageBlend;
+    /**
+     * @var maskIndex
+     *
+     * @brief Offset of field read by ::AERInstanceGetMask.
+     *
+     * @since 1.6.0
+     *
+     * @memberof AERFastLayout
+     */
+    uint32_t maskIndex;
+    /**
+     * @var friction
+     *
+     * @brief Offset of field read by ::AERInstanceGetFriction.
+     *
+     * @since 1.6.0
+     *
+     * @memberof AERFastLayout
+     */
+    uint32_t friction;
+    /**
+     * @var imageScale
+     *
+     * @brief Offset of fields read by ::AERInstanceGetSpriteScale.
+     *
+     * @since 1.6.0
+     *
+     * @memberof AERFastLayout
+     */
+    uint32_t imageScale;
+    /**
+     * @var pos
+     *
+     * @brief Offset of fields read by ::AERInstanceGetPosition.
+     *
+     * @since 1.6.0
+     *
+     * @memberof AERFastLayout
+     */
+    uint32_t pos;
+    /**
+     * @var speedX
+     *
+     * @brief Offset of fields read by ::AERInstanceGetMotion.
+     *
+     * @since 1.6.0
+     *
+     * @memberof AERFastLayout
+     */
+    uint32_t speedX;
+} AERFastLayout;
+
+/* ----- PUBLIC GLOBALS ----- */
+
+/**
+ * @brief Instance layout of the running game, filled in by the MRE.
+ *
+ * @since 1.6.0
+ */
+extern const AERFastLayout aerFastLayout;
+
+/*
+ * Lets the MRE check, when loading a mod, that it provides everything this
+ * header expects. Weak so that every translation unit may define it.
+ */
+__attribute__((weak, visibility("default"))) const uint32_t
+    aerFastLayoutVersion = AER_FAST_LAYOUT_VERSION;
+
+/* ----- PUBLIC FUNCTIONS ----- */
+
+#define AERFastField(inst, type, field) \
+    ((type*)((char*)(inst) + aerFastLayout.field))
+
+/**
+ * @brief Unchecked variant of ::AERInstanceGetDepth.
+ *
+ * @since 1.6.0
+ */
+static inline float AERFastInstanceGetDepth(AERInstance* inst) {
+    return *AERFastField(inst, float, depth);
+}
+
+/**
+ * @brief Unchecked variant of ::AERInstanceSetDepth.
+ *
+ * @since 1.6.0
+ */
+static inline void AERFastInstanceSetDepth(AERInstance* inst, float depth) {
+    *AERFastField(inst, float, depth) = depth;
+}
+
+/**
+ * @brief Unchecked variant of ::AERInstanceGetId.
+ *
+ * @since 1.6.0
+ */
+static inline int32_t AERFastInstanceGetId(AERInstance* inst) {
+    return *AERFastField(inst, int32_t, id);
+}
+
+/**
+ * @brief Unchecked variant of ::AERInstanceGetObject.
+ *
+ * @since 1.6.0
+ */
+static inline int32_t AERFastInstanceGetObject(AERInstance* inst) {
+    return *AERFastField(inst, int32_t, objectIndex);
+}
+
+/**
+ * @brief Unchecked variant of ::AERInstanceGetVisible.
+ *
+ * @since 1.6.0
+ */
+static inline bool AERFastInstanceGetVisible(AERInstance* inst) {
+    return *AERFastField(inst, bool, visible);
+}
+
+/**
+ * @brief Unchecked variant of ::AERInstanceSetVisible.
+ *
+ * @since 1.6.0
+ */
+static inline void AERFastInstanceSetVisible(AERInstance* inst, bool visible) {
+    *AERFastField(inst, bool, visible) = visible;
+}
+
+/**
+ * @brief Unchecked variant of ::AERInstanceGetSprite.
+ *
+ * @since 1.6.0
+ */
+static inline int32_t AERFastInstanceGetSprite(AERInstance* inst) {
+    return *AERFastField(inst, int32_t, spriteIndex);
+}
+
+/**
+ * @brief Unchecked variant of ::AERInstanceSetSprite.
+ *
+ * @since 1.6.0
+ */
+static inline void AERFastInstanceSetSprite(AERInstance* inst,
+                                            int32_t spriteIdx) {
+    *AERFastField(inst, int32_t, spriteIndex) = spriteIdx;
+}
+
+/**
+ * @brief Unchecked variant of ::AERInstanceGetSpriteFrame.
+ *
+ * @since 1.6.0
+ */
+static inline float AERFastInstanceGetSpriteFrame(AERInstance* inst) {
+    return *AERFastField(inst, float, imageIndex);
+}
+
+/**
+ * @brief Unchecked variant of ::AERInstanceSetSpriteFrame.
+ *
+ * @since 1.6.0
+ */
+static inline void AERFastInstanceSetSpriteFrame(AERInstance* inst,
+                                                 float frame) {
+    *AERFastField(inst, float, imageIndex) = frame;
+}
+
+/**
+ * @brief Unchecked variant of ::AERInstanceGetSpriteSpeed.
+ *
+ * @since 1.6.0
+ */
+static inline float AERFastInstanceGetSpriteSpeed(AERInstance* inst) {
+    return *AERFastField(inst, float, imageSpeed);
+}
+
+/**
+ * @brief Unchecked variant of ::AERInstanceSetSpriteSpeed.
+ *
+ * @since 1.6.0
+ */
+static inline void AERFastInstanceSetSpriteSpeed(AERInstance* inst,
+                                                 float speed) {
+    *AERFastField(inst, float, imageSpeed) = speed;
+}
+
+/**
+ * @brief Unchecked variant of ::AERInstanceGetSpriteAlpha.
+ *
+ * @since 1.6.0
+ */
+static inline float AERFastInstanceGetSpriteAlpha(AERInstance* inst) {
+    return *AERFastField(inst, float, imageAlpha);
+}
+
+/**
+ * @brief Unchecked variant of ::AERInstanceSetSpriteAlpha.
+ *
+ * @since 1.6.0
+ */
+static inline void AERFastInstanceSetSpriteAlpha(AERInstance* inst,
+                                                 float alpha) {
+    *AERFastField(inst, float, imageAlpha) = alpha;
+}
+
+/**
+ * @brief Unchecked variant of ::AERInstanceGetSpriteAngle.
+ *
+ * @since 1.6.0
+ */
+static inline float AERFastInstanceGetSpriteAngle(AERInstance* inst) {
+    return *AERFastField(inst, float, imageAngle);
+}
+
+/**
+ * @brief Unchecked variant of ::AERInstanceSetSpriteAngle.
+ *
+ * @since 1.6.0
+ */
+static inline void AERFastInstanceSetSpriteAngle(AERInstance* inst,
+                                                 float angle) {
+    *AERFastField(inst, float, imageAngle) = angle;
+}
+
+/**
+ * @brief Unchecked variant of ::AERInstanceGetSpriteBlend.
+ *
+ * @since 1.6.0
+ */
+static inline uint32_t AERFastInstanceGetSpriteBlend(AERInstance* inst) {
+    return *AERFastField(inst, uint32_t, imageBlend);
+}
+
+/**
+ * @brief Unchecked variant of ::AERInstanceSetSpriteBlend.
+ *
+ * @since 1.6.0
+ */
+static inline void AERFastInstanceSetSpriteBlend(AERInstance* inst,
+                                                 uint32_t color) {
+    *AERFastField(inst, uint32_t, imageBlend) = color;
+}
+
+/**
+ * @brief Unchecked variant of ::AERInstanceGetMask.
+ *
+ * @since 1.6.0
+ */
+static inline int32_t AERFastInstanceGetMask(AERInstance* inst) {
+    return *AERFastField(inst, int32_t, maskIndex);
+}
+
+/**
+ * @brief Unchecked variant of ::AERInstanceGetFriction.
+ *
+ * @since 1.6.0
+ */
+static inline float AERFastInstanceGetFriction(AERInstance* inst) {
+    return *AERFastField(inst, float, friction);
+}
+
+/**
+ * @brief Unchecked variant of ::AERInstanceSetFriction.
+ *
+ * @since 1.6.0
+ */
+static inline void AERFastInstanceSetFriction(AERInstance* inst,
+                                              float friction) {
+    *AERFastField(inst, float, friction) = friction;
+}
+
+/**
+ * @brief Unchecked variant of ::AERInstanceGetSpriteScale.
+ *
+ * @note Unlike the checked variant, both `x` and `y` are required.
+ *
+ * @since 1.6.0
+ */
+static inline void AERFastInstanceGetSpriteScale(AERInstance* inst,
+                                                 float* x,
+                                                 float* y) {
+    float* vec = AERFastField(inst, float, imageScale);
+    *x = vec[0];
+    *y = vec[1];
+}
+
+/**
+ * @brief Unchecked variant of ::AERInstanceGetPosition.
+ *
+ * @note Unlike the checked variant, both `x` and `y` are required.
+ *
+ * @since 1.6.0
+ */
+static inline void AERFastInstanceGetPosition(AERInstance* inst,
+                                              float* x,
+                                              float* y) {
+    float* vec = AERFastField(inst, float, pos);
+    *x = vec[0];
+    *y = vec[1];
+}
+
+/**
+ * @brief Unchecked variant of ::AERInstanceGetMotion.
+ *
+ * @note Unlike the checked variant, both `x` and `y` are required.
+ *
+ * @since 1.6.0
+ */
+static inline void AERFastInstanceGetMotion(AERInstance* inst,
+                                            float* x,
+                                            float* y) {
+    float* vec = AERFastField(inst, float, speedX);
+    *x = vec[0];
+    *y = vec[1];
+}
+
+#undef AERFastField
+
+#endif /* AER_FAST_H */
@@ -195,4 +195,88 @@ int32_t AERFontGetFirst(int32_t fontIdx);
  */
 int32_t AERFontGetLast(int32_t fontIdx);
 
+/**
+ * @brief Query the horizontal advance of a character in a font in pixels.
+ *
+ * @subsubsection FontMetrics Font Metrics
+ *
+ * Font metrics are read from the font's file when it is registered, so
+ * measuring text never costs any draw calls or file reads, and is safe from
+ * read-only game step listeners.
+ * Only fonts registered using AERFontRegister have metrics, since the engine
+ * does not expose the glyphs of vanilla fonts. Kerning is not applied, just as
+ * the engine does not apply it when drawing.
+ *
+ * @param[in] fontIdx Font of interest.
+ * @param[in] codepoint Unicode code point of character.
+ *
+ * @return Advance in pixels, `0` if the character is not in the font, or
+ * `-1.0f` if unsuccessful.
+ *
+ * @throw ::AER_SEQ_BREAK if called before end of font registration stage.
+ * @throw ::AER_FAILED_LOOKUP if argument `fontIdx` is an invalid font or a
+ * vanilla font.
+ * @throw ::AER_FAILED_PARSE if the font's file could not be read.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERFontMeasureText
+ */
+float AERFontGetGlyphAdvance(int32_t fontIdx, uint32_t codepoint);
+
+/**
+ * @brief Query the height of a line of text in a font in pixels.
+ *
+ * See @ref FontMetrics for more information.
+ *
+ * @param[in] fontIdx Font of interest.
+ *
+ * @return Line height or `-1.0f` if unsuccessful.
+ *
+ * @throw ::AER_SEQ_BREAK if called before end of font registration stage.
+ * @throw ::AER_FAILED_LOOKUP if argument `fontIdx` is an invalid font or a
+ * vanilla font.
+ * @throw ::AER_FAILED_PARSE if the font's file could not be read.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERFontMeasureText
+ */
+float AERFontGetLineHeight(int32_t fontIdx);
+
+/**
+ * @brief Measure the size text would take up if drawn in a font.
+ *
+ * Text is laid out the same way AERDrawText lays it out: text escape sequences
+ * (see @ref DrawTextEscape) and newlines break lines, and lines wider than
+ * argument `width` are broken at their last space. See @ref FontMetrics for
+ * more information.
+ *
+ * If only one of the two dimensions is needed, then the argument for the
+ * other may be `NULL`.
+ *
+ * @param[in] fontIdx Font of interest.
+ * @param[in] text String to measure.
+ * @param[in] width Maximum line width before line break in pixels (not
+ * characters).
+ * @param[out] textWidth Width of widest line in pixels.
+ * @param[out] textHeight Height of all lines in pixels.
+ *
+ * @throw ::AER_SEQ_BREAK if called before end of font registration stage.
+ * @throw ::AER_NULL_ARG if argument `text` is `NULL` or both arguments
+ * `textWidth` and `textHeight` are `NULL`.
+ * @throw ::AER_FAILED_LOOKUP if argument `fontIdx` is an invalid font or a
+ * vanilla font.
+ * @throw ::AER_FAILED_PARSE if the font's file could not be read.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERDrawText
+ */
+void AERFontMeasureText(int32_t fontIdx,
+                        const char* text,
+                        uint32_t width,
+                        float* textWidth,
+                        float* textHeight);
+
 #endif /* AER_FONT_H */
\ No newline at end of file
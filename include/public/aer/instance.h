@@ -426,6 +426,62 @@ void AERInstanceGetBoundingBox(AERInstance* inst,
                                float* right,
                                float* bottom);
 
+/**
+ * @brief Query whether an instance is on screen.
+ *
+ * An instance is on screen if its bounding box overlaps any visible view of
+ * the current room, or if the room has no visible views. Instances without a
+ * sprite or mask are treated as a single point at their position.
+ *
+ * @note This only accounts for the instance's bounding box, not for anything
+ * its draw listeners may draw outside of it.
+ *
+ * @param[in] inst Instance of interest.
+ *
+ * @return Whether instance is on screen or `false` if unsuccessful.
+ *
+ * @throw ::AER_SEQ_BREAK if called outside action stage.
+ * @throw ::AER_NULL_ARG if argument `inst` is `NULL`.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERInstanceGetOnScreen
+ * @sa AERDrawIsRectVisible
+ * @sa AERObjectAttachDrawListenerAdv
+ */
+bool AERInstanceIsOnScreen(AERInstance* inst);
+
+/**
+ * @brief Query all instances in the current room which are on screen.
+ *
+ * See AERInstanceIsOnScreen for what counts as on screen. The set of
+ * on-screen instances is recorded once per step before read-only game step
+ * listeners run and again before the draw stage, so this is cheap to call
+ * from many of those listeners. Elsewhere it is computed on every call.
+ *
+ * @warning Argument `instBuf` must be large enough to hold at least
+ * `bufSize` elements.
+ *
+ * @note Argument `bufSize` may be `0` in which case argument `instBuf` may
+ * be `NULL`. This may be used to efficiently query the total number of
+ * instances on screen.
+ *
+ * @param[in] bufSize Maximum number of elements to write to argument
+ * `instBuf`.
+ * @param[out] instBuf Buffer to write instances to.
+ *
+ * @return Total number of instances on screen or `0` if unsuccessful.
+ *
+ * @throw ::AER_SEQ_BREAK if called outside action stage.
+ * @throw ::AER_NULL_ARG if argument `instBuf` is `NULL` and argument
+ * `bufSize` is greater than `0`.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERInstanceIsOnScreen
+ */
+size_t AERInstanceGetOnScreen(size_t bufSize, AERInstance** instBuf);
+
 /**
  * @brief Query the friction of an instance.
  *
@@ -540,6 +596,28 @@ int32_t AERInstanceGetMask(AERInstance* inst);
  */
 void AERInstanceSetMask(AERInstance* inst, int32_t maskIdx);
 
+/**
+ * @brief Query whether or not the collision masks of two instances overlap.
+ *
+ * Each instance is tested using its mask, or its sprite if it has no mask, at
+ * its current frame and position, as described for ::AERSpriteMasksOverlap.
+ * The scale and rotation of the instances are not taken into account.
+ *
+ * @param[in] instA First instance.
+ * @param[in] instB Second instance.
+ *
+ * @return Whether or not the instances overlap or `false` if unsuccessful or
+ * if either instance has neither a mask nor a sprite.
+ *
+ * @throw ::AER_SEQ_BREAK if called outside action stage.
+ * @throw ::AER_NULL_ARG if argument `instA` or `instB` is `NULL`.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERInstanceGetBoundingBox
+ */
+bool AERInstanceMasksOverlap(AERInstance* instA, AERInstance* instB);
+
 /**
  * @brief Query the visibility of an instance.
  *
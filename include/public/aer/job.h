@@ -0,0 +1,149 @@
+/**
+ * @file
+ *
+ * @brief Utilities for running expensive computations on worker threads.
+ *
+ * The MRE owns a fixed pool of worker threads that is created when the MRE is
+ * loaded. Jobs submitted to the pool run concurrently with the game, so they
+ * must only perform self-contained computation.
+ *
+ * @warning Jobs run outside of every MRE stage, so MRE functions which are
+ * restricted to a stage report ::AER_SEQ_BREAK when called from a job. Logging,
+ * configuration and job functions may be called from jobs, but
+ * pseudorandom number functions using the global generator may not. Do any
+ * work that touches the game in a completion callback instead.
+ *
+ * @note Each thread has its own ::aererr.
+ *
+ * @since 1.6.0
+ *
+ * @copyright 2021 the libaermre authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef AER_JOB_H
+#define AER_JOB_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* ----- PUBLIC MACROS ----- */
+
+/**
+ * @brief Job handle that never refers to a job.
+ *
+ * @since 1.6.0
+ */
+#define AER_JOB_NULL ((uint64_t)0)
+
+/* ----- PUBLIC FUNCTIONS ----- */
+
+/**
+ * @brief Submit a job to the worker thread pool.
+ *
+ * @param[in] func Function to run on a worker thread.
+ * @param[in] arg Argument to pass to `func`. May be `NULL`.
+ *
+ * @return Handle of new job or ::AER_JOB_NULL if unsuccessful.
+ *
+ * @throw ::AER_NULL_ARG if argument `func` is `NULL`.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERJobSubmitAdv
+ */
+uint64_t AERJobSubmit(void (*func)(void* arg), void* arg);
+
+/**
+ * @brief Submit a job to the worker thread pool with a completion callback
+ * and dependencies.
+ *
+ * The job will not start until all of its dependencies have finished. Jobs
+ * that have already finished may be given as dependencies.
+ *
+ * If provided, the completion callback is called on the main thread at the
+ * start of the first step after the job finishes, so it may freely use the
+ * rest of the MRE API.
+ *
+ * @warning Argument `deps` must be large enough to hold at least `numDeps`
+ * elements.
+ *
+ * @param[in] func Function to run on a worker thread.
+ * @param[in] arg Argument to pass to `func` and `callback`. May be `NULL`.
+ * @param[in] callback Function to call on the main thread once `func` has
+ * finished. May be `NULL`.
+ * @param[in] numDeps Number of dependencies.
+ * @param[in] deps Handles of jobs that must finish first. May be `NULL` if
+ * `numDeps` is `0`.
+ *
+ * @return Handle of new job or ::AER_JOB_NULL if unsuccessful.
+ *
+ * @throw ::AER_NULL_ARG if argument `func` is `NULL` or argument `deps` is
+ * `NULL` and argument `numDeps` is not `0`.
+ * @throw ::AER_FAILED_LOOKUP if an element of argument `deps` is
+ * ::AER_JOB_NULL.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERJobSubmit
+ */
+uint64_t AERJobSubmitAdv(void (*func)(void* arg),
+                         void* arg,
+                         void (*callback)(void* arg),
+                         size_t numDeps,
+                         const uint64_t* deps);
+
+/**
+ * @brief Block until a job has finished.
+ *
+ * While waiting, the calling thread helps run queued jobs.
+ *
+ * @note This function does not wait for the job's completion callback.
+ *
+ * @param[in] job Job of interest.
+ *
+ * @throw ::AER_FAILED_LOOKUP if argument `job` is ::AER_JOB_NULL.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERJobIsDone
+ */
+void AERJobWait(uint64_t job);
+
+/**
+ * @brief Query whether a job has finished.
+ *
+ * @param[in] job Job of interest.
+ *
+ * @return `true` if job has finished or `false` if unsuccessful or job has not
+ * finished.
+ *
+ * @throw ::AER_FAILED_LOOKUP if argument `job` is ::AER_JOB_NULL.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERJobWait
+ */
+bool AERJobIsDone(uint64_t job);
+
+/**
+ * @brief Query the number of worker threads in the pool.
+ *
+ * @return Number of worker threads.
+ *
+ * @since 1.6.0
+ */
+size_t AERJobGetNumWorkers(void);
+
+#endif /* AER_JOB_H */
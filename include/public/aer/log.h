@@ -22,6 +22,49 @@
 #ifndef AER_LOG_H
 #define AER_LOG_H
 
+/* ----- PUBLIC MACROS ----- */
+
+/**
+ * @brief Value of ::AER_LOG_MIN_LEVEL which keeps all log calls.
+ *
+ * @since 1.6.0
+ */
+#define AER_LOG_LEVEL_INFO 0
+
+/**
+ * @brief Value of ::AER_LOG_MIN_LEVEL which compiles out calls to
+ * ::AERLogInfo.
+ *
+ * @since 1.6.0
+ */
+#define AER_LOG_LEVEL_WARN 1
+
+/**
+ * @brief Value of ::AER_LOG_MIN_LEVEL which compiles out calls to
+ * ::AERLogInfo and ::AERLogWarn.
+ *
+ * @since 1.6.0
+ */
+#define AER_LOG_LEVEL_ERR 2
+
+#ifndef AER_LOG_MIN_LEVEL
+/**
+ * @brief Lowest log level that a mod is compiled with.
+ *
+ * Define this (for example with `-DAER_LOG_MIN_LEVEL=AER_LOG_LEVEL_WARN`)
+ * before including this header to remove lower-level log calls from a mod
+ * entirely. Removed calls do not evaluate their arguments and do not touch
+ * ::aererr.
+ *
+ * Independently of this, the MRE filters log messages at runtime using the
+ * `log.level` and `log.mods.<mod name>.level` keys of its configuration.
+ * Those keys accept `"info"`, `"warn"`, `"error"` and `"none"`.
+ *
+ * @since 1.6.0
+ */
+#define AER_LOG_MIN_LEVEL AER_LOG_LEVEL_INFO
+#endif
+
 /* ----- PUBLIC FUNCTIONS ----- */
 
 /**
@@ -62,4 +105,12 @@ void AERLogWarn(const char* fmt, ...);
  */
 void AERLogErr(const char* fmt, ...);
 
+#if AER_LOG_MIN_LEVEL > AER_LOG_LEVEL_INFO
+#define AERLogInfo(...) ((void)0)
+#endif
+
+#if AER_LOG_MIN_LEVEL > AER_LOG_LEVEL_WARN
+#define AERLogWarn(...) ((void)0)
+#endif
+
 #endif /* AER_LOG_H */
@@ -37,6 +37,7 @@
 #define AER_MOD_H
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 /* ----- PUBLIC TYPES ----- */
@@ -320,6 +321,89 @@ typedef struct AERModDef {
      * @memberof AERModDef
      */
     void (*roomEndListener)(int32_t newRoomIdx, int32_t prevRoomIdx);
+    /**
+     * @var parallelGameStepListener
+     *
+     * @brief Mod's read-only game step pseudo-event listener.
+     *
+     * If provided, the MRE will call it at the very start of every in-game
+     * step, concurrently with other mods' read-only game step listeners, on
+     * the worker threads of the job pool. All read-only listeners finish
+     * before any gameStepListener is called.
+     *
+     * While these listeners run, the main thread is blocked, so engine state
+     * (including the input tables) does not change underneath them. Derived
+     * state that the MRE otherwise computes on demand (such as on-screen
+     * visibility, font metrics and sprite collision masks) is prepared on the
+     * main thread before they start, so queries never fill caches here.
+     *
+     * @warning This listener may only *read* engine and MRE state. It may
+     * freely modify its own mod's private data, but must not call any MRE
+     * function that changes the game (such as creating instances, setting
+     * instance properties or creating mod instance locals) or use the global
+     * pseudorandom number generator. Such functions fail with
+     * ::AER_SEQ_BREAK when called from this listener.
+     *
+     * @note May be `NULL`.
+     *
+     * @since 1.6.0
+     *
+     * @sa AERModDef::gameStepListener
+     *
+     * @memberof AERModDef
+     */
+    void (*parallelGameStepListener)(void);
 } AERModDef;
 
+/* ----- PUBLIC FUNCTIONS ----- */
+
+/**
+ * @brief Query the number of loaded mods.
+ *
+ * Mod indices range from `0` up to (but not including) this number and follow
+ * the order of mods in the MRE's configuration.
+ *
+ * @return Number of mods or `0` if unsuccessful.
+ *
+ * @throw ::AER_SEQ_BREAK if called before start of sprite registration stage.
+ *
+ * @since 1.6.0
+ */
+size_t AERModGetNumMods(void);
+
+/**
+ * @brief Query the name of a mod.
+ *
+ * @param[in] modIdx Mod of interest.
+ *
+ * @return Name of mod or `NULL` if unsuccessful.
+ *
+ * @throw ::AER_SEQ_BREAK if called before start of sprite registration stage.
+ * @throw ::AER_FAILED_LOOKUP if argument `modIdx` is an invalid mod.
+ *
+ * @since 1.6.0
+ */
+const char* AERModGetName(int32_t modIdx);
+
+/**
+ * @brief Query the time a mod spent in its listeners during the previous
+ * step in seconds.
+ *
+ * This includes the mod's pseudo-event listeners and object event listeners,
+ * but not time spent in other mods' listeners or in vanilla event listeners
+ * called from within the mod's listeners.
+ *
+ * @param[in] modIdx Mod of interest.
+ *
+ * @return Time in seconds or `0` if unsuccessful.
+ *
+ * @throw ::AER_SEQ_BREAK if called outside action stage.
+ * @throw ::AER_FAILED_LOOKUP if argument `modIdx` is an invalid mod.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERGetDeltaTime
+ */
+double AERModGetFrameTime(int32_t modIdx);
+
 #endif /* AER_MOD_H */
@@ -0,0 +1,379 @@
+/**
+ * @file
+ *
+ * @brief Utilities for generating coherent noise.
+ *
+ * Unlike independent pseudorandom values, noise changes smoothly between
+ * nearby coordinates, which makes it suited to effects such as wind, flicker
+ * and terrain decoration. The noise here is Perlin's improved gradient noise,
+ * which is `0.0` at integer coordinates and varies within [-1, 1] between
+ * them. Fractal Brownian motion (fBm) layers several octaves of it for finer
+ * detail.
+ *
+ * A noise generator is fully determined by its seed: the same seed and
+ * coordinates always produce the same value, whether evaluated one at a time
+ * or in a batch. Generators are never modified after creation, so they may be
+ * shared with jobs.
+ *
+ * @note Coordinates should stay within [-2^22, 2^22], beyond which single
+ * precision can no longer resolve positions within a lattice cell.
+ *
+ * @since 1.6.0
+ *
+ * @copyright 2021 the libaermre authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef AER_NOISE_H
+#define AER_NOISE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* ----- PUBLIC TYPES ----- */
+
+/**
+ * @brief Opaque type for a coherent noise generator.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERNoiseNew
+ */
+typedef void AERNoise;
+
+/* ----- PUBLIC FUNCTIONS ----- */
+
+/**
+ * @brief Allocate and initialize a new noise generator.
+ *
+ * When no longer needed, free this generator using AERNoiseFree.
+ *
+ * @note To derive a generator deterministically from a self-managed
+ * pseudorandom number generator, seed it with AERRandGenUInt.
+ *
+ * @param[in] seed Seed to initialize generator with.
+ *
+ * @return New noise generator.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERNoiseFree
+ */
+AERNoise* AERNoiseNew(uint64_t seed);
+
+/**
+ * @brief Free a noise generator.
+ *
+ * @param[in] noise Noise generator of interest.
+ *
+ * @throw ::AER_NULL_ARG if argument `noise` is `NULL`.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERNoiseNew
+ */
+void AERNoiseFree(AERNoise* noise);
+
+/**
+ * @brief Evaluate one-dimensional gradient noise.
+ *
+ * @param[in] noise Noise generator of interest.
+ * @param[in] x X-coordinate.
+ *
+ * @return Noise value on the interval [-1, 1] or `0.0f` if unsuccessful.
+ *
+ * @throw ::AER_NULL_ARG if argument `noise` is `NULL`.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERNoiseFBm1
+ */
+float AERNoise1(const AERNoise* noise, float x);
+
+/**
+ * @brief Evaluate two-dimensional gradient noise.
+ *
+ * @param[in] noise Noise generator of interest.
+ * @param[in] x X-coordinate.
+ * @param[in] y Y-coordinate.
+ *
+ * @return Noise value on the interval [-1, 1] or `0.0f` if unsuccessful.
+ *
+ * @throw ::AER_NULL_ARG if argument `noise` is `NULL`.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERNoiseFBm2
+ */
+float AERNoise2(const AERNoise* noise, float x, float y);
+
+/**
+ * @brief Evaluate three-dimensional gradient noise.
+ *
+ * @param[in] noise Noise generator of interest.
+ * @param[in] x X-coordinate.
+ * @param[in] y Y-coordinate.
+ * @param[in] z Z-coordinate.
+ *
+ * @return Noise value on the interval [-1, 1] or `0.0f` if unsuccessful.
+ *
+ * @throw ::AER_NULL_ARG if argument `noise` is `NULL`.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERNoiseFBm3
+ */
+float AERNoise3(const AERNoise* noise, float x, float y, float z);
+
+/**
+ * @brief Evaluate one-dimensional fractal Brownian motion.
+ *
+ * Each octave evaluates gradient noise at `lacunarity` times the frequency and
+ * `gain` times the amplitude of the previous one. The sum is divided by the
+ * total amplitude, so it stays on the interval [-1, 1].
+ *
+ * @param[in] noise Noise generator of interest.
+ * @param[in] x X-coordinate.
+ * @param[in] octaves Number of octaves to sum.
+ * @param[in] lacunarity Frequency multiplier between octaves, commonly `2.0f`.
+ * @param[in] gain Amplitude multiplier between octaves, commonly `0.5f`.
+ *
+ * @return Noise value on the interval [-1, 1] or `0.0f` if unsuccessful.
+ *
+ * @throw ::AER_NULL_ARG if argument `noise` is `NULL`.
+ * @throw ::AER_BAD_VAL if argument `octaves` is `0`.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERNoise1
+ * @sa AERNoiseFill1
+ */
+float AERNoiseFBm1(const AERNoise* noise,
+                   float x,
+                   uint32_t octaves,
+                   float lacunarity,
+                   float gain);
+
+/**
+ * @brief Evaluate two-dimensional fractal Brownian motion.
+ *
+ * Each octave evaluates gradient noise at `lacunarity` times the frequency and
+ * `gain` times the amplitude of the previous one. The sum is divided by the
+ * total amplitude, so it stays on the interval [-1, 1].
+ *
+ * @param[in] noise Noise generator of interest.
+ * @param[in] x X-coordinate.
+ * @param[in] y Y-coordinate.
+ * @param[in] octaves Number of octaves to sum.
+ * @param[in] lacunarity Frequency multiplier between octaves, commonly `2.0f`.
+ * @param[in] gain Amplitude multiplier between octaves, commonly `0.5f`.
+ *
+ * @return Noise value on the interval [-1, 1] or `0.0f` if unsuccessful.
+ *
+ * @throw ::AER_NULL_ARG if argument `noise` is `NULL`.
+ * @throw ::AER_BAD_VAL if argument `octaves` is `0`.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERNoise2
+ * @sa AERNoiseFill2
+ */
+float AERNoiseFBm2(const AERNoise* noise,
+                   float x,
+                   float y,
+                   uint32_t octaves,
+                   float lacunarity,
+                   float gain);
+
+/**
+ * @brief Evaluate three-dimensional fractal Brownian motion.
+ *
+ * Each octave evaluates gradient noise at `lacunarity` times the frequency and
+ * `gain` times the amplitude of the previous one. The sum is divided by the
+ * total amplitude, so it stays on the interval [-1, 1].
+ *
+ * @param[in] noise Noise generator of interest.
+ * @param[in] x X-coordinate.
+ * @param[in] y Y-coordinate.
+ * @param[in] z Z-coordinate.
+ * @param[in] octaves Number of octaves to sum.
+ * @param[in] lacunarity Frequency multiplier between octaves, commonly `2.0f`.
+ * @param[in] gain Amplitude multiplier between octaves, commonly `0.5f`.
+ *
+ * @return Noise value on the interval [-1, 1] or `0.0f` if unsuccessful.
+ *
+ * @throw ::AER_NULL_ARG if argument `noise` is `NULL`.
+ * @throw ::AER_BAD_VAL if argument `octaves` is `0`.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERNoise3
+ * @sa AERNoiseFill3
+ */
+float AERNoiseFBm3(const AERNoise* noise,
+                   float x,
+                   float y,
+                   float z,
+                   uint32_t octaves,
+                   float lacunarity,
+                   float gain);
+
+/**
+ * @brief Evaluate one-dimensional fractal Brownian motion at each of an
+ * array of coordinates.
+ *
+ * Several coordinates are evaluated at once using SIMD instructions. Each
+ * result is identical to that of AERNoiseFBm1 with the same arguments.
+ *
+ * @note Use an argument `octaves` of `1` for plain gradient noise.
+ *
+ * @param[in] noise Noise generator of interest.
+ * @param[in] bufSize Number of coordinates.
+ * @param[in] xBuf Buffer of X-coordinates.
+ * @param[in] octaves Number of octaves to sum.
+ * @param[in] lacunarity Frequency multiplier between octaves.
+ * @param[in] gain Amplitude multiplier between octaves.
+ * @param[out] noiseBuf Buffer to write noise values to.
+ *
+ * @throw ::AER_NULL_ARG if argument `noise` is `NULL` or argument `xBuf` or
+ * `noiseBuf` is `NULL` and argument `bufSize` is greater than `0`.
+ * @throw ::AER_BAD_VAL if argument `octaves` is `0`.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERNoiseFBm1
+ */
+void AERNoiseFill1(const AERNoise* noise,
+                   size_t bufSize,
+                   const float* xBuf,
+                   uint32_t octaves,
+                   float lacunarity,
+                   float gain,
+                   float* noiseBuf);
+
+/**
+ * @brief Evaluate two-dimensional fractal Brownian motion at each of an
+ * array of coordinates.
+ *
+ * Several coordinates are evaluated at once using SIMD instructions. Each
+ * result is identical to that of AERNoiseFBm2 with the same arguments.
+ *
+ * @note Use an argument `octaves` of `1` for plain gradient noise.
+ *
+ * @param[in] noise Noise generator of interest.
+ * @param[in] bufSize Number of coordinates.
+ * @param[in] xBuf Buffer of X-coordinates.
+ * @param[in] yBuf Buffer of Y-coordinates.
+ * @param[in] octaves Number of octaves to sum.
+ * @param[in] lacunarity Frequency multiplier between octaves.
+ * @param[in] gain Amplitude multiplier between octaves.
+ * @param[out] noiseBuf Buffer to write noise values to.
+ *
+ * @throw ::AER_NULL_ARG if argument `noise` is `NULL` or any of arguments
+ * `xBuf`, `yBuf` or `noiseBuf` is `NULL` and argument `bufSize` is greater
+ * than `0`.
+ * @throw ::AER_BAD_VAL if argument `octaves` is `0`.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERNoiseFBm2
+ */
+void AERNoiseFill2(const AERNoise* noise,
+                   size_t bufSize,
+                   const float* xBuf,
+                   const float* yBuf,
+                   uint32_t octaves,
+                   float lacunarity,
+                   float gain,
+                   float* noiseBuf);
+
+/**
+ * @brief Evaluate three-dimensional fractal Brownian motion at each of an
+ * array of coordinates.
+ *
+ * Several coordinates are evaluated at once using SIMD instructions. Each
+ * result is identical to that of AERNoiseFBm3 with the same arguments.
+ *
+ * @note Use an argument `octaves` of `1` for plain gradient noise.
+ *
+ * @param[in] noise Noise generator of interest.
+ * @param[in] bufSize Number of coordinates.
+ * @param[in] xBuf Buffer of X-coordinates.
+ * @param[in] yBuf Buffer of Y-coordinates.
+ * @param[in] zBuf Buffer of Z-coordinates.
+ * @param[in] octaves Number of octaves to sum.
+ * @param[in] lacunarity Frequency multiplier between octaves.
+ * @param[in] gain Amplitude multiplier between octaves.
+ * @param[out] noiseBuf Buffer to write noise values to.
+ *
+ * @throw ::AER_NULL_ARG if argument `noise` is `NULL` or any of arguments
+ * `xBuf`, `yBuf`, `zBuf` or `noiseBuf` is `NULL` and argument `bufSize` is
+ * greater than `0`.
+ * @throw ::AER_BAD_VAL if argument `octaves` is `0`.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERNoiseFBm3
+ */
+void AERNoiseFill3(const AERNoise* noise,
+                   size_t bufSize,
+                   const float* xBuf,
+                   const float* yBuf,
+                   const float* zBuf,
+                   uint32_t octaves,
+                   float lacunarity,
+                   float gain,
+                   float* noiseBuf);
+
+/**
+ * @brief Evaluate two-dimensional fractal Brownian motion over an evenly
+ * spaced grid.
+ *
+ * The value at column `col` and row `row` is written to
+ * `noiseBuf[row * width + col]` and is identical to that of AERNoiseFBm2 at
+ * coordinates (`x + col * step`, `y + row * step`). Several columns are
+ * evaluated at once using SIMD instructions.
+ *
+ * @param[in] noise Noise generator of interest.
+ * @param[in] x X-coordinate of first column.
+ * @param[in] y Y-coordinate of first row.
+ * @param[in] step Distance between neighboring columns and rows.
+ * @param[in] width Number of columns.
+ * @param[in] height Number of rows.
+ * @param[in] octaves Number of octaves to sum.
+ * @param[in] lacunarity Frequency multiplier between octaves.
+ * @param[in] gain Amplitude multiplier between octaves.
+ * @param[out] noiseBuf Buffer of at least `width * height` elements to write
+ * noise values to.
+ *
+ * @throw ::AER_NULL_ARG if argument `noise` is `NULL` or argument `noiseBuf`
+ * is `NULL` and the grid is not empty.
+ * @throw ::AER_BAD_VAL if argument `octaves` is `0` or `width * height`
+ * overflows `size_t`.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERNoiseFBm2
+ */
+void AERNoiseFillGrid2(const AERNoise* noise,
+                       float x,
+                       float y,
+                       float step,
+                       size_t width,
+                       size_t height,
+                       uint32_t octaves,
+                       float lacunarity,
+                       float gain,
+                       float* noiseBuf);
+
+#endif /* AER_NOISE_H */
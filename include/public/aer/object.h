@@ -1221,6 +1221,43 @@ void AERObjectAttachDrawListener(int32_t objIdx,
                                                   AERInstance* target,
                                                   AERInstance* other));
 
+/**
+ * @brief Attach a draw event listener to an object with extra options.
+ *
+ * This is the same as AERObjectAttachDrawListener, except that the listener
+ * may be culled.
+ *
+ * A culled listener is skipped for instances whose bounding box lies outside
+ * of every visible view (see AERInstanceIsOnScreen). The remaining listeners
+ * and the vanilla draw listener still execute as if the culled listener had
+ * passed the event on.
+ *
+ * @warning A culled listener is not called at all for an off-screen instance,
+ * so it should only draw within the instance's bounding box. Listeners
+ * drawing effects which extend beyond it should leave culling off and check
+ * visibility with AERDrawIsRectVisible themselves.
+ *
+ * @param[in] objIdx Object of interest.
+ * @param[in] listener Callback function executed when target event occurs.
+ * For more information see @ref ObjListeners.
+ * @param[in] cull Whether to skip the listener for instances that are not on
+ * screen.
+ *
+ * @throw ::AER_SEQ_BREAK if called outside listener registration stage.
+ * @throw ::AER_NULL_ARG if argument `listener` is `NULL`.
+ * @throw ::AER_FAILED_LOOKUP if argument `objIdx` is an invalid object.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERObjectAttachDrawListener
+ * @sa AERInstanceIsOnScreen
+ */
+void AERObjectAttachDrawListenerAdv(int32_t objIdx,
+                                    bool (*listener)(AEREvent* event,
+                                                     AERInstance* target,
+                                                     AERInstance* other),
+                                    bool cull);
+
 /**
  * @brief Attach a GUI-draw event listener to an object.
  *
@@ -26,6 +26,8 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include "aer/instance.h"
+
 /* ----- PUBLIC TYPES ----- */
 
 /**
@@ -37,6 +39,18 @@
  */
 typedef void AERRandGen;
 
+/**
+ * @brief Opaque type for a precomputed table of weights used to make
+ * weighted choices in constant time.
+ *
+ * Use this with AERRandAlias and AERRandGenAlias.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERRandAliasTableNew
+ */
+typedef void AERRandAliasTable;
+
 /* ----- PUBLIC FUNCTIONS ----- */
 
 /**
@@ -228,6 +242,418 @@ bool AERRandBool(void);
  */
 void AERRandShuffle(size_t elemSize, size_t bufSize, void* elemBuf);
 
+/**
+ * @brief Shuffle an array of 32-bit elements using the automatically-seeded
+ * global generator.
+ *
+ * Like calling AERRandShuffle with an element size of `4`, but without
+ * dispatching on the element size and drawing indices with a faster unbiased
+ * method. Elements need not be aligned.
+ *
+ * @note For the same generator state, the resulting permutation differs from
+ * that of AERRandShuffle.
+ *
+ * @param[in] bufSize Size of buffer in elements.
+ * @param[in,out] elemBuf Buffer of elements to shuffle.
+ *
+ * @throw ::AER_NULL_ARG if argument `elemBuf` is `NULL` and argument
+ * `bufSize` is greater than `0`.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERRandGenShuffle32
+ */
+void AERRandShuffle32(size_t bufSize, void* elemBuf);
+
+/**
+ * @brief Shuffle an array of 64-bit elements using the automatically-seeded
+ * global generator.
+ *
+ * Like calling AERRandShuffle with an element size of `8`, but without
+ * dispatching on the element size and drawing indices with a faster unbiased
+ * method. Elements need not be aligned.
+ *
+ * @note For the same generator state, the resulting permutation differs from
+ * that of AERRandShuffle.
+ *
+ * @param[in] bufSize Size of buffer in elements.
+ * @param[in,out] elemBuf Buffer of elements to shuffle.
+ *
+ * @throw ::AER_NULL_ARG if argument `elemBuf` is `NULL` and argument
+ * `bufSize` is greater than `0`.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERRandGenShuffle64
+ */
+void AERRandShuffle64(size_t bufSize, void* elemBuf);
+
+/**
+ * @brief Shuffle an array of 128-bit elements using the automatically-seeded
+ * global generator.
+ *
+ * Like calling AERRandShuffle with an element size of `16`, but without
+ * dispatching on the element size and drawing indices with a faster unbiased
+ * method. Elements need not be aligned.
+ *
+ * @note For the same generator state, the resulting permutation differs from
+ * that of AERRandShuffle.
+ *
+ * @param[in] bufSize Size of buffer in elements.
+ * @param[in,out] elemBuf Buffer of elements to shuffle.
+ *
+ * @throw ::AER_NULL_ARG if argument `elemBuf` is `NULL` and argument
+ * `bufSize` is greater than `0`.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERRandGenShuffle128
+ */
+void AERRandShuffle128(size_t bufSize, void* elemBuf);
+
+/**
+ * @brief Shuffle an array of pointers using the automatically-seeded global
+ * generator.
+ *
+ * @param[in] bufSize Size of buffer in elements.
+ * @param[in,out] ptrBuf Buffer of pointers to shuffle.
+ *
+ * @throw ::AER_NULL_ARG if argument `ptrBuf` is `NULL` and argument
+ * `bufSize` is greater than `0`.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERRandGenShufflePtr
+ */
+void AERRandShufflePtr(size_t bufSize, void** ptrBuf);
+
+/**
+ * @brief Choose distinct indices on the interval [0, `popSize`) using the
+ * automatically-seeded global generator.
+ *
+ * Every subset of `bufSize` indices is equally likely, and the chosen indices
+ * are written in random order. This takes time proportional to `bufSize`, not
+ * `popSize`, so it is suited to picking a few items out of many.
+ *
+ * @param[in] bufSize Number of indices to choose.
+ * @param[in] popSize Number of indices to choose from.
+ * @param[out] idxBuf Buffer to write chosen indices to.
+ *
+ * @throw ::AER_NULL_ARG if argument `idxBuf` is `NULL` and argument
+ * `bufSize` is greater than `0`.
+ * @throw ::AER_BAD_VAL if argument `bufSize` is greater than argument
+ * `popSize`.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERRandGenSample
+ */
+void AERRandSample(size_t bufSize, size_t popSize, size_t* idxBuf);
+
+/**
+ * @brief Choose distinct instances of an object in the current room using the
+ * automatically-seeded global generator.
+ *
+ * Instances are chosen with reservoir sampling in a single pass over the
+ * room's instance lists, without first copying every instance. Every subset
+ * is equally likely, and the chosen instances are written in random order.
+ *
+ * @note If there are fewer instances than argument `bufSize`, then every
+ * instance is written.
+ *
+ * @param[in] objIdx Object to choose instances of.
+ * @param[in] recursive Whether to choose from instances of given object only
+ * (`false`) or both given object and direct and indirect children of given
+ * object (`true`).
+ * @param[in] bufSize Maximum number of instances to choose.
+ * @param[out] instBuf Buffer to write chosen instances to.
+ *
+ * @return Total number of instances of object in current room or `0` if
+ * unsuccessful.
+ *
+ * @throw ::AER_SEQ_BREAK if called outside action stage.
+ * @throw ::AER_NULL_ARG if argument `instBuf` is `NULL` and argument
+ * `bufSize` is greater than `0`.
+ * @throw ::AER_FAILED_LOOKUP if argument `objIdx` is an invalid object.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERRandGenSampleInstances
+ * @sa AERInstanceGetByObject
+ */
+size_t AERRandSampleInstances(int32_t objIdx,
+                              bool recursive,
+                              size_t bufSize,
+                              AERInstance** instBuf);
+
+/**
+ * @brief Fill a buffer with pseudorandom unsigned integers on the interval
+ * [0, 2^64) using the automatically-seeded global generator.
+ *
+ * Large buffers are filled by several interleaved generators, which are
+ * seeded from the automatically-seeded global generator. This is much faster
+ * than repeated calls to AERRandUInt, but does not produce the same sequence.
+ *
+ * @note The interleaved generators are SIMD lanes advanced together within
+ * this one call, not threads. Calls sharing a generator must still not run
+ * concurrently.
+ *
+ * @param[in] bufSize Size of buffer in elements.
+ * @param[out] uintBuf Buffer to fill.
+ *
+ * @throw ::AER_NULL_ARG if argument `uintBuf` is `NULL` and argument
+ * `bufSize` is greater than `0`.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERRandGenFillUInt
+ */
+void AERRandFillUInt(size_t bufSize, uint64_t* uintBuf);
+
+/**
+ * @brief Fill a buffer with pseudorandom floating-point values on the interval
+ * [0.0f, 1.0f) using the automatically-seeded global generator.
+ *
+ * Large buffers are filled by several interleaved generators, which are
+ * seeded from the automatically-seeded global generator. This is much faster
+ * than repeated calls to AERRandFloat, but does not produce the same sequence.
+ *
+ * @note The interleaved generators are SIMD lanes advanced together within
+ * this one call, not threads. Calls sharing a generator must still not run
+ * concurrently.
+ *
+ * @bug Like ::AERRandFloat, this uses a method of obtaining floats from
+ * integers that introduces slight distribution-related bias.
+ *
+ * @param[in] bufSize Size of buffer in elements.
+ * @param[out] floatBuf Buffer to fill.
+ *
+ * @throw ::AER_NULL_ARG if argument `floatBuf` is `NULL` and argument
+ * `bufSize` is greater than `0`.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERRandGenFillFloat
+ */
+void AERRandFillFloat(size_t bufSize, float* floatBuf);
+
+/**
+ * @brief Fill a buffer with pseudorandom floating-point values on the interval
+ * [min, max) using the automatically-seeded global generator.
+ *
+ * Large buffers are filled by several interleaved generators, which are
+ * seeded from the automatically-seeded global generator. This is much faster
+ * than repeated calls to AERRandFloatRange, but does not produce the same
+ * sequence.
+ *
+ * @note The interleaved generators are SIMD lanes advanced together within
+ * this one call, not threads. Calls sharing a generator must still not run
+ * concurrently.
+ *
+ * @bug Like ::AERRandFloat, this uses a method of obtaining floats from
+ * integers that introduces slight distribution-related bias.
+ *
+ * @param[in] bufSize Size of buffer in elements.
+ * @param[in] min Minimum possible value (inclusive).
+ * @param[in] max Maximum possible value (exclusive).
+ * @param[out] floatBuf Buffer to fill.
+ *
+ * @throw ::AER_NULL_ARG if argument `floatBuf` is `NULL` and argument
+ * `bufSize` is greater than `0`.
+ * @throw ::AER_BAD_VAL if argument `min` is greater than or equal to
+ * argument `max`.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERRandGenFillFloatRange
+ */
+void AERRandFillFloatRange(size_t bufSize,
+                           float min,
+                           float max,
+                           float* floatBuf);
+
+/**
+ * @brief Fill a buffer with pseudorandom double floating-point values on the
+ * interval [0.0, 1.0) using the automatically-seeded global generator.
+ *
+ * Large buffers are filled by several interleaved generators, which are
+ * seeded from the automatically-seeded global generator. This is much faster
+ * than repeated calls to AERRandDouble, but does not produce the same sequence.
+ *
+ * @note The interleaved generators are SIMD lanes advanced together within
+ * this one call, not threads. Calls sharing a generator must still not run
+ * concurrently.
+ *
+ * @bug Like ::AERRandFloat, this uses a method of obtaining floats from
+ * integers that introduces slight distribution-related bias.
+ *
+ * @param[in] bufSize Size of buffer in elements.
+ * @param[out] doubleBuf Buffer to fill.
+ *
+ * @throw ::AER_NULL_ARG if argument `doubleBuf` is `NULL` and argument
+ * `bufSize` is greater than `0`.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERRandGenFillDouble
+ */
+void AERRandFillDouble(size_t bufSize, double* doubleBuf);
+
+/**
+ * @brief Get a pseudorandom double floating-point value from a normal
+ * distribution using the automatically-seeded global generator.
+ *
+ * Uses the ziggurat method, which usually needs only a single underlying
+ * value and no calls to `log`, `sqrt` or trigonometric functions.
+ *
+ * @param[in] mean Mean of distribution.
+ * @param[in] stdDev Standard deviation of distribution.
+ *
+ * @return Pseudorandom double floating-point value or `0.0` if unsuccessful.
+ *
+ * @throw ::AER_BAD_VAL if argument `stdDev` is negative.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERRandGenNormal
+ */
+double AERRandNormal(double mean, double stdDev);
+
+/**
+ * @brief Get a pseudorandom double floating-point value from an exponential
+ * distribution using the automatically-seeded global generator.
+ *
+ * Uses the ziggurat method, which usually needs only a single underlying
+ * value and no calls to `log`.
+ *
+ * @param[in] rate Rate of distribution (the reciprocal of its mean).
+ *
+ * @return Pseudorandom double floating-point value or `0.0` if unsuccessful.
+ *
+ * @throw ::AER_BAD_VAL if argument `rate` is not greater than `0.0`.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERRandGenExponential
+ */
+double AERRandExponential(double rate);
+
+/**
+ * @brief Fill a buffer with pseudorandom double floating-point values from a
+ * normal distribution using the automatically-seeded global generator.
+ *
+ * @param[in] bufSize Size of buffer in elements.
+ * @param[in] mean Mean of distribution.
+ * @param[in] stdDev Standard deviation of distribution.
+ * @param[out] doubleBuf Buffer to fill.
+ *
+ * @throw ::AER_NULL_ARG if argument `doubleBuf` is `NULL` and argument
+ * `bufSize` is greater than `0`.
+ * @throw ::AER_BAD_VAL if argument `stdDev` is negative.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERRandGenFillNormal
+ */
+void AERRandFillNormal(size_t bufSize,
+                       double mean,
+                       double stdDev,
+                       double* doubleBuf);
+
+/**
+ * @brief Fill a buffer with pseudorandom double floating-point values from an
+ * exponential distribution using the automatically-seeded global generator.
+ *
+ * @param[in] bufSize Size of buffer in elements.
+ * @param[in] rate Rate of distribution (the reciprocal of its mean).
+ * @param[out] doubleBuf Buffer to fill.
+ *
+ * @throw ::AER_NULL_ARG if argument `doubleBuf` is `NULL` and argument
+ * `bufSize` is greater than `0`.
+ * @throw ::AER_BAD_VAL if argument `rate` is not greater than `0.0`.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERRandGenFillExponential
+ */
+void AERRandFillExponential(size_t bufSize, double rate, double* doubleBuf);
+
+/**
+ * @brief Allocate and build a table for making weighted choices.
+ *
+ * Building takes time proportional to the number of weights, after which each
+ * choice takes constant time, no matter how many weights there are.
+ *
+ * When no longer needed, free this table using AERRandAliasTableFree.
+ *
+ * @note Choices are very slightly biased towards some indices, by at most
+ * `numWeights / 2^32`.
+ *
+ * @param[in] numWeights Number of weights.
+ * @param[in] weights Relative weight of each index. These need not sum to
+ * `1.0`.
+ *
+ * @return Newly allocated table or `NULL` if unsuccessful.
+ *
+ * @throw ::AER_NULL_ARG if argument `weights` is `NULL`.
+ * @throw ::AER_BAD_VAL if argument `numWeights` is `0`, any weight is negative
+ * or not finite, or all weights are `0.0`.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERRandAliasTableFree
+ */
+AERRandAliasTable* AERRandAliasTableNew(size_t numWeights,
+                                        const double* weights);
+
+/**
+ * @brief Free a table for making weighted choices.
+ *
+ * @param[in] table Table of interest.
+ *
+ * @throw ::AER_NULL_ARG if argument `table` is `NULL`.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERRandAliasTableNew
+ */
+void AERRandAliasTableFree(AERRandAliasTable* table);
+
+/**
+ * @brief Make a weighted choice using the automatically-seeded global
+ * generator.
+ *
+ * @param[in] table Table of weights.
+ *
+ * @return Chosen index or `0` if unsuccessful.
+ *
+ * @throw ::AER_NULL_ARG if argument `table` is `NULL`.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERRandGenAlias
+ */
+size_t AERRandAlias(const AERRandAliasTable* table);
+
+/**
+ * @brief Fill a buffer with weighted choices using the automatically-seeded
+ * global generator.
+ *
+ * @param[in] table Table of weights.
+ * @param[in] bufSize Size of buffer in elements.
+ * @param[out] idxBuf Buffer to fill with chosen indices.
+ *
+ * @throw ::AER_NULL_ARG if argument `table` is `NULL` or argument `idxBuf` is
+ * `NULL` and argument `bufSize` is greater than `0`.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERRandGenFillAlias
+ */
+void AERRandFillAlias(const AERRandAliasTable* table,
+                      size_t bufSize,
+                      size_t* idxBuf);
+
 /**
  * @brief Allocate and initialize a new self-managed pseudorandom number
  * generator.
@@ -258,6 +684,32 @@ AERRandGen* AERRandGenNew(uint64_t seed);
  */
 void AERRandGenFree(AERRandGen* gen);
 
+/**
+ * @brief Allocate and initialize a new self-managed pseudorandom number
+ * generator whose stream is derived from a seed, a room and an instance.
+ *
+ * The same arguments always give the same stream, no matter when or on which
+ * thread the generator is created. This makes it suitable for per-instance
+ * randomness in reproducible procedural generation.
+ *
+ * When no longer needed, free this generator using AERRandGenFree.
+ *
+ * @note Streams derived from different arguments are statistically
+ * independent, but not provably non-overlapping. Use AERRandGenSplit when
+ * that guarantee is needed.
+ *
+ * @param[in] seed Base seed shared by all related streams.
+ * @param[in] roomIdx Room the stream belongs to.
+ * @param[in] instId ID of instance the stream belongs to.
+ *
+ * @return Newly allocated generator.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERRandGenSeedStream
+ */
+AERRandGen* AERRandGenNewStream(uint64_t seed, int32_t roomIdx, int32_t instId);
+
 /**
  * @brief Re-seed a self-managed pseudorandom number generator.
  *
@@ -270,6 +722,69 @@ void AERRandGenFree(AERRandGen* gen);
  */
 void AERRandGenSeed(AERRandGen* gen, uint64_t seed);
 
+/**
+ * @brief Re-seed a self-managed pseudorandom number generator with a stream
+ * derived from a seed, a room and an instance.
+ *
+ * @param[in] gen Generator of interest.
+ * @param[in] seed Base seed shared by all related streams.
+ * @param[in] roomIdx Room the stream belongs to.
+ * @param[in] instId ID of instance the stream belongs to.
+ *
+ * @throw ::AER_NULL_ARG if argument `gen` is `NULL`.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERRandGenNewStream
+ */
+void AERRandGenSeedStream(AERRandGen* gen,
+                          uint64_t seed,
+                          int32_t roomIdx,
+                          int32_t instId);
+
+/**
+ * @brief Advance a self-managed pseudorandom number generator by 2^128
+ * values.
+ *
+ * This is equivalent to 2^128 calls to AERRandGenUInt, but takes about as long
+ * as 256 of them.
+ *
+ * @param[in] gen Generator of interest.
+ *
+ * @throw ::AER_NULL_ARG if argument `gen` is `NULL`.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERRandGenSplit
+ */
+void AERRandGenJump(AERRandGen* gen);
+
+/**
+ * @brief Split a self-managed pseudorandom number generator into several
+ * new generators whose streams never overlap.
+ *
+ * Each new generator starts where the original was, after which the original
+ * is advanced using AERRandGenJump. Every new generator therefore owns a
+ * distinct run of 2^128 values, and the original continues past all of them.
+ *
+ * When no longer needed, free each new generator using AERRandGenFree.
+ *
+ * @warning Argument `genBuf` must be large enough to hold at least
+ * `bufSize` elements.
+ *
+ * @param[in] gen Generator to split.
+ * @param[in] bufSize Number of new generators to create.
+ * @param[out] genBuf Buffer to write new generators to.
+ *
+ * @throw ::AER_NULL_ARG if argument `gen` is `NULL` or argument `genBuf` is
+ * `NULL` and argument `bufSize` is greater than `0`.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERRandGenJump
+ */
+void AERRandGenSplit(AERRandGen* gen, size_t bufSize, AERRandGen** genBuf);
+
 /**
  * @brief Get a pseudorandom unsigned integer on the interval [0, 2^64) using
  * a self-managed generator.
@@ -489,4 +1004,397 @@ void AERRandGenShuffle(AERRandGen* gen,
                        size_t bufSize,
                        void* elemBuf);
 
+/**
+ * @brief Shuffle an array of 32-bit elements using a self-managed generator.
+ *
+ * Like calling AERRandGenShuffle with an element size of `4`, but without
+ * dispatching on the element size and drawing indices with a faster unbiased
+ * method. Elements need not be aligned.
+ *
+ * @note For the same generator state, the resulting permutation differs from
+ * that of AERRandGenShuffle.
+ *
+ * @param[in] gen Generator of interest.
+ * @param[in] bufSize Size of buffer in elements.
+ * @param[in,out] elemBuf Buffer of elements to shuffle.
+ *
+ * @throw ::AER_NULL_ARG if argument `gen` is `NULL` or argument `elemBuf` is
+ * `NULL` and argument `bufSize` is greater than `0`.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERRandShuffle32
+ */
+void AERRandGenShuffle32(AERRandGen* gen, size_t bufSize, void* elemBuf);
+
+/**
+ * @brief Shuffle an array of 64-bit elements using a self-managed generator.
+ *
+ * Like calling AERRandGenShuffle with an element size of `8`, but without
+ * dispatching on the element size and drawing indices with a faster unbiased
+ * method. Elements need not be aligned.
+ *
+ * @note For the same generator state, the resulting permutation differs from
+ * that of AERRandGenShuffle.
+ *
+ * @param[in] gen Generator of interest.
+ * @param[in] bufSize Size of buffer in elements.
+ * @param[in,out] elemBuf Buffer of elements to shuffle.
+ *
+ * @throw ::AER_NULL_ARG if argument `gen` is `NULL` or argument `elemBuf` is
+ * `NULL` and argument `bufSize` is greater than `0`.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERRandShuffle64
+ */
+void AERRandGenShuffle64(AERRandGen* gen, size_t bufSize, void* elemBuf);
+
+/**
+ * @brief Shuffle an array of 128-bit elements using a self-managed generator.
+ *
+ * Like calling AERRandGenShuffle with an element size of `16`, but without
+ * dispatching on the element size and drawing indices with a faster unbiased
+ * method. Elements need not be aligned.
+ *
+ * @note For the same generator state, the resulting permutation differs from
+ * that of AERRandGenShuffle.
+ *
+ * @param[in] gen Generator of interest.
+ * @param[in] bufSize Size of buffer in elements.
+ * @param[in,out] elemBuf Buffer of elements to shuffle.
+ *
+ * @throw ::AER_NULL_ARG if argument `gen` is `NULL` or argument `elemBuf` is
+ * `NULL` and argument `bufSize` is greater than `0`.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERRandShuffle128
+ */
+void AERRandGenShuffle128(AERRandGen* gen, size_t bufSize, void* elemBuf);
+
+/**
+ * @brief Shuffle an array of pointers using a self-managed generator.
+ *
+ * @param[in] gen Generator of interest.
+ * @param[in] bufSize Size of buffer in elements.
+ * @param[in,out] ptrBuf Buffer of pointers to shuffle.
+ *
+ * @throw ::AER_NULL_ARG if argument `gen` is `NULL` or argument `ptrBuf` is
+ * `NULL` and argument `bufSize` is greater than `0`.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERRandShufflePtr
+ */
+void AERRandGenShufflePtr(AERRandGen* gen, size_t bufSize, void** ptrBuf);
+
+/**
+ * @brief Choose distinct indices on the interval [0, `popSize`) using a
+ * self-managed generator.
+ *
+ * Every subset of `bufSize` indices is equally likely, and the chosen indices
+ * are written in random order. This takes time proportional to `bufSize`, not
+ * `popSize`, so it is suited to picking a few items out of many.
+ *
+ * @param[in] gen Generator of interest.
+ * @param[in] bufSize Number of indices to choose.
+ * @param[in] popSize Number of indices to choose from.
+ * @param[out] idxBuf Buffer to write chosen indices to.
+ *
+ * @throw ::AER_NULL_ARG if argument `gen` is `NULL` or argument `idxBuf` is
+ * `NULL` and argument `bufSize` is greater than `0`.
+ * @throw ::AER_BAD_VAL if argument `bufSize` is greater than argument
+ * `popSize`.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERRandSample
+ */
+void AERRandGenSample(AERRandGen* gen,
+                      size_t bufSize,
+                      size_t popSize,
+                      size_t* idxBuf);
+
+/**
+ * @brief Choose distinct instances of an object in the current room using a
+ * self-managed generator.
+ *
+ * Instances are chosen with reservoir sampling in a single pass over the
+ * room's instance lists, without first copying every instance. Every subset
+ * is equally likely, and the chosen instances are written in random order.
+ *
+ * @note If there are fewer instances than argument `bufSize`, then every
+ * instance is written.
+ *
+ * @param[in] gen Generator of interest.
+ * @param[in] objIdx Object to choose instances of.
+ * @param[in] recursive Whether to choose from instances of given object only
+ * (`false`) or both given object and direct and indirect children of given
+ * object (`true`).
+ * @param[in] bufSize Maximum number of instances to choose.
+ * @param[out] instBuf Buffer to write chosen instances to.
+ *
+ * @return Total number of instances of object in current room or `0` if
+ * unsuccessful.
+ *
+ * @throw ::AER_SEQ_BREAK if called outside action stage.
+ * @throw ::AER_NULL_ARG if argument `gen` is `NULL` or argument `instBuf` is
+ * `NULL` and argument `bufSize` is greater than `0`.
+ * @throw ::AER_FAILED_LOOKUP if argument `objIdx` is an invalid object.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERRandSampleInstances
+ */
+size_t AERRandGenSampleInstances(AERRandGen* gen,
+                                 int32_t objIdx,
+                                 bool recursive,
+                                 size_t bufSize,
+                                 AERInstance** instBuf);
+
+/**
+ * @brief Fill a buffer with pseudorandom unsigned integers on the interval
+ * [0, 2^64) using a self-managed generator.
+ *
+ * Large buffers are filled by several interleaved generators, which are
+ * seeded from the given generator, so the result depends only on the
+ * generator's state and `bufSize`. This is much faster than repeated calls to
+ * AERRandGenUInt, but does not produce the same sequence.
+ *
+ * @note The interleaved generators are SIMD lanes advanced together within
+ * this one call, not threads. Calls sharing a generator must still not run
+ * concurrently.
+ *
+ * @param[in] gen Generator of interest.
+ * @param[in] bufSize Size of buffer in elements.
+ * @param[out] uintBuf Buffer to fill.
+ *
+ * @throw ::AER_NULL_ARG if argument `gen` is `NULL`.
+ * @throw ::AER_NULL_ARG if argument `uintBuf` is `NULL` and argument
+ * `bufSize` is greater than `0`.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERRandFillUInt
+ */
+void AERRandGenFillUInt(AERRandGen* gen, size_t bufSize, uint64_t* uintBuf);
+
+/**
+ * @brief Fill a buffer with pseudorandom floating-point values on the interval
+ * [0.0f, 1.0f) using a self-managed generator.
+ *
+ * Large buffers are filled by several interleaved generators, which are
+ * seeded from the given generator, so the result depends only on the
+ * generator's state and `bufSize`. This is much faster than repeated calls to
+ * AERRandGenFloat, but does not produce the same sequence.
+ *
+ * @note The interleaved generators are SIMD lanes advanced together within
+ * this one call, not threads. Calls sharing a generator must still not run
+ * concurrently.
+ *
+ * @bug Like ::AERRandFloat, this uses a method of obtaining floats from
+ * integers that introduces slight distribution-related bias.
+ *
+ * @param[in] gen Generator of interest.
+ * @param[in] bufSize Size of buffer in elements.
+ * @param[out] floatBuf Buffer to fill.
+ *
+ * @throw ::AER_NULL_ARG if argument `gen` is `NULL`.
+ * @throw ::AER_NULL_ARG if argument `floatBuf` is `NULL` and argument
+ * `bufSize` is greater than `0`.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERRandFillFloat
+ */
+void AERRandGenFillFloat(AERRandGen* gen, size_t bufSize, float* floatBuf);
+
+/**
+ * @brief Fill a buffer with pseudorandom floating-point values on the interval
+ * [min, max) using a self-managed generator.
+ *
+ * Large buffers are filled by several interleaved generators, which are
+ * seeded from the given generator, so the result depends only on the
+ * generator's state and `bufSize`. This is much faster than repeated calls to
+ * AERRandGenFloatRange, but does not produce the same sequence.
+ *
+ * @note The interleaved generators are SIMD lanes advanced together within
+ * this one call, not threads. Calls sharing a generator must still not run
+ * concurrently.
+ *
+ * @bug Like ::AERRandFloat, this uses a method of obtaining floats from
+ * integers that introduces slight distribution-related bias.
+ *
+ * @param[in] gen Generator of interest.
+ * @param[in] bufSize Size of buffer in elements.
+ * @param[in] min Minimum possible value (inclusive).
+ * @param[in] max Maximum possible value (exclusive).
+ * @param[out] floatBuf Buffer to fill.
+ *
+ * @throw ::AER_NULL_ARG if argument `gen` is `NULL`.
+ * @throw ::AER_NULL_ARG if argument `floatBuf` is `NULL` and argument
+ * `bufSize` is greater than `0`.
+ * @throw ::AER_BAD_VAL if argument `min` is greater than or equal to
+ * argument `max`.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERRandFillFloatRange
+ */
+void AERRandGenFillFloatRange(AERRandGen* gen,
+                              size_t bufSize,
+                              float min,
+                              float max,
+                              float* floatBuf);
+
+/**
+ * @brief Fill a buffer with pseudorandom double floating-point values on the
+ * interval [0.0, 1.0) using a self-managed generator.
+ *
+ * Large buffers are filled by several interleaved generators, which are
+ * seeded from the given generator, so the result depends only on the
+ * generator's state and `bufSize`. This is much faster than repeated calls to
+ * AERRandGenDouble, but does not produce the same sequence.
+ *
+ * @note The interleaved generators are SIMD lanes advanced together within
+ * this one call, not threads. Calls sharing a generator must still not run
+ * concurrently.
+ *
+ * @bug Like ::AERRandFloat, this uses a method of obtaining floats from
+ * integers that introduces slight distribution-related bias.
+ *
+ * @param[in] gen Generator of interest.
+ * @param[in] bufSize Size of buffer in elements.
+ * @param[out] doubleBuf Buffer to fill.
+ *
+ * @throw ::AER_NULL_ARG if argument `gen` is `NULL`.
+ * @throw ::AER_NULL_ARG if argument `doubleBuf` is `NULL` and argument
+ * `bufSize` is greater than `0`.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERRandFillDouble
+ */
+void AERRandGenFillDouble(AERRandGen* gen, size_t bufSize, double* doubleBuf);
+
+/**
+ * @brief Get a pseudorandom double floating-point value from a normal
+ * distribution using a self-managed generator.
+ *
+ * @param[in] gen Generator of interest.
+ * @param[in] mean Mean of distribution.
+ * @param[in] stdDev Standard deviation of distribution.
+ *
+ * @return Pseudorandom double floating-point value or `0.0` if unsuccessful.
+ *
+ * @throw ::AER_NULL_ARG if argument `gen` is `NULL`.
+ * @throw ::AER_BAD_VAL if argument `stdDev` is negative.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERRandNormal
+ */
+double AERRandGenNormal(AERRandGen* gen, double mean, double stdDev);
+
+/**
+ * @brief Get a pseudorandom double floating-point value from an exponential
+ * distribution using a self-managed generator.
+ *
+ * @param[in] gen Generator of interest.
+ * @param[in] rate Rate of distribution (the reciprocal of its mean).
+ *
+ * @return Pseudorandom double floating-point value or `0.0` if unsuccessful.
+ *
+ * @throw ::AER_NULL_ARG if argument `gen` is `NULL`.
+ * @throw ::AER_BAD_VAL if argument `rate` is not greater than `0.0`.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERRandExponential
+ */
+double AERRandGenExponential(AERRandGen* gen, double rate);
+
+/**
+ * @brief Fill a buffer with pseudorandom double floating-point values from a
+ * normal distribution using a self-managed generator.
+ *
+ * @param[in] gen Generator of interest.
+ * @param[in] bufSize Size of buffer in elements.
+ * @param[in] mean Mean of distribution.
+ * @param[in] stdDev Standard deviation of distribution.
+ * @param[out] doubleBuf Buffer to fill.
+ *
+ * @throw ::AER_NULL_ARG if argument `gen` is `NULL` or argument `doubleBuf` is
+ * `NULL` and argument `bufSize` is greater than `0`.
+ * @throw ::AER_BAD_VAL if argument `stdDev` is negative.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERRandFillNormal
+ */
+void AERRandGenFillNormal(AERRandGen* gen,
+                          size_t bufSize,
+                          double mean,
+                          double stdDev,
+                          double* doubleBuf);
+
+/**
+ * @brief Fill a buffer with pseudorandom double floating-point values from an
+ * exponential distribution using a self-managed generator.
+ *
+ * @param[in] gen Generator of interest.
+ * @param[in] bufSize Size of buffer in elements.
+ * @param[in] rate Rate of distribution (the reciprocal of its mean).
+ * @param[out] doubleBuf Buffer to fill.
+ *
+ * @throw ::AER_NULL_ARG if argument `gen` is `NULL` or argument `doubleBuf` is
+ * `NULL` and argument `bufSize` is greater than `0`.
+ * @throw ::AER_BAD_VAL if argument `rate` is not greater than `0.0`.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERRandFillExponential
+ */
+void AERRandGenFillExponential(AERRandGen* gen,
+                               size_t bufSize,
+                               double rate,
+                               double* doubleBuf);
+
+/**
+ * @brief Make a weighted choice using a self-managed generator.
+ *
+ * @param[in] gen Generator of interest.
+ * @param[in] table Table of weights.
+ *
+ * @return Chosen index or `0` if unsuccessful.
+ *
+ * @throw ::AER_NULL_ARG if argument `gen` or `table` is `NULL`.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERRandAlias
+ */
+size_t AERRandGenAlias(AERRandGen* gen, const AERRandAliasTable* table);
+
+/**
+ * @brief Fill a buffer with weighted choices using a self-managed generator.
+ *
+ * @param[in] gen Generator of interest.
+ * @param[in] table Table of weights.
+ * @param[in] bufSize Size of buffer in elements.
+ * @param[out] idxBuf Buffer to fill with chosen indices.
+ *
+ * @throw ::AER_NULL_ARG if argument `gen` or `table` is `NULL` or argument
+ * `idxBuf` is `NULL` and argument `bufSize` is greater than `0`.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERRandFillAlias
+ */
+void AERRandGenFillAlias(AERRandGen* gen,
+                         const AERRandAliasTable* table,
+                         size_t bufSize,
+                         size_t* idxBuf);
+
 #endif /* AER_RAND_H */
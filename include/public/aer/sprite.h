@@ -3462,9 +3462,62 @@ int32_t AERSpriteRegister(const char* name,
                           uint32_t origX,
                           uint32_t origY);
 
+/**
+ * @brief Register every sprite of a sprite atlas.
+ *
+ * @subsubsection SpriteAtlases Sprite Atlases
+ *
+ * A sprite atlas is a handful of texture pages that many sprites were packed
+ * into, together with a manifest recording where each frame of each sprite
+ * is. The `aeratlaspack` tool which ships with the MRE creates both from the
+ * same images that would be passed to ::AERSpriteRegister. Drawing sprites
+ * which share a page back to back does not require switching textures, so a
+ * mod that registers its sprites as one atlas instead of one by one usually
+ * draws faster (see ::AERDrawStats::numTextureSwitches).
+ *
+ * Each sprite of the atlas is registered under its own name and index with
+ * the size and origin given in the manifest, and can be queried and drawn
+ * like any other sprite. The indices of the sprites are consecutive in the
+ * order of the manifest, but they are not counted by
+ * ::AERSpriteGetNumRegistered. Packed sprites may not be assigned to
+ * instances or objects, nor replaced using ::AERSpriteReplace.
+ *
+ * @param[in] filename Path to atlas manifest relative to asset directory.
+ *
+ * @return Number of sprites registered or `0` if unsuccessful.
+ *
+ * @throw ::AER_NULL_ARG if argument `filename` is `NULL`.
+ * @throw ::AER_SEQ_BREAK if called outside sprite registration stage.
+ * @throw ::AER_BAD_FILE if argument `filename` does not point to a file, one
+ * of the pages of the atlas could not be loaded or a frame lies outside of its
+ * page.
+ * @throw ::AER_FAILED_PARSE if the manifest is malformed.
+ * @throw ::AER_BAD_VAL if the name of a sprite in the atlas is already in use
+ * by another sprite.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERSpriteRegister
+ * @sa AERSpriteGetByName
+ */
+size_t AERSpriteRegisterAtlas(const char* filename);
+
 /**
  * @brief Override a vanilla sprite with a custom sprite.
  *
+ * @note Since 1.6.0 the file is validated before the sprite is replaced,
+ * rather than the replacement failing silently.
+ *
+ * @note If the option `load.lazy_sprite_replace` is enabled, the file is only
+ * loaded once the sprite is first used by a mod or an instance, or at the next
+ * room change. An instance which starts using the sprite mid-room may be drawn
+ * with the vanilla sprite for up to one step. If the option
+ * `load.prefetch_sprites_per_room` is nonzero, at most that many unused
+ * replacements are applied per room change instead of all of them, so sprites
+ * the game draws other than through instances may stay vanilla for longer.
+ * Until the replacement is applied, querying the sprite's frames, size or
+ * origin reports those of the replacement.
+ *
  * @bug The coordinates defining the origin of a sprite may be negative despite
  * the fact that both arguments `origX` and `origY` are unsigned. They are being
  * left as unsigned to preserve API compatibility. To pass a negative value for
@@ -3481,6 +3534,7 @@ int32_t AERSpriteRegister(const char* name,
  * @throw ::AER_SEQ_BREAK if called outside sprite registration stage.
  * @throw ::AER_NULL_ARG if argument `filename` is `NULL`.
  * @throw ::AER_BAD_VAL if argument `numFrames` is less than `1`.
+ * @throw ::AER_BAD_FILE if argument `filename` does not point to valid file.
  *
  * @since 1.0.0
  *
@@ -3596,4 +3650,64 @@ void AERSpriteGetOrigin(int32_t spriteIdx, int32_t* x, int32_t* y);
  */
 void AERSpriteSetOrigin(int32_t spriteIdx, int32_t x, int32_t y);
 
+/**
+ * @brief Build a pixel collision mask for a sprite.
+ *
+ * Masks are built from the image files of mod sprites, atlas sprites and
+ * replaced vanilla sprites once sprite registration ends. A replacement which
+ * is deferred gets its mask when it is applied. Building a mask decodes the
+ * whole image, so only sprites that are tested with ::AERSpriteMasksOverlap
+ * or ::AERInstanceMasksOverlap need one.
+ *
+ * @param[in] spriteIdx Sprite of interest.
+ *
+ * @throw ::AER_SEQ_BREAK if called outside sprite registration stage.
+ * @throw ::AER_FAILED_LOOKUP if argument `spriteIdx` is an invalid sprite.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERSpriteMasksOverlap
+ */
+void AERSpriteEnableMask(int32_t spriteIdx);
+
+/**
+ * @brief Query whether or not the opaque pixels of two sprite frames overlap.
+ *
+ * Each frame is placed with its origin at the given position, rounded down to
+ * whole pixels. A pixel is opaque unless it is fully transparent.
+ *
+ * Only sprites passed to ::AERSpriteEnableMask are tested pixel by pixel.
+ * Other sprites (or any whose image cannot be read) are treated as solid
+ * rectangles, as are replaced sprites whose replacement is still deferred.
+ *
+ * @param[in] spriteIdxA First sprite.
+ * @param[in] frameA Frame of first sprite.
+ * @param[in] xA Horizontal position of first sprite.
+ * @param[in] yA Vertical position of first sprite.
+ * @param[in] spriteIdxB Second sprite.
+ * @param[in] frameB Frame of second sprite.
+ * @param[in] xB Horizontal position of second sprite.
+ * @param[in] yB Vertical position of second sprite.
+ *
+ * @return Whether or not the frames overlap or `false` if unsuccessful.
+ *
+ * @throw ::AER_SEQ_BREAK if called before end of sprite registration stage.
+ * @throw ::AER_FAILED_LOOKUP if argument `spriteIdxA` or `spriteIdxB` is an
+ * invalid sprite.
+ * @throw ::AER_BAD_VAL if argument `frameA` or `frameB` is greater than or
+ * equal to the number of frames of its sprite.
+ *
+ * @since 1.6.0
+ *
+ * @sa AERInstanceMasksOverlap
+ */
+bool AERSpriteMasksOverlap(int32_t spriteIdxA,
+                           uint32_t frameA,
+                           float xA,
+                           float yA,
+                           int32_t spriteIdxB,
+                           uint32_t frameB,
+                           float xB,
+                           float yB);
+
 #endif /* AER_SPRITE_H */
@@ -0,0 +1,373 @@
+/**
+ * @copyright 2021 the libaermre authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <assert.h>
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/stat.h>
+#include <time.h>
+
+#include "foxutils/stringmapmacs.h"
+
+#include "internal/asset.h"
+#include "internal/core.h"
+#include "internal/job.h"
+#include "internal/log.h"
+#include "internal/mod.h"
+#include "internal/option.h"
+
+/* ----- PRIVATE TYPES ----- */
+
+typedef enum AssetKind {
+    ASSET_OTHER,
+    ASSET_IMAGE,
+    ASSET_FONT,
+} AssetKind;
+
+/* Only its own prescan job writes to an asset until that job is waited on. */
+typedef struct Asset {
+    char* path;
+    AssetKind kind;
+    size_t size;
+    uint32_t width;
+    uint32_t height;
+    /* Why the asset is invalid, or `NULL` if it is valid. */
+    const char* problem;
+} Asset;
+
+/* ----- PRIVATE CONSTANTS ----- */
+
+static const uint8_t PNG_SIGNATURE[8] = {0x89, 'P',  'N',  'G',
+                                         '\r', '\n', 0x1a, '\n'};
+
+static const char* FONT_TABLES[] = {"cmap", "head", "hhea", "hmtx"};
+
+/* ----- PRIVATE GLOBALS ----- */
+
+static Asset* assets = NULL;
+
+static size_t numAssets = 0;
+
+static FoxMap assetIdxs = {0};
+
+static uint32_t crcTable[256];
+
+/* ----- PRIVATE FUNCTIONS ----- */
+
+static inline uint32_t ReadU32(const uint8_t* data) {
+    return ((uint32_t)data[0] << 24) | ((uint32_t)data[1] << 16) |
+           ((uint32_t)data[2] << 8) | data[3];
+}
+
+static inline uint16_t ReadU16(const uint8_t* data) {
+    return (uint16_t)((data[0] << 8) | data[1]);
+}
+
+static uint32_t Crc32(const uint8_t* data, size_t size) {
+    uint32_t crc = 0xffffffff;
+    for (size_t idx = 0; idx < size; idx++)
+        crc = crcTable[(crc ^ data[idx]) & 0xff] ^ (crc >> 8);
+
+    return ~crc;
+}
+
+static AssetKind GetAssetKind(const char* path) {
+    const char* ext = strrchr(path, '.');
+    if (!ext || strchr(ext, '/'))
+        return ASSET_OTHER;
+    if (strcasecmp(ext, ".png") == 0)
+        return ASSET_IMAGE;
+    if (strcasecmp(ext, ".ttf") == 0 || strcasecmp(ext, ".otf") == 0)
+        return ASSET_FONT;
+
+    return ASSET_OTHER;
+}
+
+/*
+ * Walks every chunk rather than just the header, so that truncated files are
+ * caught as well.
+ */
+static const char* CheckImage(const uint8_t* data,
+                              size_t size,
+                              uint32_t* width,
+                              uint32_t* height) {
+    if (size < 33 || memcmp(data, PNG_SIGNATURE, 8) != 0)
+        return "not a PNG image";
+    if (ReadU32(data + 8) != 13 || memcmp(data + 12, "IHDR", 4) != 0 ||
+        Crc32(data + 12, 17) != ReadU32(data + 29))
+        return "corrupt PNG header";
+    *width = ReadU32(data + 16);
+    *height = ReadU32(data + 20);
+    if (*width == 0 || *height == 0)
+        return "image has no pixels";
+
+    bool hasData = false;
+    size_t pos = 33;
+    while (size - pos >= 12) {
+        uint32_t length = ReadU32(data + pos);
+        if (length > size - pos - 12)
+            break;
+        const uint8_t* type = data + pos + 4;
+        if (memcmp(type, "IEND", 4) == 0)
+            return hasData ? NULL : "image has no pixel data";
+        hasData |= (memcmp(type, "IDAT", 4) == 0);
+        pos += (size_t)length + 12;
+    }
+
+    return "truncated PNG image";
+}
+
+static const char* CheckFont(const uint8_t* data, size_t size) {
+    if (size < 12)
+        return "not a TrueType or OpenType font";
+    uint32_t version = ReadU32(data);
+    if (version != 0x00010000 && version != 0x74727565 /* true */ &&
+        version != 0x4f54544f /* OTTO */)
+        return "not a TrueType or OpenType font";
+
+    uint32_t numTables = ReadU16(data + 4);
+    if (12 + 16 * (size_t)numTables > size)
+        return "truncated font table directory";
+
+    uint32_t found = 0;
+    for (uint32_t idx = 0; idx < numTables; idx++) {
+        const uint8_t* record = data + 12 + 16 * idx;
+        uint32_t offset = ReadU32(record + 8);
+        uint32_t length = ReadU32(record + 12);
+        if (offset > size || length > size - offset)
+            return "truncated font table";
+        for (uint32_t tableIdx = 0;
+             tableIdx < sizeof(FONT_TABLES) / sizeof(const char*);
+             tableIdx++) {
+            if (memcmp(record, FONT_TABLES[tableIdx], 4) == 0)
+                found |= 1u << tableIdx;
+        }
+    }
+    if (found != (1u << (sizeof(FONT_TABLES) / sizeof(const char*))) - 1)
+        return "font is missing required tables";
+
+    return NULL;
+}
+
+/*
+ * Reads all of the asset, which also leaves it in the page cache for when the
+ * engine loads it during registration.
+ */
+static void ValidateAsset(Asset* asset) {
+    asset->problem = NULL;
+
+    FILE* file = fopen(asset->path, "rb");
+    if (!file) {
+        asset->problem = "could not open file";
+        return;
+    }
+    uint8_t* data = NULL;
+    long size = -1;
+    if (fseek(file, 0, SEEK_END) == 0 && (size = ftell(file)) >= 0 &&
+        fseek(file, 0, SEEK_SET) == 0) {
+        data = malloc(size ? (size_t)size : 1);
+        assert(data);
+        if (fread(data, 1, (size_t)size, file) != (size_t)size)
+            size = -1;
+    }
+    fclose(file);
+    if (size < 0) {
+        free(data);
+        asset->problem = "could not read file";
+        return;
+    }
+    asset->size = (size_t)size;
+
+    switch (asset->kind) {
+        case ASSET_IMAGE:
+            asset->problem =
+                CheckImage(data, asset->size, &asset->width, &asset->height);
+            break;
+        case ASSET_FONT:
+            asset->problem = CheckFont(data, asset->size);
+            break;
+        default:
+            break;
+    }
+    free(data);
+
+    return;
+}
+
+static void PrescanAsset(void* arg) {
+    ValidateAsset(arg);
+
+    return;
+}
+
+static void AddAsset(const char* path, AssetKind kind) {
+    assets = realloc(assets, (numAssets + 1) * sizeof(Asset));
+    assert(assets);
+
+    size_t pathSize = strlen(path) + 1;
+    Asset* asset = assets + numAssets;
+    *asset = (Asset){.path = malloc(pathSize), .kind = kind};
+    assert(asset->path);
+    memcpy(asset->path, path, pathSize);
+    *FoxMapMInsert(const char*, size_t, &assetIdxs, asset->path) = numAssets++;
+
+    return;
+}
+
+/* Adds every image and font below a directory. */
+static void FindAssets(const char* dirPath) {
+    DIR* dir = opendir(dirPath);
+    if (!dir)
+        return;
+
+    struct dirent* entry;
+    while ((entry = readdir(dir))) {
+        if (entry->d_name[0] == '.')
+            continue;
+
+        size_t pathSize = strlen(dirPath) + strlen(entry->d_name) + 2;
+        char* path = malloc(pathSize);
+        assert(path);
+        snprintf(path, pathSize, "%s%s%s", dirPath,
+                 (dirPath[strlen(dirPath) - 1] == '/') ? "" : "/",
+                 entry->d_name);
+
+        /* Don't follow links to directories, which could loop. */
+        struct stat info;
+        AssetKind kind = GetAssetKind(path);
+        if (lstat(path, &info) == 0 && S_ISDIR(info.st_mode)) {
+            FindAssets(path);
+        } else if (kind != ASSET_OTHER && stat(path, &info) == 0 &&
+                   S_ISREG(info.st_mode) &&
+                   !FoxMapMIndex(const char*, size_t, &assetIdxs, path)) {
+            AddAsset(path, kind);
+        }
+        free(path);
+    }
+    closedir(dir);
+
+    return;
+}
+
+/* ----- INTERNAL FUNCTIONS ----- */
+
+void AssetManPrescan(void) {
+    if (!opts.assetPrescan)
+        return;
+
+    LogInfo("Prescanning mod assets...");
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    size_t numMods = ModManGetNumMods();
+    for (uint32_t modIdx = 0; modIdx < numMods; modIdx++) {
+        char* dirPath = strdup(CoreGetAbsAssetPath(ModManGetMod(modIdx)->name,
+                                                   ""));
+        assert(dirPath);
+        FindAssets(dirPath);
+        free(dirPath);
+    }
+
+    /* The array no longer moves, so jobs can write to their asset. */
+    uint64_t* jobs = malloc(numAssets * sizeof(uint64_t));
+    assert(jobs || numAssets == 0);
+    for (uint32_t idx = 0; idx < numAssets; idx++)
+        jobs[idx] = JobManSubmit(PrescanAsset, assets + idx, MOD_NULL);
+    for (uint32_t idx = 0; idx < numAssets; idx++)
+        JobManWait(jobs[idx]);
+    free(jobs);
+
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double elapsedMs = (end.tv_sec - start.tv_sec) * 1000.0 +
+                       (end.tv_nsec - start.tv_nsec) / 1000000.0;
+
+    size_t numProblems = 0;
+    size_t numBytes = 0;
+    for (uint32_t idx = 0; idx < numAssets; idx++) {
+        numProblems += (assets[idx].problem != NULL);
+        numBytes += assets[idx].size;
+    }
+    if (numProblems > 0) {
+        LogWarn("Found %zu invalid mod asset(s):", numProblems);
+        for (uint32_t idx = 0; idx < numAssets; idx++) {
+            if (assets[idx].problem)
+                LogWarn("\"%s\": %s.", assets[idx].path, assets[idx].problem);
+        }
+    }
+
+    LogInfo("Done. Prescanned %zu asset(s) (%.1f MiB) in %.1f ms.", numAssets,
+            numBytes / (1024.0 * 1024.0), elapsedMs);
+    return;
+}
+
+/*
+ * Files that were not prescanned (or which are neither images nor fonts) are
+ * validated now.
+ */
+bool AssetManValidate(const char* path, uint32_t* width, uint32_t* height) {
+    assert(path);
+
+    Asset* asset = NULL;
+    Asset tmpAsset;
+    size_t* assetIdx = FoxMapMIndex(const char*, size_t, &assetIdxs, path);
+    if (assetIdx) {
+        asset = assets + *assetIdx;
+    } else {
+        tmpAsset = (Asset){.path = (char*)path, .kind = GetAssetKind(path)};
+        asset = &tmpAsset;
+        ValidateAsset(asset);
+    }
+
+    if (width)
+        *width = asset->width;
+    if (height)
+        *height = asset->height;
+
+    return !asset->problem;
+}
+
+void AssetManConstructor(void) {
+    LogInfo("Initializing asset module...");
+
+    FoxStringMapMInit(size_t, &assetIdxs);
+    for (uint32_t idx = 0; idx < 256; idx++) {
+        uint32_t crc = idx;
+        for (uint32_t bit = 0; bit < 8; bit++)
+            crc = (crc & 1) ? 0xedb88320 ^ (crc >> 1) : crc >> 1;
+        crcTable[idx] = crc;
+    }
+
+    LogInfo("Done initializing asset module.");
+    return;
+}
+
+void AssetManDestructor(void) {
+    LogInfo("Deinitializing asset module...");
+
+    FoxMapMDeinit(const char*, size_t, &assetIdxs);
+    assetIdxs = (FoxMap){0};
+    for (uint32_t idx = 0; idx < numAssets; idx++)
+        free(assets[idx].path);
+    free(assets);
+    assets = NULL;
+    numAssets = 0;
+
+    LogInfo("Done deinitializing asset module.");
+    return;
+}
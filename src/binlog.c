@@ -0,0 +1,567 @@
+/**
+ * @copyright 2021 the libaermre authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <assert.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "foxutils/mapmacs.h"
+#include "foxutils/stringmapmacs.h"
+
+#include "internal/binlog.h"
+#include "internal/log.h"
+#include "internal/mod.h"
+#include "internal/option.h"
+
+/* ----- PRIVATE MACROS ----- */
+
+#define MAX_FORMAT_ARGS 32
+
+#define FORMAT_CACHE_SIZE 128
+
+#define MODULE_CACHE_SIZE 16
+
+/* ----- PRIVATE TYPES ----- */
+
+typedef enum BinLogArgType {
+    ARG_INT,
+    ARG_LONG,
+    ARG_LLONG,
+    ARG_INTMAX,
+    ARG_SIZE,
+    ARG_PTRDIFF,
+    ARG_DOUBLE,
+    ARG_STR,
+    ARG_PTR
+} BinLogArgType;
+
+typedef struct BinLogFormat {
+    char* fmt;
+    uint32_t id;
+    bool deferrable;
+    uint8_t numArgs;
+    uint8_t argTypes[MAX_FORMAT_ARGS];
+} BinLogFormat;
+
+typedef struct FormatCacheEntry {
+    const char* fmt;
+    BinLogFormat* format;
+} FormatCacheEntry;
+
+typedef struct ModuleCacheEntry {
+    const char* name;
+    uint32_t id;
+    uint32_t generation;
+} ModuleCacheEntry;
+
+typedef struct BinLogModule {
+    char* name;
+    uint32_t id;
+} BinLogModule;
+
+/* ----- PRIVATE GLOBALS ----- */
+
+static bool isOpen = false;
+
+static int fileFd = -1;
+
+static uint8_t* fileMem = NULL;
+
+static uint32_t capacity = 0;
+
+static uint32_t writeOffset = 0;
+
+static uint32_t numDropped = 0;
+
+/* Guards format and module registration. */
+static pthread_mutex_t registryMutex = PTHREAD_MUTEX_INITIALIZER;
+
+/* Keyed by content. Formats are never freed before the log is closed. */
+static FoxMap formats = {0};
+
+static FoxMap modules = {0};
+
+static uint32_t numFormats = 0;
+
+static uint32_t numModules = 0;
+
+static __thread FormatCacheEntry formatCache[FORMAT_CACHE_SIZE];
+
+static __thread ModuleCacheEntry moduleCache[MODULE_CACHE_SIZE];
+
+static __thread uint8_t stagingBuf[8 * 1024];
+
+/* ----- PRIVATE FUNCTIONS ----- */
+
+static bool PushArgType(BinLogFormat* format, BinLogArgType type) {
+    if (format->numArgs == MAX_FORMAT_ARGS)
+        return false;
+    format->argTypes[format->numArgs++] = type;
+
+    return true;
+}
+
+/*
+ * Work out the argument types of a `printf` format string. Anything this
+ * doesn't understand (such as `%n`, `%Lf` or wide strings) makes the format
+ * non-deferrable, in which case messages are formatted up front.
+ */
+static bool ParseFormat(BinLogFormat* format) {
+    const char* cur = format->fmt;
+    while (*cur) {
+        if (*cur++ != '%')
+            continue;
+        if (*cur == '%') {
+            cur++;
+            continue;
+        }
+
+        /* Flags. */
+        while (*cur && strchr("-+ #0'", *cur))
+            cur++;
+
+        /* Width. */
+        if (*cur == '*') {
+            if (!PushArgType(format, ARG_INT))
+                return false;
+            cur++;
+        } else {
+            while (*cur >= '0' && *cur <= '9')
+                cur++;
+        }
+
+        /* Precision. */
+        if (*cur == '.') {
+            cur++;
+            if (*cur == '*') {
+                if (!PushArgType(format, ARG_INT))
+                    return false;
+                cur++;
+            } else {
+                while (*cur >= '0' && *cur <= '9')
+                    cur++;
+            }
+        }
+
+        /* Length. */
+        BinLogArgType intType = ARG_INT;
+        bool isLong = false;
+        bool isLongDouble = false;
+        switch (*cur) {
+            case 'h':
+                cur += (cur[1] == 'h') ? 2 : 1;
+                break;
+            case 'l':
+                if (cur[1] == 'l') {
+                    intType = ARG_LLONG;
+                    cur += 2;
+                } else {
+                    intType = ARG_LONG;
+                    isLong = true;
+                    cur++;
+                }
+                break;
+            case 'q':
+                intType = ARG_LLONG;
+                cur++;
+                break;
+            case 'j':
+                intType = ARG_INTMAX;
+                cur++;
+                break;
+            case 'z':
+                intType = ARG_SIZE;
+                cur++;
+                break;
+            case 't':
+                intType = ARG_PTRDIFF;
+                cur++;
+                break;
+            case 'L':
+                isLongDouble = true;
+                cur++;
+                break;
+            default:
+                break;
+        }
+
+        /* Conversion. */
+        switch (*cur++) {
+            case 'c':
+                if (isLong)
+                    return false;
+                /* Fallthrough. */
+            case 'd':
+            case 'i':
+            case 'u':
+            case 'o':
+            case 'x':
+            case 'X':
+                if (isLongDouble || !PushArgType(format, intType))
+                    return false;
+                break;
+
+            case 'e':
+            case 'E':
+            case 'f':
+            case 'F':
+            case 'g':
+            case 'G':
+            case 'a':
+            case 'A':
+                if (isLongDouble || !PushArgType(format, ARG_DOUBLE))
+                    return false;
+                break;
+
+            case 's':
+                if (isLong || !PushArgType(format, ARG_STR))
+                    return false;
+                break;
+
+            case 'p':
+                if (!PushArgType(format, ARG_PTR))
+                    return false;
+                break;
+
+            default:
+                return false;
+        }
+    }
+
+    return true;
+}
+
+static uint8_t* Reserve(uint32_t size) {
+    uint32_t offset = __atomic_load_n(&writeOffset, __ATOMIC_RELAXED);
+    do {
+        if (size > capacity - offset) {
+            uint32_t dropped =
+                __atomic_add_fetch(&numDropped, 1, __ATOMIC_RELAXED);
+            ((BinLogHeader*)fileMem)->numDropped = dropped;
+            return NULL;
+        }
+    } while (!__atomic_compare_exchange_n(&writeOffset, &offset,
+                                          offset + size, true,
+                                          __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+    return fileMem + offset;
+}
+
+/* Fill in a record header once its body is written, publishing the record. */
+static void Publish(uint8_t* dest,
+                    BinLogKind kind,
+                    LogLevel logLvl,
+                    uint32_t size) {
+    BinLogRecordHeader* header = (BinLogRecordHeader*)dest;
+    header->level = logLvl;
+    header->reserved = 0;
+    header->size = size;
+    __atomic_store_n(&header->kind, kind, __ATOMIC_RELEASE);
+
+    return;
+}
+
+/* Must be called with `registryMutex` held. */
+static void WriteNamedRecord(BinLogKind kind, uint32_t id, const char* name) {
+    /* Format and module records share a layout. */
+    size_t nameSize = strlen(name) + 1;
+    uint32_t size = sizeof(BinLogFormatRecord) + nameSize;
+    uint8_t* dest = Reserve(size);
+    if (!dest)
+        return;
+
+    ((BinLogFormatRecord*)dest)->formatId = id;
+    memcpy(dest + sizeof(BinLogFormatRecord), name, nameSize);
+    Publish(dest, kind, LOG_INFO, size);
+
+    return;
+}
+
+/*
+ * Mods may build formats in reused buffers, so a cache hit by address must
+ * still match by content. Cached formats stay valid until the log is closed.
+ */
+static BinLogFormat* GetFormat(const char* fmt) {
+    FormatCacheEntry* entry =
+        formatCache + ((uintptr_t)fmt >> 2) % FORMAT_CACHE_SIZE;
+    if (entry->fmt == fmt && strcmp(entry->format->fmt, fmt) == 0)
+        return entry->format;
+
+    pthread_mutex_lock(&registryMutex);
+
+    BinLogFormat** format =
+        FoxMapMIndex(const char*, BinLogFormat*, &formats, fmt);
+    if (!format) {
+        BinLogFormat* newFormat = malloc(sizeof(BinLogFormat));
+        assert(newFormat);
+        newFormat->fmt = strdup(fmt);
+        assert(newFormat->fmt);
+        newFormat->id = numFormats++;
+        newFormat->numArgs = 0;
+        newFormat->deferrable = ParseFormat(newFormat);
+        format = FoxMapMInsert(const char*, BinLogFormat*, &formats,
+                               newFormat->fmt);
+        *format = newFormat;
+        WriteNamedRecord(BINLOG_FORMAT, newFormat->id, newFormat->fmt);
+    }
+    BinLogFormat* result = *format;
+
+    pthread_mutex_unlock(&registryMutex);
+
+    entry->fmt = fmt;
+    entry->format = result;
+
+    return result;
+}
+
+static uint32_t GetModuleId(const char* moduleName) {
+    ModuleCacheEntry* entry =
+        moduleCache + ((uintptr_t)moduleName >> 2) % MODULE_CACHE_SIZE;
+    uint32_t generation = ModManGetGeneration();
+    if (entry->name == moduleName && entry->generation == generation)
+        return entry->id;
+
+    pthread_mutex_lock(&registryMutex);
+
+    /* A hot-reloaded mod may reuse an address for a different name. */
+    BinLogModule* module =
+        FoxMapMIndex(const void*, BinLogModule, &modules, moduleName);
+    if (!module || strcmp(module->name, moduleName) != 0) {
+        if (!module)
+            module =
+                FoxMapMInsert(const void*, BinLogModule, &modules, moduleName);
+        else
+            free(module->name);
+        module->name = strdup(moduleName);
+        assert(module->name);
+        module->id = numModules++;
+        WriteNamedRecord(BINLOG_MODULE, module->id, module->name);
+    }
+    uint32_t result = module->id;
+
+    pthread_mutex_unlock(&registryMutex);
+
+    entry->name = moduleName;
+    entry->id = result;
+    entry->generation = generation;
+
+    return result;
+}
+
+static bool FreeModuleCallback(BinLogModule* module, void* ctx) {
+    (void)ctx;
+
+    free(module->name);
+
+    return true;
+}
+
+static bool FreeFormatCallback(BinLogFormat** format, void* ctx) {
+    (void)ctx;
+
+    free((*format)->fmt);
+    free(*format);
+
+    return true;
+}
+
+/* ----- INTERNAL FUNCTIONS ----- */
+
+bool BinLogIsOpen(void) {
+    return isOpen;
+}
+
+void BinLogWrite(LogLevel logLvl,
+                 const char* moduleName,
+                 const char* fmt,
+                 va_list va) {
+    assert(isOpen);
+
+    BinLogFormat* format = GetFormat(fmt);
+    BinLogMessageRecord* rec = (BinLogMessageRecord*)stagingBuf;
+    rec->formatId = format->id;
+    rec->moduleId = GetModuleId(moduleName);
+    rec->time = time(NULL);
+    uint8_t* cur = stagingBuf + sizeof(BinLogMessageRecord);
+    uint8_t* end = stagingBuf + sizeof(stagingBuf);
+
+    /* Some formats can't be deferred, so format those right away. */
+    if (!format->deferrable) {
+        int len = vsnprintf((char*)cur, end - cur, fmt, va);
+        size_t textSize = (len < 0) ? 1 : (size_t)len + 1;
+        if (textSize > (size_t)(end - cur))
+            textSize = end - cur;
+        cur[textSize - 1] = '\0';
+        cur += textSize;
+
+        uint32_t size = cur - stagingBuf;
+        uint8_t* dest = Reserve(size);
+        if (dest) {
+            memcpy(dest + sizeof(BinLogRecordHeader),
+                   stagingBuf + sizeof(BinLogRecordHeader),
+                   size - sizeof(BinLogRecordHeader));
+            Publish(dest, BINLOG_TEXT, logLvl, size);
+        }
+        return;
+    }
+
+    /* Copy arguments as-is. */
+    for (uint32_t idx = 0; idx < format->numArgs; idx++) {
+        int64_t intVal;
+        switch (format->argTypes[idx]) {
+            case ARG_INT:
+                intVal = va_arg(va, int);
+                break;
+            case ARG_LONG:
+                intVal = va_arg(va, long);
+                break;
+            case ARG_LLONG:
+                intVal = va_arg(va, long long);
+                break;
+            case ARG_INTMAX:
+                intVal = va_arg(va, intmax_t);
+                break;
+            case ARG_SIZE:
+                intVal = va_arg(va, size_t);
+                break;
+            case ARG_PTRDIFF:
+                intVal = va_arg(va, ptrdiff_t);
+                break;
+            case ARG_DOUBLE: {
+                double doubleVal = va_arg(va, double);
+                memcpy(cur, &doubleVal, sizeof(doubleVal));
+                cur += sizeof(doubleVal);
+                continue;
+            }
+            case ARG_PTR: {
+                uint64_t ptrVal = (uintptr_t)va_arg(va, void*);
+                memcpy(cur, &ptrVal, sizeof(ptrVal));
+                cur += sizeof(ptrVal);
+                continue;
+            }
+            case ARG_STR: {
+                const char* str = va_arg(va, const char*);
+                if (!str)
+                    str = "(null)";
+                /* Leave room for the rest of the arguments. */
+                size_t room = end - cur - sizeof(uint32_t) -
+                              (format->numArgs - idx - 1) * sizeof(uint64_t);
+                uint32_t len = strnlen(str, room);
+                memcpy(cur, &len, sizeof(len));
+                memcpy(cur + sizeof(len), str, len);
+                cur += sizeof(len) + len;
+                continue;
+            }
+            default:
+                intVal = 0;
+        }
+        memcpy(cur, &intVal, sizeof(intVal));
+        cur += sizeof(intVal);
+    }
+
+    uint32_t size = cur - stagingBuf;
+    uint8_t* dest = Reserve(size);
+    if (dest) {
+        memcpy(dest + sizeof(BinLogRecordHeader),
+               stagingBuf + sizeof(BinLogRecordHeader),
+               size - sizeof(BinLogRecordHeader));
+        Publish(dest, BINLOG_MESSAGE, logLvl, size);
+    }
+
+    return;
+}
+
+void BinLogConstructor(void) {
+    if (!opts.binLogPath)
+        return;
+    LogInfo("Initializing binary log...");
+
+    capacity = opts.binLogMaxSize;
+    if (capacity < sizeof(BinLogHeader)) {
+        LogErr("Binary log size limit of %u byte(s) is too small.", capacity);
+        abort();
+    }
+
+    fileFd = open(opts.binLogPath, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC,
+                  0644);
+    if (fileFd < 0 || ftruncate(fileFd, capacity) != 0) {
+        LogErr("Could not create binary log \"%s\".", opts.binLogPath);
+        abort();
+    }
+    fileMem =
+        mmap(NULL, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fileFd, 0);
+    if (fileMem == MAP_FAILED) {
+        LogErr("Could not map binary log \"%s\".", opts.binLogPath);
+        abort();
+    }
+
+    BinLogHeader* header = (BinLogHeader*)fileMem;
+    *header = (BinLogHeader){
+        .version = BINLOG_VERSION,
+        .headerSize = sizeof(BinLogHeader),
+        .capacity = capacity,
+        .sizeofInt = sizeof(int),
+        .sizeofLong = sizeof(long),
+        .sizeofSize = sizeof(size_t),
+        .sizeofPtr = sizeof(void*),
+    };
+    memcpy(header->magic, BINLOG_MAGIC, sizeof(BINLOG_MAGIC));
+    writeOffset = sizeof(BinLogHeader);
+
+    FoxStringMapMInit(BinLogFormat*, &formats);
+    FoxMapMInit(const void*, BinLogModule, &modules);
+    isOpen = true;
+
+    LogInfo("Done initializing binary log \"%s\".", opts.binLogPath);
+    return;
+}
+
+void BinLogDestructor(void) {
+    if (!isOpen)
+        return;
+    isOpen = false;
+    LogInfo("Deinitializing binary log...");
+
+    /* Trim file down to what was actually written. */
+    uint32_t used = __atomic_load_n(&writeOffset, __ATOMIC_ACQUIRE);
+    ((BinLogHeader*)fileMem)->numDropped = numDropped;
+    munmap(fileMem, capacity);
+    fileMem = NULL;
+    if (ftruncate(fileFd, used) != 0)
+        LogWarn("Could not trim binary log \"%s\".", opts.binLogPath);
+    close(fileFd);
+    fileFd = -1;
+
+    FoxMapMForEachElement(const char*, BinLogFormat*, &formats,
+                          FreeFormatCallback, NULL);
+    FoxMapMDeinit(const char*, BinLogFormat*, &formats);
+    FoxMapMForEachElement(const void*, BinLogModule, &modules,
+                          FreeModuleCallback, NULL);
+    FoxMapMDeinit(const void*, BinLogModule, &modules);
+
+    LogInfo("Done deinitializing binary log. Dropped %u message(s).",
+            numDropped);
+    return;
+}
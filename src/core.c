@@ -19,18 +19,24 @@
 #include "aer/core.h"
 #include "aer/object.h"
 #include "aer/room.h"
+#include "internal/asset.h"
+#include "internal/binlog.h"
 #include "internal/conf.h"
 #include "internal/core.h"
+#include "internal/draw.h"
 #include "internal/err.h"
 #include "internal/event.h"
 #include "internal/export.h"
+#include "internal/font.h"
 #include "internal/hld.h"
 #include "internal/input.h"
 #include "internal/instance.h"
+#include "internal/job.h"
 #include "internal/log.h"
 #include "internal/mod.h"
 #include "internal/object.h"
 #include "internal/option.h"
+#include "internal/profile.h"
 #include "internal/rand.h"
 #include "internal/room.h"
 #include "internal/save.h"
@@ -48,7 +54,7 @@ static char assetPathBuf[8 * 1024];
 
 /* ----- INTERNAL GLOBALS ----- */
 
-CoreStage stage = STAGE_INIT;
+__thread CoreStage stage = STAGE_INIT;
 
 /* ----- INTERNAL FUNCTIONS ----- */
 
@@ -68,8 +74,12 @@ __attribute__((constructor)) static void CoreConstructor(void) {
     ModManConstructor();
     ConfConstructor();
     OptionConstructor();
+    BinLogConstructor();
+    ProfileManConstructor();
+    JobManConstructor();
     RandConstructor();
     EventManConstructor();
+    AssetManConstructor();
     SpriteManConstructor();
     ObjectManConstructor();
     RoomManConstructor();
@@ -79,17 +89,25 @@ __attribute__((constructor)) static void CoreConstructor(void) {
 }
 
 __attribute__((destructor)) static void CoreDestructor(void) {
+    JobManDestructor();
     InstanceManDestructor();
     SaveManDestructor();
     ModManUnloadMods();
     RoomManDestructor();
+    DrawManDestructor();
     ObjectManDestructor();
     SpriteManDestructor();
+    FontManDestructor();
+    AssetManDestructor();
     EventManDestructor();
     RandDestructor();
+    ProfileManDestructor();
+    ErrDestructor();
+    BinLogDestructor();
     OptionDestructor();
     ConfDestructor();
     ModManDestructor();
+    LogDestructor();
 
     return;
 }
@@ -104,6 +122,9 @@ AER_EXPORT void AERHookInit(HLDVariables vars, HLDFunctions funcs) {
     size_t numMods = ModManGetNumMods();
     SaveManConstructor();
 
+    /* Validate sprite and font files up front, reading them in parallel. */
+    AssetManPrescan();
+
     /* Build sprite name table. */
     SpriteManBuildNameTable();
 
@@ -121,6 +142,7 @@ AER_EXPORT void AERHookInit(HLDVariables vars, HLDFunctions funcs) {
             mod->registerSprites();
         }
     }
+    SpriteManBuildMasks();
     LogInfo("Done.");
 
     /* Register fonts. */
@@ -177,9 +199,24 @@ AER_EXPORT void AERHookInit(HLDVariables vars, HLDFunctions funcs) {
 }
 
 AER_EXPORT void AERHookStep(void) {
+    /* Close out time spent in mods during previous step. */
+    ProfileManEndStep();
+
+    /* Reload changed mods while no mod code is running. */
+    ModManReloadChangedMods();
+
+    /* Call completion callbacks of finished jobs. */
+    JobManDispatchCallbacks();
+
+    /* Log counts of repeated unhandled errors. */
+    ErrFlushReports();
+
     /* Record user input. */
     InputManRecordUserInput();
 
+    /* Apply deferred sprite replacements that instances now use. */
+    SpriteManLoadRoomPending();
+
     /* Check if game pause state changed. */
     bool paused = HLDObjectLookup(AER_OBJECT_MENUS)->numInstances > 0;
     if (paused != gamePaused) {
@@ -189,6 +226,9 @@ AER_EXPORT void AERHookStep(void) {
         ModManExecuteGamePauseListeners(paused);
     }
 
+    /* Record visibility for read-only listeners and the next draw stage. */
+    DrawManUpdateVisibility();
+
     /* Call game step listeners. */
     ModManExecuteGameStepListeners();
 
@@ -241,6 +281,9 @@ AER_EXPORT void AERHookRoomStart(HLDEventType type, int32_t num) {
     /* Call room start listeners. */
     ModManExecuteRoomStartListeners(*hldvars.roomIndexCurrent, roomIndexPrev);
 
+    /* Apply deferred sprite replacements before the room is first drawn. */
+    SpriteManPrefetchPending();
+
     return;
 }
 
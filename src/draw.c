@@ -1,30 +1,546 @@
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "foxutils/math.h"
+
 #include "aer/draw.h"
 #include "internal/core.h"
+#include "internal/draw.h"
 #include "internal/err.h"
 #include "internal/export.h"
 #include "internal/hld.h"
+#include "internal/log.h"
+#include "internal/mod.h"
+#include "internal/profile.h"
+#include "internal/sprite.h"
 
 /* ----- PRIVATE MACROS ----- */
 
-#define WrapString(str)                                                \
+#define GetCaller() __builtin_extract_return_addr(__builtin_return_address(0))
+
+/*
+ * Must be expanded directly inside of an exported function so that the draw
+ * calls are counted against the mod which called it.
+ */
+#define GetCallerDrawStats()                                           \
     ({                                                                 \
-        const char* WrapString_str = (str);                            \
-        uint32_t WrapString_idx;                                       \
-        for (WrapString_idx = 0; WrapString_idx < sizeof(textBuf) - 1; \
-             WrapString_idx++) {                                       \
-            char WrapString_curChar = WrapString_str[WrapString_idx];  \
-            if (WrapString_curChar == '\0')                            \
-                break;                                                 \
-            textBuf[WrapString_idx] = WrapString_curChar;              \
-        }                                                              \
-        textBuf[WrapString_idx] = '\0';                                \
-        textBuf;                                                       \
+        Mod* GetCallerDrawStats_mod = ModManGetCallerMod(GetCaller()); \
+        ProfileManGetDrawStats(GetCallerDrawStats_mod                  \
+                                   ? GetCallerDrawStats_mod->idx       \
+                                   : MOD_NULL);                        \
     })
 
+/* Rooms have a fixed number of view slots. */
+#define NUM_VIEWS 8
+
+#define CountDraws(stats, field, num)             \
+    do {                                          \
+        AERDrawStats* CountDraws_stats = (stats); \
+        CountDraws_stats->numCalls += (num);      \
+        CountDraws_stats->field += (num);         \
+    } while (0)
+
+/* ----- PRIVATE TYPES ----- */
+
+typedef enum DrawCmdKind {
+    DRAW_CMD_SPRITE,
+    DRAW_CMD_TEXT,
+    DRAW_CMD_RECTANGLE,
+    DRAW_CMD_LINE,
+    DRAW_CMD_TRIANGLE
+} DrawCmdKind;
+
+/*
+ * Where a sprite's frame is drawn from. Packed sprites draw a region of their
+ * atlas page, while other sprites draw their whole frame.
+ */
+typedef struct SpriteSource {
+    HLDSprite* sprite;
+    uint32_t frame;
+    int32_t texKey;
+    int32_t left;
+    int32_t top;
+    int32_t width;
+    int32_t height;
+} SpriteSource;
+
+/*
+ * Commands are flushed grouped by state, which is the texture they draw from
+ * (approximated by sprite, atlas page or font, as texture pages are not
+ * exposed) and the draw alpha. Untextured primitives share one group.
+ */
+typedef struct DrawState {
+    int32_t group;
+    int32_t texKey;
+    float alpha;
+} DrawState;
+
+typedef struct DrawCmd {
+    int32_t layer;
+    uint32_t seq;
+    DrawCmdKind kind;
+    DrawState state;
+    union {
+        struct {
+            SpriteSource src;
+            float x;
+            float y;
+            float scale;
+            uint32_t blend;
+        } sprite;
+        struct {
+            const char* text;
+            float x;
+            float y;
+            uint32_t width;
+            float scale;
+            uint32_t color;
+        } text;
+        struct {
+            float left;
+            float top;
+            float right;
+            float bottom;
+            uint32_t color;
+            bool outline;
+        } rect;
+        struct {
+            float x1;
+            float y1;
+            float x2;
+            float y2;
+            float width;
+            uint32_t color;
+        } line;
+        struct {
+            float x1;
+            float y1;
+            float x2;
+            float y2;
+            float x3;
+            float y3;
+            uint32_t color;
+            bool outline;
+        } tri;
+    };
+} DrawCmd;
+
+typedef struct DrawList {
+    DrawCmd* cmds;
+    size_t numCmds;
+    size_t capacity;
+    /* State changes the commands would have needed in recorded order. */
+    size_t numChangesRecorded;
+    AERDrawListStats stats;
+} DrawList;
+
+typedef struct ViewRect {
+    float left;
+    float top;
+    float right;
+    float bottom;
+} ViewRect;
+
+/* ----- PRIVATE CONSTANTS ----- */
+
+static const size_t DRAW_LIST_INIT_CAPACITY = 64;
+
 /* ----- PRIVATE GLOBALS ----- */
 
 static char textBuf[8 * 1024];
 
+/*
+ * Views and instances only stay put while read-only game step listeners run
+ * and for the duration of the draw stage, so visibility is recorded on the
+ * main thread just before each and recomputed on every query otherwise.
+ * Queries never write to the record, so listener threads may share it.
+ */
+static ViewRect viewRects[NUM_VIEWS];
+
+static uint32_t numViewRects = 0;
+
+static HLDInstance** visibleInsts = NULL;
+
+static size_t numVisibleInsts = 0;
+
+static size_t visibleInstsCapacity = 0;
+
+static bool drawVisibilityRecorded = false;
+
+/* Texture of the last sprite or text drawn by any mod. */
+static int32_t lastTexKey = -1;
+
+/* ----- PRIVATE FUNCTIONS ----- */
+
+/*
+ * The engine is only ever handed text owned by the MRE. Text too long for
+ * `textBuf` is copied to the heap rather than truncated, in which case
+ * `*heapText` must be freed once drawn.
+ */
+static const char* CopyText(const char* text, char** heapText) {
+    size_t size = strlen(text) + 1;
+    char* buf = textBuf;
+    *heapText = NULL;
+    if (size > sizeof(textBuf)) {
+        buf = *heapText = malloc(size);
+        assert(buf);
+    }
+    memcpy(buf, text, size);
+
+    return buf;
+}
+
+static inline bool DrawStateEqual(const DrawState* a, const DrawState* b) {
+    return a->group == b->group && a->texKey == b->texKey &&
+           a->alpha == b->alpha;
+}
+
+static int CompareDrawCmds(const void* a, const void* b) {
+    const DrawCmd* cmdA = a;
+    const DrawCmd* cmdB = b;
+
+    if (cmdA->layer != cmdB->layer)
+        return (cmdA->layer < cmdB->layer) ? -1 : 1;
+    if (cmdA->state.group != cmdB->state.group)
+        return (cmdA->state.group < cmdB->state.group) ? -1 : 1;
+    if (cmdA->state.texKey != cmdB->state.texKey)
+        return (cmdA->state.texKey < cmdB->state.texKey) ? -1 : 1;
+    if (cmdA->state.alpha != cmdB->state.alpha)
+        return (cmdA->state.alpha < cmdB->state.alpha) ? -1 : 1;
+    /* Keep recorded order otherwise, as qsort is not stable. */
+    return (cmdA->seq < cmdB->seq) ? -1 : (cmdA->seq > cmdB->seq);
+}
+
+/* Captures current draw state, so call this while recording. */
+static DrawCmd* DrawListPush(DrawList* list,
+                             int32_t layer,
+                             DrawCmdKind kind,
+                             int32_t texKey) {
+    if (list->numCmds == list->capacity) {
+        list->capacity *= 2;
+        list->cmds = realloc(list->cmds, list->capacity * sizeof(DrawCmd));
+        assert(list->cmds);
+    }
+
+    DrawCmd* cmd = list->cmds + list->numCmds;
+    cmd->layer = layer;
+    cmd->seq = list->numCmds;
+    cmd->kind = kind;
+    cmd->state.group = (kind > DRAW_CMD_TEXT) ? DRAW_CMD_RECTANGLE : kind;
+    cmd->state.texKey = texKey;
+    cmd->state.alpha = hldfuncs.actionDrawGetAlpha();
+    if (list->numCmds > 0 && !DrawStateEqual(&cmd[-1].state, &cmd->state))
+        list->numChangesRecorded++;
+    list->numCmds++;
+
+    return cmd;
+}
+
+/* Fonts are keyed below sprites and the `-1` of untextured primitives. */
+static inline int32_t GetFontTexKey(int32_t fontIdx) {
+    return -2 - fontIdx;
+}
+
+static inline void CountTexture(AERDrawStats* stats, int32_t texKey) {
+    if (texKey != lastTexKey) {
+        stats->numTextureSwitches++;
+        lastTexKey = texKey;
+    }
+
+    return;
+}
+
+/*
+ * Returns the number of frames of a sprite, or `0` if it does not exist. The
+ * source is only filled in if argument `frame` is one of those frames.
+ */
+static uint32_t GetSpriteSource(int32_t spriteIdx,
+                                uint32_t frame,
+                                SpriteSource* src) {
+    PackedSprite* packed = SpriteManLookupPacked(spriteIdx);
+    if (packed) {
+        if (frame < packed->numFrames) {
+            PackedFrame* packedFrame = packed->frames + frame;
+            *src = (SpriteSource){.sprite = packedFrame->page,
+                                  .frame = 0,
+                                  .texKey = packedFrame->pageIdx,
+                                  .left = packedFrame->left,
+                                  .top = packedFrame->top,
+                                  .width = packed->size.x,
+                                  .height = packed->size.y};
+        }
+        return packed->numFrames;
+    }
+
+    SpriteManLoadPending(spriteIdx);
+    HLDSprite* sprite = HLDSpriteLookup(spriteIdx);
+    if (!sprite)
+        return 0;
+    if (frame < sprite->numImages) {
+        *src = (SpriteSource){.sprite = sprite,
+                              .frame = frame,
+                              .texKey = spriteIdx,
+                              .left = 0,
+                              .top = 0,
+                              .width = sprite->size.x,
+                              .height = sprite->size.y};
+    }
+
+    return sprite->numImages;
+}
+
+static inline void DrawSpriteSource(const SpriteSource* src,
+                                    float x,
+                                    float y,
+                                    float scale,
+                                    uint32_t blend) {
+    hldfuncs.actionDrawSpriteGeneral(src->sprite, src->frame, (float)src->left,
+                                     (float)src->top, (float)src->width,
+                                     (float)src->height, x, y, scale, scale,
+                                     0.0f, blend, blend, blend, blend, 1.0f);
+
+    return;
+}
+
+static inline uint64_t GetSpritePixels(float width,
+                                       float height,
+                                       float scaleX,
+                                       float scaleY) {
+    float area = width * height * scaleX * scaleY;
+
+    return (uint64_t)((area < 0.0f) ? -area : area);
+}
+
+static void DrawCmdExecute(const DrawCmd* cmd, AERDrawStats* stats) {
+    switch (cmd->kind) {
+        case DRAW_CMD_SPRITE:
+            DrawSpriteSource(&cmd->sprite.src, cmd->sprite.x, cmd->sprite.y,
+                             cmd->sprite.scale, cmd->sprite.blend);
+            CountDraws(stats, numSprites, 1);
+            CountTexture(stats, cmd->state.texKey);
+            stats->numSpritePixels += GetSpritePixels(
+                cmd->sprite.src.width, cmd->sprite.src.height,
+                cmd->sprite.scale, cmd->sprite.scale);
+            break;
+        case DRAW_CMD_TEXT:
+            hldfuncs.actionDrawText(cmd->text.x, cmd->text.y, cmd->text.text,
+                                    -1, cmd->text.width, cmd->text.scale,
+                                    cmd->text.scale, 0.0f, cmd->text.color,
+                                    cmd->text.color, cmd->text.color,
+                                    cmd->text.color, 1.0f);
+            CountDraws(stats, numTexts, 1);
+            CountTexture(stats, GetFontTexKey(cmd->state.texKey));
+            stats->numTextChars += strlen(cmd->text.text);
+            break;
+        case DRAW_CMD_RECTANGLE:
+            hldfuncs.actionDrawRectangle(
+                cmd->rect.left, cmd->rect.top, cmd->rect.right,
+                cmd->rect.bottom, cmd->rect.color, cmd->rect.color,
+                cmd->rect.color, cmd->rect.color, cmd->rect.outline);
+            CountDraws(stats, numRectangles, 1);
+            break;
+        case DRAW_CMD_LINE:
+            hldfuncs.actionDrawLine(cmd->line.x1, cmd->line.y1, cmd->line.x2,
+                                    cmd->line.y2, cmd->line.width,
+                                    cmd->line.color, cmd->line.color);
+            CountDraws(stats, numLines, 1);
+            break;
+        case DRAW_CMD_TRIANGLE:
+            hldfuncs.actionDrawTriangle(cmd->tri.x1, cmd->tri.y1, cmd->tri.x2,
+                                        cmd->tri.y2, cmd->tri.x3, cmd->tri.y3,
+                                        cmd->tri.color, cmd->tri.color,
+                                        cmd->tri.color, cmd->tri.outline);
+            CountDraws(stats, numTriangles, 1);
+    }
+
+    return;
+}
+
+static uint32_t RecordViewRects(ViewRect* rects) {
+    uint32_t numRects = 0;
+    for (uint32_t idx = 0; idx < NUM_VIEWS; idx++) {
+        HLDView* view = HLDViewLookup(idx);
+        if (!(view && view->visible))
+            continue;
+
+        float halfWidth = view->sizeRoom.x * 0.5f;
+        float halfHeight = view->sizeRoom.y * 0.5f;
+        float centerX = view->posRoom.x + halfWidth;
+        float centerY = view->posRoom.y + halfHeight;
+        /* Views rotate about their center, so bound the rotated view. */
+        if (view->angle != 0.0f) {
+            float rads = view->angle * (float)(M_PI / 180.0);
+            float cosAngle = fabsf(cosf(rads));
+            float sinAngle = fabsf(sinf(rads));
+            float rotHalfWidth = halfWidth * cosAngle + halfHeight * sinAngle;
+            halfHeight = halfWidth * sinAngle + halfHeight * cosAngle;
+            halfWidth = rotHalfWidth;
+        }
+        rects[numRects++] = (ViewRect){.left = centerX - halfWidth,
+                                       .top = centerY - halfHeight,
+                                       .right = centerX + halfWidth,
+                                       .bottom = centerY + halfHeight};
+    }
+
+    return numRects;
+}
+
+static inline bool IsRecordedVisibilityCurrent(void) {
+    return stage == STAGE_READ_ONLY || stage == STAGE_DRAW;
+}
+
+/* Argument `scratch` must hold `NUM_VIEWS` elements. */
+static uint32_t GetViewRects(ViewRect* scratch, const ViewRect** rects) {
+    if (IsRecordedVisibilityCurrent()) {
+        *rects = viewRects;
+        return numViewRects;
+    }
+
+    *rects = scratch;
+    return RecordViewRects(scratch);
+}
+
+static bool IsRectInViews(const ViewRect* rects,
+                          uint32_t numRects,
+                          float left,
+                          float top,
+                          float right,
+                          float bottom) {
+    /* Without any views the whole room is drawn. */
+    if (numRects == 0)
+        return true;
+
+    for (uint32_t idx = 0; idx < numRects; idx++) {
+        const ViewRect* view = rects + idx;
+        if (left <= view->right && right >= view->left &&
+            top <= view->bottom && bottom >= view->top)
+            return true;
+    }
+
+    return false;
+}
+
+static bool IsInstanceInViews(const ViewRect* rects,
+                              uint32_t numRects,
+                              HLDInstance* inst) {
+    HLDBoundingBox bbox = inst->bbox;
+
+    /* Instances without a mask have an empty bounding box. */
+    if (bbox.right < bbox.left || bbox.bottom < bbox.top)
+        return IsRectInViews(rects, numRects, inst->pos.x, inst->pos.y,
+                             inst->pos.x, inst->pos.y);
+
+    return IsRectInViews(rects, numRects, (float)bbox.left, (float)bbox.top,
+                         (float)bbox.right, (float)bbox.bottom);
+}
+
+/*
+ * Writes up to `bufSize` visible instances to `instBuf` and returns how many
+ * there are in total.
+ */
+static size_t CollectVisibleInstances(const ViewRect* rects,
+                                      uint32_t numRects,
+                                      size_t bufSize,
+                                      HLDInstance** instBuf) {
+    HLDRoom* room = *hldvars.roomCurrent;
+    size_t numInsts = (size_t)room->numInstances;
+    size_t numVisible = 0;
+    HLDInstance* inst = room->instanceFirst;
+    for (size_t idx = 0; idx < numInsts; idx++) {
+        if (IsInstanceInViews(rects, numRects, inst)) {
+            if (numVisible < bufSize)
+                instBuf[numVisible] = inst;
+            numVisible++;
+        }
+        inst = inst->instanceNext;
+    }
+
+    return numVisible;
+}
+
+static void RecordVisibility(void) {
+    numViewRects = RecordViewRects(viewRects);
+
+    size_t capacity = (size_t)(*hldvars.roomCurrent)->numInstances;
+    if (capacity > visibleInstsCapacity) {
+        visibleInsts = realloc(visibleInsts, capacity * sizeof(HLDInstance*));
+        assert(visibleInsts);
+        visibleInstsCapacity = capacity;
+    }
+    numVisibleInsts = CollectVisibleInstances(viewRects, numViewRects,
+                                              capacity, visibleInsts);
+
+    return;
+}
+
+/* ----- INTERNAL FUNCTIONS ----- */
+
+bool DrawManIsRectVisible(float left, float top, float right, float bottom) {
+    ViewRect scratch[NUM_VIEWS];
+    const ViewRect* rects;
+    uint32_t numRects = GetViewRects(scratch, &rects);
+
+    return IsRectInViews(rects, numRects, left, top, right, bottom);
+}
+
+bool DrawManIsInstanceVisible(HLDInstance* inst) {
+    assert(inst);
+
+    ViewRect scratch[NUM_VIEWS];
+    const ViewRect* rects;
+    uint32_t numRects = GetViewRects(scratch, &rects);
+
+    return IsInstanceInViews(rects, numRects, inst);
+}
+
+size_t DrawManGetVisibleInstances(size_t bufSize, HLDInstance** instBuf) {
+    assert(instBuf || bufSize == 0);
+
+    if (IsRecordedVisibilityCurrent()) {
+        size_t numToWrite = FoxMin(numVisibleInsts, bufSize);
+        for (size_t idx = 0; idx < numToWrite; idx++)
+            instBuf[idx] = visibleInsts[idx];
+        return numVisibleInsts;
+    }
+
+    ViewRect rects[NUM_VIEWS];
+    uint32_t numRects = RecordViewRects(rects);
+    return CollectVisibleInstances(rects, numRects, bufSize, instBuf);
+}
+
+void DrawManUpdateVisibility(void) {
+    RecordVisibility();
+    drawVisibilityRecorded = false;
+
+    return;
+}
+
+void DrawManUpdateDrawVisibility(void) {
+    if (drawVisibilityRecorded)
+        return;
+
+    RecordVisibility();
+    drawVisibilityRecorded = true;
+
+    return;
+}
+
+void DrawManDestructor(void) {
+    LogInfo("Deinitializing draw module...");
+
+    free(visibleInsts);
+    visibleInsts = NULL;
+    numVisibleInsts = 0;
+    visibleInstsCapacity = 0;
+    numViewRects = 0;
+    drawVisibilityRecorded = false;
+
+    LogInfo("Done deinitializing draw module.");
+    return;
+}
+
 /* ----- PUBLIC FUNCTIONS ----- */
 
 AER_EXPORT float AERDrawGetCurrentAlpha(void) {
@@ -37,7 +553,7 @@ AER_EXPORT float AERDrawGetCurrentAlpha(void) {
 
 AER_EXPORT void AERDrawSetCurrentAlpha(float alpha) {
 #define errRet
-    EnsureStage(STAGE_ACTION);
+    EnsureStageMut(STAGE_ACTION);
     EnsureProba(alpha);
 
     hldfuncs.actionDrawSetAlpha(alpha);
@@ -54,15 +570,18 @@ AER_EXPORT void AERDrawSprite(int32_t spriteIdx,
                               uint32_t blend) {
 #define errRet
     EnsureStageStrict(STAGE_DRAW);
-    HLDSprite* sprite = HLDSpriteLookup(spriteIdx);
-    EnsureLookup(sprite);
-    EnsureMaxExc(frame, sprite->numImages);
+    SpriteSource src;
+    uint32_t numFrames = GetSpriteSource(spriteIdx, frame, &src);
+    EnsureLookup(numFrames > 0);
+    EnsureMaxExc(frame, numFrames);
 
-    HLDVecIntegral spriteSize = sprite->size;
+    DrawSpriteSource(&src, x, y, scale, blend);
 
-    hldfuncs.actionDrawSpriteGeneral(sprite, frame, 0.0f, 0.0f, spriteSize.x,
-                                     spriteSize.y, x, y, scale, scale, 0.0f,
-                                     blend, blend, blend, blend, 1.0f);
+    AERDrawStats* stats = GetCallerDrawStats();
+    CountDraws(stats, numSprites, 1);
+    CountTexture(stats, src.texKey);
+    stats->numSpritePixels +=
+        GetSpritePixels(src.width, src.height, scale, scale);
 
     Ok();
 #undef errRet
@@ -86,14 +605,89 @@ AER_EXPORT void AERDrawSpriteAdv(int32_t spriteIdx,
                                  float alpha) {
 #define errRet
     EnsureStageStrict(STAGE_DRAW);
-    HLDSprite* sprite = HLDSpriteLookup(spriteIdx);
-    EnsureLookup(sprite);
-    EnsureMaxExc(frame, sprite->numImages);
+    SpriteSource src;
+    uint32_t numFrames = GetSpriteSource(spriteIdx, frame, &src);
+    EnsureLookup(numFrames > 0);
+    EnsureMaxExc(frame, numFrames);
     EnsureProba(alpha);
 
+    /*
+     * A packed sprite's part must not bleed into its neighbors on the page, so
+     * clip it to the frame and move what remains to where it would have been.
+     */
+    if (SpriteManLookupPacked(spriteIdx)) {
+        int32_t clipLeft = (left > 0) ? left : 0;
+        int32_t clipTop = (top > 0) ? top : 0;
+        int32_t right = (left + width < src.width) ? left + width : src.width;
+        int32_t bottom =
+            (top + height < src.height) ? top + height : src.height;
+        if (right <= clipLeft || bottom <= clipTop)
+            Ok();
+
+        float offsetX = (clipLeft - left) * scaleX;
+        float offsetY = (clipTop - top) * scaleY;
+        float rads = angle * (float)(M_PI / 180.0);
+        x += offsetX * cosf(rads) + offsetY * sinf(rads);
+        y += offsetY * cosf(rads) - offsetX * sinf(rads);
+        left = src.left + clipLeft;
+        top = src.top + clipTop;
+        width = right - clipLeft;
+        height = bottom - clipTop;
+    }
+
     hldfuncs.actionDrawSpriteGeneral(
-        sprite, frame, (float)left, (float)top, (float)width, (float)height, x,
-        y, scaleX, scaleY, angle, blendNW, blendNE, blendSE, blendSW, alpha);
+        src.sprite, src.frame, (float)left, (float)top, (float)width,
+        (float)height, x, y, scaleX, scaleY, angle, blendNW, blendNE, blendSE,
+        blendSW, alpha);
+
+    AERDrawStats* stats = GetCallerDrawStats();
+    CountDraws(stats, numSprites, 1);
+    CountTexture(stats, src.texKey);
+    stats->numSpritePixels += GetSpritePixels(width, height, scaleX, scaleY);
+
+    Ok();
+#undef errRet
+}
+
+AER_EXPORT void AERDrawSprites(size_t numSprites,
+                               int32_t spriteIdx,
+                               const uint32_t* frames,
+                               const float* xs,
+                               const float* ys,
+                               const float* scales,
+                               const uint32_t* blends) {
+#define errRet
+    EnsureStageStrict(STAGE_DRAW);
+    EnsureArgBuf(frames, numSprites);
+    EnsureArgBuf(xs, numSprites);
+    EnsureArgBuf(ys, numSprites);
+    SpriteSource src;
+    uint32_t numFrames = GetSpriteSource(spriteIdx, 0, &src);
+    EnsureLookup(numFrames > 0);
+    for (size_t idx = 0; idx < numSprites; idx++)
+        EnsureMaxExc(frames[idx], numFrames);
+
+    AERDrawStats* stats = GetCallerDrawStats();
+    float width = src.width;
+    float height = src.height;
+    for (size_t idx = 0; idx < numSprites; idx++) {
+        float scale = scales ? scales[idx] : 1.0f;
+        uint32_t blend = blends ? blends[idx] : 0xffffff;
+        GetSpriteSource(spriteIdx, frames[idx], &src);
+        DrawSpriteSource(&src, xs[idx], ys[idx], scale, blend);
+        CountTexture(stats, src.texKey);
+    }
+
+    CountDraws(stats, numSprites, numSprites);
+    if (scales) {
+        for (size_t idx = 0; idx < numSprites; idx++) {
+            stats->numSpritePixels +=
+                GetSpritePixels(width, height, scales[idx], scales[idx]);
+        }
+    } else {
+        stats->numSpritePixels +=
+            numSprites * GetSpritePixels(width, height, 1.0f, 1.0f);
+    }
 
     Ok();
 #undef errRet
@@ -109,6 +703,8 @@ AER_EXPORT void AERDrawLine(float x1,
 
     hldfuncs.actionDrawLine(x1, y1, x2, y2, 1.0f, color, color);
 
+    CountDraws(GetCallerDrawStats(), numLines, 1);
+
     Ok();
 #undef errRet
 }
@@ -125,6 +721,29 @@ AER_EXPORT void AERDrawLineAdv(float x1,
 
     hldfuncs.actionDrawLine(x1, y1, x2, y2, width, color1, color2);
 
+    CountDraws(GetCallerDrawStats(), numLines, 1);
+
+    Ok();
+#undef errRet
+}
+
+AER_EXPORT void AERDrawLines(size_t numLines,
+                             const AERDrawSegment* segments,
+                             float width,
+                             const uint32_t* colors) {
+#define errRet
+    EnsureStageStrict(STAGE_DRAW);
+    EnsureArgBuf(segments, numLines);
+    EnsureArgBuf(colors, numLines);
+
+    for (size_t idx = 0; idx < numLines; idx++) {
+        const AERDrawSegment* seg = segments + idx;
+        hldfuncs.actionDrawLine(seg->x1, seg->y1, seg->x2, seg->y2, width,
+                                colors[idx], colors[idx]);
+    }
+
+    CountDraws(GetCallerDrawStats(), numLines, numLines);
+
     Ok();
 #undef errRet
 }
@@ -140,6 +759,8 @@ AER_EXPORT void AERDrawEllipse(float left,
 
     hldfuncs.actionDrawEllipse(left, top, right, bottom, color, color, outline);
 
+    CountDraws(GetCallerDrawStats(), numEllipses, 1);
+
     Ok();
 }
 
@@ -156,6 +777,8 @@ AER_EXPORT void AERDrawEllipseAdv(float left,
     hldfuncs.actionDrawEllipse(left, top, right, bottom, colorCenter, colorEdge,
                                outline);
 
+    CountDraws(GetCallerDrawStats(), numEllipses, 1);
+
     Ok();
 }
 
@@ -173,6 +796,8 @@ AER_EXPORT void AERDrawTriangle(float x1,
     hldfuncs.actionDrawTriangle(x1, y1, x2, y2, x3, y3, color, color, color,
                                 outline);
 
+    CountDraws(GetCallerDrawStats(), numTriangles, 1);
+
     Ok();
 #undef errRet
 }
@@ -193,6 +818,31 @@ AER_EXPORT void AERDrawTriangleAdv(float x1,
     hldfuncs.actionDrawTriangle(x1, y1, x2, y2, x3, y3, color1, color2, color3,
                                 outline);
 
+    CountDraws(GetCallerDrawStats(), numTriangles, 1);
+
+    Ok();
+#undef errRet
+}
+
+AER_EXPORT void AERDrawTriangles(size_t numTris,
+                                 const AERDrawTri* tris,
+                                 const uint32_t* colors,
+                                 bool outline) {
+#define errRet
+    EnsureStageStrict(STAGE_DRAW);
+    EnsureArgBuf(tris, numTris);
+    EnsureArgBuf(colors, numTris);
+
+    for (size_t idx = 0; idx < numTris; idx++) {
+        const AERDrawTri* tri = tris + idx;
+        uint32_t color = colors[idx];
+        hldfuncs.actionDrawTriangle(tri->x1, tri->y1, tri->x2, tri->y2,
+                                    tri->x3, tri->y3, color, color, color,
+                                    outline);
+    }
+
+    CountDraws(GetCallerDrawStats(), numTriangles, numTris);
+
     Ok();
 #undef errRet
 }
@@ -209,6 +859,8 @@ AER_EXPORT void AERDrawRectangle(float left,
     hldfuncs.actionDrawRectangle(left, top, right, bottom, color, color, color,
                                  color, outline);
 
+    CountDraws(GetCallerDrawStats(), numRectangles, 1);
+
     Ok();
 #undef errRet
 }
@@ -228,6 +880,31 @@ AER_EXPORT void AERDrawRectangleAdv(float left,
     hldfuncs.actionDrawRectangle(left, top, right, bottom, colorNW, colorNE,
                                  colorSE, colorSW, outline);
 
+    CountDraws(GetCallerDrawStats(), numRectangles, 1);
+
+    Ok();
+#undef errRet
+}
+
+AER_EXPORT void AERDrawRectangles(size_t numRects,
+                                  const AERDrawRect* rects,
+                                  const uint32_t* colors,
+                                  bool outline) {
+#define errRet
+    EnsureStageStrict(STAGE_DRAW);
+    EnsureArgBuf(rects, numRects);
+    EnsureArgBuf(colors, numRects);
+
+    for (size_t idx = 0; idx < numRects; idx++) {
+        const AERDrawRect* rect = rects + idx;
+        uint32_t color = colors[idx];
+        hldfuncs.actionDrawRectangle(rect->left, rect->top, rect->right,
+                                     rect->bottom, color, color, color, color,
+                                     outline);
+    }
+
+    CountDraws(GetCallerDrawStats(), numRectangles, numRects);
+
     Ok();
 #undef errRet
 }
@@ -242,8 +919,15 @@ AER_EXPORT void AERDrawText(const char* text,
     EnsureStageStrict(STAGE_DRAW);
     EnsureArg(text);
 
-    hldfuncs.actionDrawText(x, y, WrapString(text), -1, width, scale, scale,
-                            0.0f, color, color, color, color, 1.0f);
+    char* heapText;
+    hldfuncs.actionDrawText(x, y, CopyText(text, &heapText), -1, width, scale,
+                            scale, 0.0f, color, color, color, color, 1.0f);
+    free(heapText);
+
+    AERDrawStats* stats = GetCallerDrawStats();
+    CountDraws(stats, numTexts, 1);
+    CountTexture(stats, GetFontTexKey(*hldvars.fontIndexCurrent));
+    stats->numTextChars += strlen(text);
 
     Ok();
 #undef errRet
@@ -267,10 +951,345 @@ AER_EXPORT void AERDrawTextAdv(const char* text,
     EnsureArg(text);
     EnsureProba(alpha);
 
-    hldfuncs.actionDrawText(x, y, WrapString(text), height, width, scaleX,
+    char* heapText;
+    hldfuncs.actionDrawText(x, y, CopyText(text, &heapText), height, width,
+                            scaleX, scaleY, angle, colorNW, colorNE, colorSE,
+                            colorSW, alpha);
+    free(heapText);
+
+    AERDrawStats* stats = GetCallerDrawStats();
+    CountDraws(stats, numTexts, 1);
+    CountTexture(stats, GetFontTexKey(*hldvars.fontIndexCurrent));
+    stats->numTextChars += strlen(text);
+
+    Ok();
+#undef errRet
+}
+
+AER_EXPORT AERTextHandle* AERTextHandleNew(const char* text) {
+#define errRet NULL
+    EnsureArg(text);
+
+    size_t size = strlen(text) + 1;
+    char* handle = malloc(size);
+    assert(handle);
+    memcpy(handle, text, size);
+
+    Ok((AERTextHandle*)handle);
+#undef errRet
+}
+
+AER_EXPORT void AERTextHandleFree(AERTextHandle* handle) {
+#define errRet
+    EnsureArg(handle);
+
+    free(handle);
+
+    Ok();
+#undef errRet
+}
+
+AER_EXPORT const char* AERTextHandleGetText(const AERTextHandle* handle) {
+#define errRet NULL
+    EnsureArg(handle);
+
+    Ok((const char*)handle);
+#undef errRet
+}
+
+AER_EXPORT void AERDrawTextHandle(const AERTextHandle* handle,
+                                  float x,
+                                  float y,
+                                  uint32_t width,
+                                  float scale,
+                                  uint32_t color) {
+#define errRet
+    EnsureStageStrict(STAGE_DRAW);
+    EnsureArg(handle);
+
+    hldfuncs.actionDrawText(x, y, (const char*)handle, -1, width, scale, scale,
+                            0.0f, color, color, color, color, 1.0f);
+
+    AERDrawStats* stats = GetCallerDrawStats();
+    CountDraws(stats, numTexts, 1);
+    CountTexture(stats, GetFontTexKey(*hldvars.fontIndexCurrent));
+    stats->numTextChars += strlen((const char*)handle);
+
+    Ok();
+#undef errRet
+}
+
+AER_EXPORT void AERDrawTextHandleAdv(const AERTextHandle* handle,
+                                     float x,
+                                     float y,
+                                     int32_t height,
+                                     uint32_t width,
+                                     float scaleX,
+                                     float scaleY,
+                                     float angle,
+                                     uint32_t colorNW,
+                                     uint32_t colorNE,
+                                     uint32_t colorSE,
+                                     uint32_t colorSW,
+                                     float alpha) {
+#define errRet
+    EnsureStageStrict(STAGE_DRAW);
+    EnsureArg(handle);
+    EnsureProba(alpha);
+
+    hldfuncs.actionDrawText(x, y, (const char*)handle, height, width, scaleX,
                             scaleY, angle, colorNW, colorNE, colorSE, colorSW,
                             alpha);
 
+    AERDrawStats* stats = GetCallerDrawStats();
+    CountDraws(stats, numTexts, 1);
+    CountTexture(stats, GetFontTexKey(*hldvars.fontIndexCurrent));
+    stats->numTextChars += strlen((const char*)handle);
+
     Ok();
 #undef errRet
-}
\ No newline at end of file
+}
+
+AER_EXPORT AERDrawList* AERDrawListNew(void) {
+    DrawList* list = malloc(sizeof(DrawList));
+    assert(list);
+    list->cmds = malloc(DRAW_LIST_INIT_CAPACITY * sizeof(DrawCmd));
+    assert(list->cmds);
+    list->numCmds = 0;
+    list->capacity = DRAW_LIST_INIT_CAPACITY;
+    list->numChangesRecorded = 0;
+    list->stats = (AERDrawListStats){0};
+
+    Ok((AERDrawList*)list);
+}
+
+AER_EXPORT void AERDrawListFree(AERDrawList* list) {
+#define errRet
+    EnsureArg(list);
+
+    free(((DrawList*)list)->cmds);
+    free(list);
+
+    Ok();
+#undef errRet
+}
+
+AER_EXPORT void AERDrawListAddSprite(AERDrawList* list,
+                                     int32_t layer,
+                                     int32_t spriteIdx,
+                                     uint32_t frame,
+                                     float x,
+                                     float y,
+                                     float scale,
+                                     uint32_t blend) {
+#define errRet
+    EnsureStageStrict(STAGE_DRAW);
+    EnsureArg(list);
+    SpriteSource src;
+    uint32_t numFrames = GetSpriteSource(spriteIdx, frame, &src);
+    EnsureLookup(numFrames > 0);
+    EnsureMaxExc(frame, numFrames);
+
+    DrawCmd* cmd = DrawListPush(list, layer, DRAW_CMD_SPRITE, src.texKey);
+    cmd->sprite.src = src;
+    cmd->sprite.x = x;
+    cmd->sprite.y = y;
+    cmd->sprite.scale = scale;
+    cmd->sprite.blend = blend;
+
+    Ok();
+#undef errRet
+}
+
+AER_EXPORT void AERDrawListAddText(AERDrawList* list,
+                                   int32_t layer,
+                                   const AERTextHandle* handle,
+                                   float x,
+                                   float y,
+                                   uint32_t width,
+                                   float scale,
+                                   uint32_t color) {
+#define errRet
+    EnsureStageStrict(STAGE_DRAW);
+    EnsureArg(list);
+    EnsureArg(handle);
+
+    DrawCmd* cmd = DrawListPush(list, layer, DRAW_CMD_TEXT,
+                                *hldvars.fontIndexCurrent);
+    cmd->text.text = (const char*)handle;
+    cmd->text.x = x;
+    cmd->text.y = y;
+    cmd->text.width = width;
+    cmd->text.scale = scale;
+    cmd->text.color = color;
+
+    Ok();
+#undef errRet
+}
+
+AER_EXPORT void AERDrawListAddRectangle(AERDrawList* list,
+                                        int32_t layer,
+                                        float left,
+                                        float top,
+                                        float right,
+                                        float bottom,
+                                        uint32_t color,
+                                        bool outline) {
+#define errRet
+    EnsureStageStrict(STAGE_DRAW);
+    EnsureArg(list);
+
+    DrawCmd* cmd = DrawListPush(list, layer, DRAW_CMD_RECTANGLE, -1);
+    cmd->rect.left = left;
+    cmd->rect.top = top;
+    cmd->rect.right = right;
+    cmd->rect.bottom = bottom;
+    cmd->rect.color = color;
+    cmd->rect.outline = outline;
+
+    Ok();
+#undef errRet
+}
+
+AER_EXPORT void AERDrawListAddLine(AERDrawList* list,
+                                   int32_t layer,
+                                   float x1,
+                                   float y1,
+                                   float x2,
+                                   float y2,
+                                   float width,
+                                   uint32_t color) {
+#define errRet
+    EnsureStageStrict(STAGE_DRAW);
+    EnsureArg(list);
+
+    DrawCmd* cmd = DrawListPush(list, layer, DRAW_CMD_LINE, -1);
+    cmd->line.x1 = x1;
+    cmd->line.y1 = y1;
+    cmd->line.x2 = x2;
+    cmd->line.y2 = y2;
+    cmd->line.width = width;
+    cmd->line.color = color;
+
+    Ok();
+#undef errRet
+}
+
+AER_EXPORT void AERDrawListAddTriangle(AERDrawList* list,
+                                       int32_t layer,
+                                       float x1,
+                                       float y1,
+                                       float x2,
+                                       float y2,
+                                       float x3,
+                                       float y3,
+                                       uint32_t color,
+                                       bool outline) {
+#define errRet
+    EnsureStageStrict(STAGE_DRAW);
+    EnsureArg(list);
+
+    DrawCmd* cmd = DrawListPush(list, layer, DRAW_CMD_TRIANGLE, -1);
+    cmd->tri.x1 = x1;
+    cmd->tri.y1 = y1;
+    cmd->tri.x2 = x2;
+    cmd->tri.y2 = y2;
+    cmd->tri.x3 = x3;
+    cmd->tri.y3 = y3;
+    cmd->tri.color = color;
+    cmd->tri.outline = outline;
+
+    Ok();
+#undef errRet
+}
+
+AER_EXPORT void AERDrawListFlush(AERDrawList* list) {
+#define errRet
+    EnsureStageStrict(STAGE_DRAW);
+    EnsureArg(list);
+
+    DrawList* drawList = list;
+    DrawCmd* cmds = drawList->cmds;
+    size_t numCmds = drawList->numCmds;
+    qsort(cmds, numCmds, sizeof(DrawCmd), CompareDrawCmds);
+
+    AERDrawStats* stats = GetCallerDrawStats();
+    float origAlpha = hldfuncs.actionDrawGetAlpha();
+    int32_t origFont = *hldvars.fontIndexCurrent;
+    float curAlpha = origAlpha;
+    int32_t curFont = origFont;
+    size_t numChanges = 0;
+    for (size_t idx = 0; idx < numCmds; idx++) {
+        DrawCmd* cmd = cmds + idx;
+        if (idx > 0 && !DrawStateEqual(&cmd[-1].state, &cmd->state))
+            numChanges++;
+
+        if (cmd->state.alpha != curAlpha)
+            hldfuncs.actionDrawSetAlpha(curAlpha = cmd->state.alpha);
+        if (cmd->kind == DRAW_CMD_TEXT && cmd->state.texKey != curFont)
+            hldfuncs.actionDrawSetFont(curFont = cmd->state.texKey);
+        DrawCmdExecute(cmd, stats);
+    }
+    if (curAlpha != origAlpha)
+        hldfuncs.actionDrawSetAlpha(origAlpha);
+    if (curFont != origFont)
+        hldfuncs.actionDrawSetFont(origFont);
+
+    drawList->stats = (AERDrawListStats){
+        .numCmds = numCmds,
+        .numChangesRecorded = drawList->numChangesRecorded,
+        .numChangesFlushed = numChanges,
+    };
+    drawList->numCmds = 0;
+    drawList->numChangesRecorded = 0;
+
+    Ok();
+#undef errRet
+}
+
+AER_EXPORT void AERDrawListGetStats(const AERDrawList* list,
+                                    AERDrawListStats* stats) {
+#define errRet
+    EnsureArg(list);
+    EnsureArg(stats);
+
+    *stats = ((const DrawList*)list)->stats;
+
+    Ok();
+#undef errRet
+}
+
+AER_EXPORT void AERDrawGetStats(int32_t modIdx, AERDrawStats* stats) {
+#define errRet
+    EnsureStage(STAGE_ACTION);
+    EnsureLookup(modIdx >= 0 && (size_t)modIdx < ModManGetNumMods());
+    EnsureArg(stats);
+
+    *stats = *ProfileManGetPrevDrawStats(modIdx);
+
+    Ok();
+#undef errRet
+}
+
+AER_EXPORT size_t AERDrawGetCallHistogram(int32_t modIdx,
+                                          size_t bufSize,
+                                          uint32_t* histBuf) {
+#define errRet 0
+    EnsureStage(STAGE_ACTION);
+    EnsureLookup(modIdx >= 0 && (size_t)modIdx < ModManGetNumMods());
+    EnsureArgBuf(histBuf, bufSize);
+
+    Ok(ProfileManGetDrawHistogram(modIdx, bufSize, histBuf));
+#undef errRet
+}
+
+AER_EXPORT bool AERDrawIsRectVisible(float left,
+                                     float top,
+                                     float right,
+                                     float bottom) {
+#define errRet false
+    EnsureStage(STAGE_ACTION);
+
+    Ok(DrawManIsRectVisible(left, top, right, bottom));
+#undef errRet
+}
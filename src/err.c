@@ -13,9 +13,280 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <assert.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
 #include "aer/err.h"
+#include "internal/err.h"
 #include "internal/export.h"
 
+/* ----- PRIVATE MACROS ----- */
+
+#define FLUSH_INTERVAL_NS 1000000000
+
+/* ----- PRIVATE TYPES ----- */
+
+typedef struct ErrAggregate {
+    const char* func;
+    const char* errName;
+    AERErrCode code;
+    int32_t modIdx;
+    uint32_t count;
+    uint32_t reported;
+    struct ErrAggregate* next;
+} ErrAggregate;
+
+/*
+ * Indexed by mod index plus one, with zero being the MRE. Caches are grown by
+ * replacement, so superseded ones are kept until teardown in case another
+ * thread is still reading them.
+ */
+typedef struct ErrSiteCache {
+    struct ErrSiteCache* prev;
+    uint32_t size;
+    ErrAggregate* aggs[];
+} ErrSiteCache;
+
+/* ----- PRIVATE GLOBALS ----- */
+
+static __thread AERErrCode threadErr = AER_OK;
+
+/* Guards site registration and aggregate creation. */
+static pthread_mutex_t sitesMutex = PTHREAD_MUTEX_INITIALIZER;
+
+static ErrSite* sites = NULL;
+
+static ErrAggregate* aggs = NULL;
+
+static uint64_t lastFlushNs = 0;
+
 /* ----- PUBLIC GLOBALS ----- */
 
+/* Define the real global rather than the per-thread macro. */
+#undef aererr
 AER_EXPORT AERErrCode aererr = AER_OK;
+
+/* ----- INTERNAL GLOBALS ----- */
+
+__thread AERErrCode* errLocation = &aererr;
+
+/* ----- PRIVATE FUNCTIONS ----- */
+
+static ErrAggregate* FindAggregate(ErrSite* site, int32_t modIdx) {
+    for (ErrAggregate* agg = aggs; agg; agg = agg->next) {
+        if (agg->code == site->code && agg->modIdx == modIdx &&
+            strcmp(agg->func, site->func) == 0)
+            return agg;
+    }
+
+    ErrAggregate* agg = malloc(sizeof(ErrAggregate));
+    assert(agg);
+    *agg = (ErrAggregate){.func = site->func,
+                          .errName = site->errName,
+                          .code = site->code,
+                          .modIdx = modIdx,
+                          .next = aggs};
+    aggs = agg;
+
+    return agg;
+}
+
+static ErrSiteCache* GrowSiteCache(ErrSite* site, uint32_t minSize) {
+    ErrSiteCache* cache = site->cache;
+    if (!cache) {
+        site->next = sites;
+        sites = site;
+    }
+
+    /* Mods may load after a site is first hit, so size for all of them. */
+    uint32_t size = ModManGetNumMods() + 1;
+    if (size < minSize)
+        size = minSize;
+    ErrSiteCache* newCache =
+        calloc(1, sizeof(ErrSiteCache) + size * sizeof(ErrAggregate*));
+    assert(newCache);
+    newCache->prev = cache;
+    newCache->size = size;
+    if (cache) {
+        for (uint32_t idx = 0; idx < cache->size; idx++)
+            newCache->aggs[idx] = cache->aggs[idx];
+    }
+    __atomic_store_n(&site->cache, newCache, __ATOMIC_RELEASE);
+
+    return newCache;
+}
+
+static ErrAggregate* GetAggregate(ErrSite* site, uint32_t cacheIdx) {
+    pthread_mutex_lock(&sitesMutex);
+
+    ErrSiteCache* cache = site->cache;
+    if (!cache || cacheIdx >= cache->size)
+        cache = GrowSiteCache(site, cacheIdx + 1);
+    ErrAggregate* agg = cache->aggs[cacheIdx];
+    if (!agg) {
+        agg = FindAggregate(site, (int32_t)cacheIdx - 1);
+        __atomic_store_n(cache->aggs + cacheIdx, agg, __ATOMIC_RELEASE);
+    }
+
+    pthread_mutex_unlock(&sitesMutex);
+    return agg;
+}
+
+static void ReportRepeats(ErrAggregate* agg) {
+    uint32_t count = __atomic_load_n(&agg->count, __ATOMIC_RELAXED);
+    uint32_t reported = agg->reported;
+    /* The first occurrence was logged when it happened. */
+    if (count > 0 && reported == 0)
+        reported = 1;
+    if (count <= reported)
+        return;
+    uint32_t numRepeats = count - reported;
+    agg->reported = count;
+
+    if (agg->modIdx >= 0) {
+        LogWarn(
+            "Potentially unhandled error \"%s\" occurred %u more time(s) "
+            "during calls to function \"%s\" by mod \"%s\".",
+            agg->errName, numRepeats, agg->func,
+            ModManGetMod(agg->modIdx)->name);
+    } else {
+        LogWarn(
+            "Potentially unhandled error \"%s\" occurred %u more time(s) "
+            "during internal calls to function \"%s\".",
+            agg->errName, numRepeats, agg->func);
+    }
+
+    return;
+}
+
+static void FlushReports(void) {
+    pthread_mutex_lock(&sitesMutex);
+    for (ErrAggregate* agg = aggs; agg; agg = agg->next)
+        ReportRepeats(agg);
+    pthread_mutex_unlock(&sitesMutex);
+
+    return;
+}
+
+/* ----- INTERNAL FUNCTIONS ----- */
+
+void ErrUseThreadLocal(void) {
+    errLocation = &threadErr;
+
+    return;
+}
+
+void ErrReport(ErrSite* site, void* caller) {
+    assert(site);
+
+    Mod* mod = ModManGetCallerMod(caller);
+    uint32_t cacheIdx = (mod) ? mod->idx + 1 : 0;
+
+    ErrSiteCache* cache = __atomic_load_n(&site->cache, __ATOMIC_ACQUIRE);
+    ErrAggregate* agg = NULL;
+    if (cache && cacheIdx < cache->size)
+        agg = __atomic_load_n(cache->aggs + cacheIdx, __ATOMIC_ACQUIRE);
+    if (!agg)
+        agg = GetAggregate(site, cacheIdx);
+
+    /* Only the first occurrence is logged right away. */
+    if (__atomic_fetch_add(&agg->count, 1, __ATOMIC_RELAXED) == 0) {
+        if (mod) {
+            LogWarn(
+                "Potentially unhandled error \"%s\" occurred during call to "
+                "function \"%s\" by mod \"%s\". Repeats will be "
+                "aggregated.",
+                site->errName, site->func, mod->name);
+        } else {
+            LogWarn(
+                "Potentially unhandled error \"%s\" occurred during internal "
+                "call to function \"%s\". Repeats will be aggregated.",
+                site->errName, site->func);
+        }
+    }
+
+    if (opts.promoteUnhandledErrors) {
+        LogErr("Promoting potentially unhandled error.");
+        abort();
+    }
+
+    return;
+}
+
+void ErrFlushReports(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    uint64_t nowNs = (uint64_t)now.tv_sec * 1000000000 + (uint64_t)now.tv_nsec;
+    if (nowNs - lastFlushNs < FLUSH_INTERVAL_NS)
+        return;
+    lastFlushNs = nowNs;
+
+    FlushReports();
+
+    return;
+}
+
+void ErrDestructor(void) {
+    FlushReports();
+
+    pthread_mutex_lock(&sitesMutex);
+    ErrSite* site = sites;
+    while (site) {
+        ErrSite* next = site->next;
+        ErrSiteCache* cache = site->cache;
+        while (cache) {
+            ErrSiteCache* prev = cache->prev;
+            free(cache);
+            cache = prev;
+        }
+        site->cache = NULL;
+        site->next = NULL;
+        site = next;
+    }
+    sites = NULL;
+
+    ErrAggregate* agg = aggs;
+    while (agg) {
+        ErrAggregate* next = agg->next;
+        free(agg);
+        agg = next;
+    }
+    aggs = NULL;
+    pthread_mutex_unlock(&sitesMutex);
+
+    return;
+}
+
+/* ----- PUBLIC FUNCTIONS ----- */
+
+AER_EXPORT AERErrCode* AERErrLocation(void) {
+    return errLocation;
+}
+
+AER_EXPORT size_t AERErrGetReports(size_t bufSize, AERErrReport* reportBuf) {
+#define errRet 0
+    EnsureArgBuf(reportBuf, bufSize);
+
+    size_t numReports = 0;
+    pthread_mutex_lock(&sitesMutex);
+    for (ErrAggregate* agg = aggs; agg; agg = agg->next) {
+        uint32_t count = __atomic_load_n(&agg->count, __ATOMIC_RELAXED);
+        if (count == 0)
+            continue;
+        if (numReports < bufSize) {
+            reportBuf[numReports] = (AERErrReport){.function = agg->func,
+                                                   .code = agg->code,
+                                                   .modIdx = agg->modIdx,
+                                                   .count = count};
+        }
+        numReports++;
+    }
+    pthread_mutex_unlock(&sitesMutex);
+
+    Ok(numReports);
+#undef errRet
+}
@@ -25,11 +25,13 @@
 
 #include "aer/event.h"
 #include "internal/core.h"
+#include "internal/draw.h"
 #include "internal/event.h"
 #include "internal/hld.h"
 #include "internal/log.h"
 #include "internal/mod.h"
 #include "internal/object.h"
+#include "internal/profile.h"
 
 /* ----- PRIVATE TYPES ----- */
 
@@ -74,7 +76,7 @@ static void EventTrapInit(EventTrap* trap,
 
     trap->eventType = eventType;
     trap->origListener = origListener;
-    FoxArrayMInitExt(void*, &trap->modListeners, 2);
+    FoxArrayMInitExt(ModListener, &trap->modListeners, 2);
 
     return;
 }
@@ -84,19 +86,29 @@ static void EventTrapDeinit(EventTrap* trap) {
 
     trap->eventType = 0;
     trap->origListener = NULL;
-    FoxArrayMDeinit(void*, &trap->modListeners);
+    FoxArrayMDeinit(ModListener, &trap->modListeners);
 
     return;
 }
 
-static void EventTrapAddListener(EventTrap* trap, void* listener) {
+static void EventTrapAddListener(EventTrap* trap,
+                                 void* listener,
+                                 int32_t modIdx,
+                                 bool cull) {
     assert(trap);
 
-    *FoxArrayMPush(void*, &trap->modListeners) = listener;
+    ModManInsertListener(&trap->modListeners, listener, modIdx)->cull = cull;
 
     return;
 }
 
+static bool EventTrapRemoveModListenersCallback(EventTrap* trap,
+                                                int32_t* modIdx) {
+    ModManRemoveListeners(&trap->modListeners, *modIdx);
+
+    return true;
+}
+
 static bool EventTrapDeinitCallback(EventTrap* trap, void* ctx) {
     (void)ctx;
 
@@ -116,11 +128,26 @@ static bool EventTrapIterNext(EventTrapIter* iter,
     EventTrap* trap = iter->trap;
     FoxArray* modListeners = &trap->modListeners;
     if (iter->nextIdx < FoxArrayMSize(ModListener, modListeners)) {
+        ModListener modListener =
+            *FoxArrayMIndex(ModListener, modListeners, iter->nextIdx++);
+
+        /* Draw listeners of mods that are over budget may be skipped. */
+        if (trap->eventType == HLD_EVENT_DRAW &&
+            ProfileManShouldSkip(modListener.modIdx))
+            return EventTrapIterNext(iter, target, other);
+
+        if (modListener.cull && !DrawManIsInstanceVisible(target))
+            return EventTrapIterNext(iter, target, other);
+
         bool (*listener)(EventTrapIter*, HLDInstance*, HLDInstance*) =
-            *FoxArrayMIndex(void*, modListeners, iter->nextIdx++);
+            modListener.func;
+        ProfileManEnterMod(modListener.modIdx);
         result = listener(iter, target, other);
+        ProfileManLeaveMod();
     } else if (trap->origListener) {
+        ProfileManEnterMod(MOD_NULL);
         trap->origListener(target, other);
+        ProfileManLeaveMod();
     }
 
     return result;
@@ -163,8 +190,10 @@ static void CommonEventListener(HLDInstance* target, HLDInstance* other) {
     EventTrapIterInit(&iter, trap);
     /* If draw event, set draw stage. */
     CoreStage origStage = stage;
-    if (currentEvent.type == HLD_EVENT_DRAW)
+    if (currentEvent.type == HLD_EVENT_DRAW) {
         stage = STAGE_DRAW;
+        DrawManUpdateDrawVisibility();
+    }
 
     /* Execute listeners and check if event was canceled. */
     if (!EventTrapIterNext(&iter, target, other)) {
@@ -427,7 +456,9 @@ void EventManRegisterEventListener(HLDObject* obj,
                                    EventKey key,
                                    bool (*listener)(AEREvent*,
                                                     AERInstance*,
-                                                    AERInstance*)) {
+                                                    AERInstance*),
+                                   int32_t modIdx,
+                                   bool cull) {
     /* Register subscription if subscribable event. */
     switch (key.type) {
         case HLD_EVENT_ALARM:
@@ -445,7 +476,14 @@ void EventManRegisterEventListener(HLDObject* obj,
         *trap = EntrapEvent(obj, key.type, key.num);
     }
 
-    EventTrapAddListener(trap, listener);
+    EventTrapAddListener(trap, listener, modIdx, cull);
+
+    return;
+}
+
+void EventManRemoveModListeners(int32_t modIdx) {
+    FoxMapMForEachElement(EventKey, EventTrap, &eventTraps,
+                          EventTrapRemoveModListenersCallback, &modIdx);
 
     return;
 }
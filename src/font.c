@@ -13,11 +13,416 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
 #include "aer/font.h"
+#include "internal/asset.h"
 #include "internal/core.h"
 #include "internal/err.h"
 #include "internal/export.h"
+#include "internal/font.h"
 #include "internal/hld.h"
+#include "internal/log.h"
+#include "internal/mod.h"
+
+/* ----- PRIVATE TYPES ----- */
+
+typedef struct FontMetrics {
+    int32_t first;
+    uint32_t numChars;
+    float lineHeight;
+    /* Advance of each character from `first` onwards in pixels. */
+    float* advances;
+} FontMetrics;
+
+typedef struct FontEntry {
+    /* Only known for mod fonts. */
+    char* path;
+    /* Loaded at registration, so queries never write to entries. */
+    FontMetrics* metrics;
+} FontEntry;
+
+/* ----- PRIVATE CONSTANTS ----- */
+
+static const uint32_t TTF_TAG_CMAP = 0x636d6170;
+
+static const uint32_t TTF_TAG_HEAD = 0x68656164;
+
+static const uint32_t TTF_TAG_HHEA = 0x68686561;
+
+static const uint32_t TTF_TAG_HMTX = 0x686d7478;
+
+static const size_t TTF_MAX_SIZE = 64 * 1024 * 1024;
+
+/* There are no more Unicode code points than this. */
+static const int64_t TTF_MAX_CHARS = 0x110000;
+
+/* ----- PRIVATE GLOBALS ----- */
+
+static FontEntry* fontEntries = NULL;
+
+static size_t numFontEntries = 0;
+
+/* ----- PRIVATE FUNCTIONS ----- */
+
+static FontEntry* AddFontEntry(int32_t fontIdx) {
+    assert(fontIdx >= 0);
+
+    if ((size_t)fontIdx >= numFontEntries) {
+        size_t numEntries = (size_t)fontIdx + 1;
+        fontEntries = realloc(fontEntries, numEntries * sizeof(FontEntry));
+        assert(fontEntries);
+        memset(fontEntries + numFontEntries, 0,
+               (numEntries - numFontEntries) * sizeof(FontEntry));
+        numFontEntries = numEntries;
+    }
+
+    return fontEntries + fontIdx;
+}
+
+static FontEntry* GetFontEntry(int32_t fontIdx) {
+    if (fontIdx < 0 || (size_t)fontIdx >= numFontEntries)
+        return NULL;
+
+    return fontEntries + fontIdx;
+}
+
+static inline uint16_t ReadU16(const uint8_t* data) {
+    return (uint16_t)((data[0] << 8) | data[1]);
+}
+
+static inline int16_t ReadI16(const uint8_t* data) {
+    return (int16_t)ReadU16(data);
+}
+
+static inline uint32_t ReadU32(const uint8_t* data) {
+    return ((uint32_t)data[0] << 24) | ((uint32_t)data[1] << 16) |
+           ((uint32_t)data[2] << 8) | data[3];
+}
+
+static const uint8_t* FindTable(const uint8_t* data,
+                                size_t size,
+                                uint32_t tag,
+                                size_t minSize) {
+    if (size < 12)
+        return NULL;
+
+    uint32_t numTables = ReadU16(data + 4);
+    if (size < 12 + numTables * 16)
+        return NULL;
+
+    for (uint32_t idx = 0; idx < numTables; idx++) {
+        const uint8_t* record = data + 12 + idx * 16;
+        if (ReadU32(record) != tag)
+            continue;
+
+        uint32_t offset = ReadU32(record + 8);
+        uint32_t length = ReadU32(record + 12);
+        if (offset > size || length > size - offset || length < minSize)
+            return NULL;
+        return data + offset;
+    }
+
+    return NULL;
+}
+
+/*
+ * Returns a Unicode subtable in format 4 or 12, preferring the latter since
+ * it also covers characters outside of the basic multilingual plane.
+ */
+static const uint8_t* FindCmapSubtable(const uint8_t* data,
+                                       size_t size,
+                                       const uint8_t* cmap) {
+    const uint8_t* end = data + size;
+    if (end - cmap < 4)
+        return NULL;
+
+    uint32_t numSubtables = ReadU16(cmap + 2);
+    if ((size_t)(end - cmap) < 4 + numSubtables * 8)
+        return NULL;
+
+    const uint8_t* result = NULL;
+    for (uint32_t idx = 0; idx < numSubtables; idx++) {
+        const uint8_t* record = cmap + 4 + idx * 8;
+        uint16_t platform = ReadU16(record);
+        uint16_t encoding = ReadU16(record + 2);
+        if (!(platform == 0 || (platform == 3 && (encoding == 1 ||
+                                                  encoding == 10))))
+            continue;
+
+        uint32_t offset = ReadU32(record + 4);
+        if (offset > (size_t)(end - cmap) - 8)
+            continue;
+
+        const uint8_t* subtable = cmap + offset;
+        uint16_t format = ReadU16(subtable);
+        if (format == 12)
+            return subtable;
+        if (format == 4 && !result)
+            result = subtable;
+    }
+
+    return result;
+}
+
+static uint32_t LookupGlyph(const uint8_t* data,
+                            size_t size,
+                            const uint8_t* subtable,
+                            uint32_t codepoint) {
+    size_t left = (size_t)(data + size - subtable);
+
+    if (ReadU16(subtable) == 12) {
+        if (left < 16)
+            return 0;
+
+        uint32_t numGroups = ReadU32(subtable + 12);
+        if ((left - 16) / 12 < numGroups)
+            return 0;
+
+        /* Groups are sorted, so binary search them. */
+        uint32_t low = 0;
+        uint32_t high = numGroups;
+        while (low < high) {
+            uint32_t mid = low + (high - low) / 2;
+            const uint8_t* group = subtable + 16 + mid * 12;
+            if (codepoint < ReadU32(group))
+                high = mid;
+            else if (codepoint > ReadU32(group + 4))
+                low = mid + 1;
+            else
+                return ReadU32(group + 8) + (codepoint - ReadU32(group));
+        }
+        return 0;
+    }
+
+    if (codepoint > 0xffff || left < 14)
+        return 0;
+
+    uint32_t segCountX2 = ReadU16(subtable + 6);
+    if (left < 16 + segCountX2 * 4)
+        return 0;
+
+    const uint8_t* endCodes = subtable + 14;
+    const uint8_t* startCodes = endCodes + segCountX2 + 2;
+    const uint8_t* idDeltas = startCodes + segCountX2;
+    const uint8_t* idRangeOffsets = idDeltas + segCountX2;
+    for (uint32_t seg = 0; seg < segCountX2; seg += 2) {
+        if (codepoint > ReadU16(endCodes + seg))
+            continue;
+        if (codepoint < ReadU16(startCodes + seg))
+            return 0;
+
+        uint16_t delta = ReadU16(idDeltas + seg);
+        uint16_t rangeOffset = ReadU16(idRangeOffsets + seg);
+        if (rangeOffset == 0)
+            return (uint16_t)(codepoint + delta);
+
+        const uint8_t* glyphPtr = idRangeOffsets + seg + rangeOffset +
+                                  (codepoint - ReadU16(startCodes + seg)) * 2;
+        if (glyphPtr + 2 > data + size)
+            return 0;
+
+        uint16_t glyph = ReadU16(glyphPtr);
+        return (glyph == 0) ? 0 : (uint16_t)(glyph + delta);
+    }
+
+    return 0;
+}
+
+static FontMetrics* ParseMetrics(const uint8_t* data,
+                                 size_t size,
+                                 HLDFont* font) {
+    const uint8_t* head = FindTable(data, size, TTF_TAG_HEAD, 54);
+    const uint8_t* hhea = FindTable(data, size, TTF_TAG_HHEA, 36);
+    const uint8_t* hmtx = FindTable(data, size, TTF_TAG_HMTX, 4);
+    const uint8_t* cmap = FindTable(data, size, TTF_TAG_CMAP, 4);
+    if (!(head && hhea && hmtx && cmap))
+        return NULL;
+
+    const uint8_t* subtable = FindCmapSubtable(data, size, cmap);
+    uint32_t unitsPerEm = ReadU16(head + 18);
+    uint32_t numHMetrics = ReadU16(hhea + 34);
+    if (!subtable || unitsPerEm == 0 || numHMetrics == 0 ||
+        (size_t)(data + size - hmtx) < numHMetrics * 4)
+        return NULL;
+
+    float scale = (float)font->size / (float)unitsPerEm;
+    int32_t first = font->first;
+    int64_t numChars =
+        (font->last >= first) ? (int64_t)font->last - first + 1 : 0;
+    if (numChars > TTF_MAX_CHARS)
+        return NULL;
+
+    FontMetrics* metrics = malloc(sizeof(FontMetrics));
+    assert(metrics);
+    metrics->first = first;
+    metrics->numChars = (uint32_t)numChars;
+    metrics->lineHeight =
+        roundf((ReadI16(hhea + 4) - ReadI16(hhea + 6) + ReadI16(hhea + 8)) *
+               scale);
+    metrics->advances = malloc(metrics->numChars * sizeof(float));
+    assert(metrics->advances || numChars == 0);
+
+    for (uint32_t idx = 0; idx < metrics->numChars; idx++) {
+        int64_t codepoint = (int64_t)first + idx;
+        uint32_t glyph = (codepoint < 0) ? 0
+                                         : LookupGlyph(data, size, subtable,
+                                                       (uint32_t)codepoint);
+        /* Glyphs past the last metric share its advance. */
+        uint32_t metricIdx = (glyph < numHMetrics) ? glyph : numHMetrics - 1;
+        float advance = (glyph == 0) ? 0.0f
+                                     : ReadU16(hmtx + metricIdx * 4) * scale;
+        metrics->advances[idx] = roundf(advance);
+    }
+
+    return metrics;
+}
+
+static FontMetrics* LoadMetrics(const char* path, HLDFont* font) {
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        LogWarn("Could not open font file \"%s\" to read its metrics.",
+                path);
+        return NULL;
+    }
+
+    uint8_t* data = NULL;
+    long size = -1;
+    if (fseek(file, 0, SEEK_END) == 0 && (size = ftell(file)) > 0 &&
+        (size_t)size <= TTF_MAX_SIZE && fseek(file, 0, SEEK_SET) == 0) {
+        data = malloc((size_t)size);
+        assert(data);
+        if (fread(data, 1, (size_t)size, file) != (size_t)size) {
+            free(data);
+            data = NULL;
+        }
+    }
+    fclose(file);
+
+    FontMetrics* metrics =
+        data ? ParseMetrics(data, (size_t)size, font) : NULL;
+    free(data);
+    if (!metrics)
+        LogWarn("Could not read metrics from font file \"%s\".", path);
+
+    return metrics;
+}
+
+static inline float GetAdvance(const FontMetrics* metrics,
+                               uint32_t codepoint) {
+    int64_t idx = (int64_t)codepoint - metrics->first;
+    if (idx < 0 || idx >= metrics->numChars)
+        return 0.0f;
+
+    return metrics->advances[idx];
+}
+
+/* Invalid sequences are decoded one byte at a time as themselves. */
+static uint32_t DecodeUTF8(const char** text) {
+    const uint8_t* bytes = (const uint8_t*)*text;
+    uint32_t codepoint = bytes[0];
+    uint32_t numCont = 0;
+
+    if (codepoint >= 0xf0 && codepoint < 0xf8) {
+        codepoint &= 0x07;
+        numCont = 3;
+    } else if (codepoint >= 0xe0) {
+        codepoint &= 0x0f;
+        numCont = 2;
+    } else if (codepoint >= 0xc0) {
+        codepoint &= 0x1f;
+        numCont = 1;
+    }
+    if (bytes[0] >= 0xf8)
+        numCont = 0;
+
+    for (uint32_t idx = 1; idx <= numCont; idx++) {
+        if ((bytes[idx] & 0xc0) != 0x80) {
+            (*text)++;
+            return bytes[0];
+        }
+        codepoint = (codepoint << 6) | (bytes[idx] & 0x3f);
+    }
+
+    *text += numCont + 1;
+    return codepoint;
+}
+
+/*
+ * Mirrors the engine's layout: "#" and newlines break lines ("\#" is a literal
+ * "#"), and lines wider than `width` are broken at their last space, which is
+ * dropped. Words wider than `width` are never broken.
+ */
+static void MeasureText(const FontMetrics* metrics,
+                        const char* text,
+                        uint32_t width,
+                        float* textWidth,
+                        uint32_t* numLines) {
+    float spaceAdvance = GetAdvance(metrics, ' ');
+    float maxWidth = 0.0f;
+    float lineWidth = 0.0f;
+    /* Width of the current line up to and including its last space. */
+    float breakWidth = -1.0f;
+    uint32_t lines = 1;
+
+    while (*text) {
+        uint32_t codepoint;
+        if (text[0] == '\\' && text[1] == '#') {
+            codepoint = '#';
+            text += 2;
+        } else if (text[0] == '#' || text[0] == '\n') {
+            maxWidth = fmaxf(maxWidth, lineWidth);
+            lineWidth = 0.0f;
+            breakWidth = -1.0f;
+            lines++;
+            text++;
+            continue;
+        } else {
+            codepoint = DecodeUTF8(&text);
+        }
+
+        float advance = GetAdvance(metrics, codepoint);
+        if (codepoint == ' ') {
+            breakWidth = lineWidth + advance;
+        } else if (lineWidth + advance > (float)width && breakWidth >= 0.0f) {
+            maxWidth = fmaxf(maxWidth, breakWidth - spaceAdvance);
+            lineWidth -= breakWidth;
+            breakWidth = -1.0f;
+            lines++;
+        }
+        lineWidth += advance;
+    }
+
+    *textWidth = fmaxf(maxWidth, lineWidth);
+    *numLines = lines;
+
+    return;
+}
+
+/* ----- INTERNAL FUNCTIONS ----- */
+
+void FontManDestructor(void) {
+    LogInfo("Deinitializing font module...");
+
+    for (size_t idx = 0; idx < numFontEntries; idx++) {
+        FontEntry* entry = fontEntries + idx;
+        free(entry->path);
+        if (entry->metrics) {
+            free(entry->metrics->advances);
+            free(entry->metrics);
+        }
+    }
+    free(fontEntries);
+    fontEntries = NULL;
+    numFontEntries = 0;
+
+    LogInfo("Done deinitializing font module.");
+    return;
+}
 
 /* ----- PUBLIC FUNCTIONS ----- */
 
@@ -31,7 +436,7 @@ AER_EXPORT int32_t AERFontGetCurrent(void) {
 
 AER_EXPORT void AERFontSetCurrent(int32_t fontIdx) {
 #define errRet
-    EnsureStagePast(STAGE_FONT_REG);
+    EnsureStagePastMut(STAGE_FONT_REG);
     EnsureLookup(HLDFontLookup(fontIdx));
 
     hldfuncs.actionDrawSetFont(fontIdx);
@@ -54,11 +459,20 @@ AER_EXPORT int32_t AERFontRegister(const char* filename,
             curMod->name);
     EnsureStageStrict(STAGE_FONT_REG);
 
+    const char* path = CoreGetAbsAssetPath(curMod->name, filename);
+    Ensure(AssetManValidate(path, NULL, NULL), AER_BAD_FILE);
     int32_t fontIdx =
-        hldfuncs.actionFontAdd(CoreGetAbsAssetPath(curMod->name, filename),
-                               size, bold, italic, first, last);
+        hldfuncs.actionFontAdd(path, size, bold, italic, first, last);
     Ensure(HLDFontLookup(fontIdx), AER_BAD_FILE);
 
+    /* Metrics are read now so that queries never touch the file system. */
+    FontEntry* entry = AddFontEntry(fontIdx);
+    size_t pathSize = strlen(path) + 1;
+    entry->path = malloc(pathSize);
+    assert(entry->path);
+    memcpy(entry->path, path, pathSize);
+    entry->metrics = LoadMetrics(path, HLDFontLookup(fontIdx));
+
     LogInfo("Successfully registered font to index %i.", fontIdx);
 
     Ok(fontIdx);
@@ -137,4 +551,60 @@ AER_EXPORT int32_t AERFontGetLast(int32_t fontIdx) {
 
     Ok(font->last);
 #undef errRet
-}
\ No newline at end of file
+}
+
+AER_EXPORT float AERFontGetGlyphAdvance(int32_t fontIdx, uint32_t codepoint) {
+#define errRet -1.0f
+    EnsureStagePast(STAGE_FONT_REG);
+
+    EnsureLookup(HLDFontLookup(fontIdx));
+    FontEntry* entry = GetFontEntry(fontIdx);
+    EnsureLookup(entry && entry->path);
+    FontMetrics* metrics = entry->metrics;
+    Ensure(metrics, AER_FAILED_PARSE);
+
+    Ok(GetAdvance(metrics, codepoint));
+#undef errRet
+}
+
+AER_EXPORT float AERFontGetLineHeight(int32_t fontIdx) {
+#define errRet -1.0f
+    EnsureStagePast(STAGE_FONT_REG);
+
+    EnsureLookup(HLDFontLookup(fontIdx));
+    FontEntry* entry = GetFontEntry(fontIdx);
+    EnsureLookup(entry && entry->path);
+    FontMetrics* metrics = entry->metrics;
+    Ensure(metrics, AER_FAILED_PARSE);
+
+    Ok(metrics->lineHeight);
+#undef errRet
+}
+
+AER_EXPORT void AERFontMeasureText(int32_t fontIdx,
+                                   const char* text,
+                                   uint32_t width,
+                                   float* textWidth,
+                                   float* textHeight) {
+#define errRet
+    EnsureStagePast(STAGE_FONT_REG);
+    EnsureArg(text);
+    EnsureArg(textWidth || textHeight);
+
+    EnsureLookup(HLDFontLookup(fontIdx));
+    FontEntry* entry = GetFontEntry(fontIdx);
+    EnsureLookup(entry && entry->path);
+    FontMetrics* metrics = entry->metrics;
+    Ensure(metrics, AER_FAILED_PARSE);
+
+    float measuredWidth;
+    uint32_t numLines;
+    MeasureText(metrics, text, width, &measuredWidth, &numLines);
+    if (textWidth)
+        *textWidth = measuredWidth;
+    if (textHeight)
+        *textHeight = numLines * metrics->lineHeight;
+
+    Ok();
+#undef errRet
+}
@@ -14,22 +14,26 @@
  * limitations under the License.
  */
 #include <assert.h>
+#include <stddef.h>
 
 #include "foxutils/arraymacs.h"
 #include "foxutils/mapmacs.h"
 #include "foxutils/math.h"
 #include "foxutils/stringmapmacs.h"
 
+#include "aer/fast.h"
 #include "aer/instance.h"
 #include "aer/object.h"
 #include "aer/sprite.h"
 #include "internal/core.h"
+#include "internal/draw.h"
 #include "internal/err.h"
 #include "internal/export.h"
 #include "internal/hld.h"
 #include "internal/instance.h"
 #include "internal/log.h"
 #include "internal/object.h"
+#include "internal/sprite.h"
 
 /* ----- PRIVATE MACROS ----- */
 
@@ -54,6 +58,12 @@ typedef struct ModLocalVal {
     void (*destructor)(AERLocal*);
 } ModLocalVal;
 
+typedef struct RelocateDestructorsContext {
+    int32_t modIdx;
+    void* (*relocate)(void*, void*);
+    void* ctx;
+} RelocateDestructorsContext;
+
 typedef struct GetByObjectContext {
     size_t numInsts;
     size_t bufIdx;
@@ -67,6 +77,26 @@ static FoxMap hldLocals = {0};
 
 static FoxMap modLocals = {0};
 
+/* ----- PUBLIC GLOBALS ----- */
+
+AER_EXPORT const AERFastLayout aerFastLayout = {
+    .version = AER_FAST_LAYOUT_VERSION,
+    .depth = offsetof(HLDInstance, depth),
+    .id = offsetof(HLDInstance, id),
+    .objectIndex = offsetof(HLDInstance, objectIndex),
+    .visible = offsetof(HLDInstance, visible),
+    .spriteIndex = offsetof(HLDInstance, spriteIndex),
+    .imageIndex = offsetof(HLDInstance, imageIndex),
+    .imageSpeed = offsetof(HLDInstance, imageSpeed),
+    .imageAlpha = offsetof(HLDInstance, imageAlpha),
+    .imageAngle = offsetof(HLDInstance, imageAngle),
+    .imageBlend = offsetof(HLDInstance, imageBlend),
+    .maskIndex = offsetof(HLDInstance, maskIndex),
+    .friction = offsetof(HLDInstance, friction),
+    .imageScale = offsetof(HLDInstance, imageScale),
+    .pos = offsetof(HLDInstance, pos),
+    .speedX = offsetof(HLDInstance, speedX)};
+
 /* ----- PRIVATE FUNCTIONS ----- */
 
 static bool GetByObjectCallback(const int32_t* objIdx,
@@ -123,8 +153,30 @@ static bool ModLocalKeyGetOrphansCallback(const ModLocalKey* key,
     return true;
 }
 
+static bool ModLocalRelocateDestructorCallback(
+    const ModLocalKey* key,
+    ModLocalVal* val,
+    RelocateDestructorsContext* ctx) {
+    if (key->modIdx == ctx->modIdx && val->destructor)
+        val->destructor = ctx->relocate(val->destructor, ctx->ctx);
+
+    return true;
+}
+
 /* ----- INTERNAL FUNCTIONS ----- */
 
+void InstanceManRelocateModLocalDestructors(int32_t modIdx,
+                                            void* (*relocate)(void* sym,
+                                                              void* ctx),
+                                            void* ctx) {
+    RelocateDestructorsContext relocCtx = {
+        .modIdx = modIdx, .relocate = relocate, .ctx = ctx};
+    FoxMapMForEachPair(ModLocalKey, ModLocalVal, &modLocals,
+                       ModLocalRelocateDestructorCallback, &relocCtx);
+
+    return;
+}
+
 void InstanceManPruneModLocals(void) {
     LogInfo("Pruning mod instance locals...");
 
@@ -247,7 +299,7 @@ AER_EXPORT AERInstance* AERInstanceGetById(int32_t instId) {
 
 AER_EXPORT AERInstance* AERInstanceCreate(int32_t objIdx, float x, float y) {
 #define errRet NULL
-    EnsureStage(STAGE_ACTION);
+    EnsureStageMut(STAGE_ACTION);
     EnsureLookup(HLDObjectLookup(objIdx));
 
     AERInstance* inst =
@@ -262,7 +314,7 @@ AER_EXPORT void AERInstanceChange(AERInstance* inst,
                                   int32_t newObjIdx,
                                   bool doEvents) {
 #define errRet
-    EnsureStage(STAGE_ACTION);
+    EnsureStageMut(STAGE_ACTION);
     EnsureArg(inst);
     EnsureLookup(HLDObjectLookup(newObjIdx));
 
@@ -274,7 +326,7 @@ AER_EXPORT void AERInstanceChange(AERInstance* inst,
 
 AER_EXPORT void AERInstanceDestroy(AERInstance* inst) {
 #define errRet
-    EnsureStage(STAGE_ACTION);
+    EnsureStageMut(STAGE_ACTION);
     EnsureArg(inst);
 
     hldfuncs.actionInstanceDestroy((HLDInstance*)inst, (HLDInstance*)inst, -1,
@@ -286,7 +338,7 @@ AER_EXPORT void AERInstanceDestroy(AERInstance* inst) {
 
 AER_EXPORT void AERInstanceDelete(AERInstance* inst) {
 #define errRet
-    EnsureStage(STAGE_ACTION);
+    EnsureStageMut(STAGE_ACTION);
     EnsureArg(inst);
 
     hldfuncs.actionInstanceDestroy((HLDInstance*)inst, (HLDInstance*)inst, -1,
@@ -307,7 +359,7 @@ AER_EXPORT float AERInstanceGetDepth(AERInstance* inst) {
 
 AER_EXPORT void AERInstanceSetDepth(AERInstance* inst, float depth) {
 #define errRet
-    EnsureStage(STAGE_ACTION);
+    EnsureStageMut(STAGE_ACTION);
     EnsureArg(inst);
 
     ((HLDInstance*)inst)->depth = depth;
@@ -318,7 +370,7 @@ AER_EXPORT void AERInstanceSetDepth(AERInstance* inst, float depth) {
 
 AER_EXPORT void AERInstanceSyncDepth(AERInstance* inst) {
 #define errRet
-    EnsureStage(STAGE_ACTION);
+    EnsureStageMut(STAGE_ACTION);
     EnsureArg(inst);
 
     HLDScriptCallAdv(hldfuncs.Script_Setdepth, (HLDInstance*)inst,
@@ -372,7 +424,7 @@ AER_EXPORT bool AERInstanceGetDeactivated(AERInstance* inst) {
 
 AER_EXPORT void AERInstanceSetDeactivated(AERInstance* inst, bool deactivated) {
 #define errRet
-    EnsureStage(STAGE_ACTION);
+    EnsureStageMut(STAGE_ACTION);
     EnsureArg(inst);
 
     ((HLDInstance*)inst)->deactivated = deactivated;
@@ -392,7 +444,7 @@ AER_EXPORT bool AERInstanceGetPersistent(AERInstance* inst) {
 
 AER_EXPORT void AERInstanceSetPersistent(AERInstance* inst, bool persistent) {
 #define errRet
-    EnsureStage(STAGE_ACTION);
+    EnsureStageMut(STAGE_ACTION);
     EnsureArg(inst);
 
     ((HLDInstance*)inst)->persistent = persistent;
@@ -422,7 +474,7 @@ AER_EXPORT void AERInstanceGetPosition(AERInstance* inst, float* x, float* y) {
 AER_EXPORT void AERInstanceSetPosition(AERInstance* inst, float x, float y) {
 #define errRet
 #define inst ((HLDInstance*)inst)
-    EnsureStage(STAGE_ACTION);
+    EnsureStageMut(STAGE_ACTION);
     EnsureArg(inst);
 
     hldfuncs.Instance_setPosition(inst, x, y);
@@ -435,7 +487,7 @@ AER_EXPORT void AERInstanceSetPosition(AERInstance* inst, float x, float y) {
 AER_EXPORT void AERInstanceAddPosition(AERInstance* inst, float x, float y) {
 #define errRet
 #define inst ((HLDInstance*)inst)
-    EnsureStage(STAGE_ACTION);
+    EnsureStageMut(STAGE_ACTION);
     EnsureArg(inst);
 
     HLDVecReal pos = inst->pos;
@@ -472,6 +524,27 @@ AER_EXPORT void AERInstanceGetBoundingBox(AERInstance* inst,
 #undef errRet
 }
 
+AER_EXPORT bool AERInstanceIsOnScreen(AERInstance* inst) {
+#define errRet false
+#define inst ((HLDInstance*)inst)
+    EnsureStage(STAGE_ACTION);
+    EnsureArg(inst);
+
+    Ok(DrawManIsInstanceVisible(inst));
+#undef inst
+#undef errRet
+}
+
+AER_EXPORT size_t AERInstanceGetOnScreen(size_t bufSize,
+                                         AERInstance** instBuf) {
+#define errRet 0
+    EnsureStage(STAGE_ACTION);
+    EnsureArgBuf(instBuf, bufSize);
+
+    Ok(DrawManGetVisibleInstances(bufSize, (HLDInstance**)instBuf));
+#undef errRet
+}
+
 AER_EXPORT float AERInstanceGetFriction(AERInstance* inst) {
 #define errRet 0.0f
     EnsureStage(STAGE_ACTION);
@@ -483,7 +556,7 @@ AER_EXPORT float AERInstanceGetFriction(AERInstance* inst) {
 
 AER_EXPORT void AERInstanceSetFriction(AERInstance* inst, float friction) {
 #define errRet
-    EnsureStage(STAGE_ACTION);
+    EnsureStageMut(STAGE_ACTION);
     EnsureArg(inst);
 
     ((HLDInstance*)inst)->friction = friction;
@@ -512,7 +585,7 @@ AER_EXPORT void AERInstanceGetMotion(AERInstance* inst, float* x, float* y) {
 AER_EXPORT void AERInstanceSetMotion(AERInstance* inst, float x, float y) {
 #define errRet
 #define inst ((HLDInstance*)inst)
-    EnsureStage(STAGE_ACTION);
+    EnsureStageMut(STAGE_ACTION);
     EnsureArg(inst);
 
     inst->speedX = x;
@@ -527,7 +600,7 @@ AER_EXPORT void AERInstanceSetMotion(AERInstance* inst, float x, float y) {
 AER_EXPORT void AERInstanceAddMotion(AERInstance* inst, float x, float y) {
 #define errRet
 #define inst ((HLDInstance*)inst)
-    EnsureStage(STAGE_ACTION);
+    EnsureStageMut(STAGE_ACTION);
     EnsureArg(inst);
 
     inst->speedX += x;
@@ -550,16 +623,41 @@ AER_EXPORT int32_t AERInstanceGetMask(AERInstance* inst) {
 
 AER_EXPORT void AERInstanceSetMask(AERInstance* inst, int32_t maskIdx) {
 #define errRet
-    EnsureStage(STAGE_ACTION);
+    EnsureStageMut(STAGE_ACTION);
     EnsureArg(inst);
     EnsureLookup(maskIdx == AER_SPRITE_NULL || HLDSpriteLookup(maskIdx));
 
+    Ensure(SpriteManLoadPending(maskIdx), AER_SEQ_BREAK);
     hldfuncs.Instance_setMaskIndex((HLDInstance*)inst, maskIdx);
 
     Ok();
 #undef errRet
 }
 
+AER_EXPORT bool AERInstanceMasksOverlap(AERInstance* instA,
+                                        AERInstance* instB) {
+#define errRet false
+#define instA ((HLDInstance*)instA)
+#define instB ((HLDInstance*)instB)
+    EnsureStage(STAGE_ACTION);
+    EnsureArg(instA);
+    EnsureArg(instB);
+
+    int32_t maskIdxA = (instA->maskIndex != AER_SPRITE_NULL)
+                           ? instA->maskIndex
+                           : instA->spriteIndex;
+    int32_t maskIdxB = (instB->maskIndex != AER_SPRITE_NULL)
+                           ? instB->maskIndex
+                           : instB->spriteIndex;
+
+    Ok(SpriteManMasksOverlap(maskIdxA, instA->imageIndex, instA->pos.x,
+                             instA->pos.y, maskIdxB, instB->imageIndex,
+                             instB->pos.x, instB->pos.y));
+#undef instB
+#undef instA
+#undef errRet
+}
+
 AER_EXPORT bool AERInstanceGetVisible(AERInstance* inst) {
 #define errRet false
     EnsureStage(STAGE_ACTION);
@@ -571,7 +669,7 @@ AER_EXPORT bool AERInstanceGetVisible(AERInstance* inst) {
 
 AER_EXPORT void AERInstanceSetVisible(AERInstance* inst, bool visible) {
 #define errRet
-    EnsureStage(STAGE_ACTION);
+    EnsureStageMut(STAGE_ACTION);
     EnsureArg(inst);
 
     ((HLDInstance*)inst)->visible = visible;
@@ -591,10 +689,11 @@ AER_EXPORT int32_t AERInstanceGetSprite(AERInstance* inst) {
 
 AER_EXPORT void AERInstanceSetSprite(AERInstance* inst, int32_t spriteIdx) {
 #define errRet
-    EnsureStage(STAGE_ACTION);
+    EnsureStageMut(STAGE_ACTION);
     EnsureArg(inst);
     EnsureLookup(spriteIdx == AER_SPRITE_NULL || HLDSpriteLookup(spriteIdx));
 
+    Ensure(SpriteManLoadPending(spriteIdx), AER_SEQ_BREAK);
     ((HLDInstance*)inst)->spriteIndex = spriteIdx;
 
     Ok();
@@ -612,7 +711,7 @@ AER_EXPORT float AERInstanceGetSpriteFrame(AERInstance* inst) {
 
 AER_EXPORT void AERInstanceSetSpriteFrame(AERInstance* inst, float frame) {
 #define errRet
-    EnsureStage(STAGE_ACTION);
+    EnsureStageMut(STAGE_ACTION);
     EnsureArg(inst);
 
     ((HLDInstance*)inst)->imageIndex = frame;
@@ -632,7 +731,7 @@ AER_EXPORT float AERInstanceGetSpriteSpeed(AERInstance* inst) {
 
 AER_EXPORT void AERInstanceSetSpriteSpeed(AERInstance* inst, float speed) {
 #define errRet
-    EnsureStage(STAGE_ACTION);
+    EnsureStageMut(STAGE_ACTION);
     EnsureArg(inst);
     EnsureMin(speed, 0.0f);
 
@@ -653,7 +752,7 @@ AER_EXPORT float AERInstanceGetSpriteAlpha(AERInstance* inst) {
 
 AER_EXPORT void AERInstanceSetSpriteAlpha(AERInstance* inst, float alpha) {
 #define errRet
-    EnsureStage(STAGE_ACTION);
+    EnsureStageMut(STAGE_ACTION);
     EnsureArg(inst);
     EnsureProba(alpha);
 
@@ -674,7 +773,7 @@ AER_EXPORT float AERInstanceGetSpriteAngle(AERInstance* inst) {
 
 AER_EXPORT void AERInstanceSetSpriteAngle(AERInstance* inst, float angle) {
 #define errRet
-    EnsureStage(STAGE_ACTION);
+    EnsureStageMut(STAGE_ACTION);
     EnsureArg(inst);
 
     ((HLDInstance*)inst)->imageAngle = angle;
@@ -705,7 +804,7 @@ AER_EXPORT void AERInstanceGetSpriteScale(AERInstance* inst,
 AER_EXPORT void AERInstanceSetSpriteScale(AERInstance* inst, float x, float y) {
 #define errRet
 #define inst ((HLDInstance*)inst)
-    EnsureStage(STAGE_ACTION);
+    EnsureStageMut(STAGE_ACTION);
     EnsureArg(inst);
 
     inst->imageScale.x = x;
@@ -727,7 +826,7 @@ AER_EXPORT uint32_t AERInstanceGetSpriteBlend(AERInstance* inst) {
 
 AER_EXPORT void AERInstanceSetSpriteBlend(AERInstance* inst, uint32_t color) {
 #define errRet
-    EnsureStage(STAGE_ACTION);
+    EnsureStageMut(STAGE_ACTION);
     EnsureArg(inst);
 
     ((HLDInstance*)inst)->imageBlend = color;
@@ -747,7 +846,7 @@ AER_EXPORT bool AERInstanceGetTangible(AERInstance* inst) {
 
 AER_EXPORT void AERInstanceSetTangible(AERInstance* inst, bool tangible) {
 #define errRet
-    EnsureStage(STAGE_ACTION);
+    EnsureStageMut(STAGE_ACTION);
     EnsureArg(inst);
 
     ((HLDInstance*)inst)->tangible = tangible;
@@ -770,7 +869,7 @@ AER_EXPORT void AERInstanceSetAlarm(AERInstance* inst,
                                     uint32_t alarmIdx,
                                     int32_t numSteps) {
 #define errRet
-    EnsureStage(STAGE_ACTION);
+    EnsureStageMut(STAGE_ACTION);
     EnsureArg(inst);
     EnsureMax(alarmIdx, 11);
 
@@ -833,7 +932,7 @@ AER_EXPORT AERLocal* AERInstanceCreateModLocal(
     bool public,
     void (*destructor)(AERLocal* local)) {
 #define errRet NULL
-    EnsureStage(STAGE_ACTION);
+    EnsureStageMut(STAGE_ACTION);
     EnsureArg(inst);
     EnsureArg(name);
 
@@ -854,7 +953,7 @@ AER_EXPORT void AERInstanceDestroyModLocal(AERInstance* inst,
                                            const char* name,
                                            bool public) {
 #define errRet
-    EnsureStage(STAGE_ACTION);
+    EnsureStageMut(STAGE_ACTION);
     EnsureArg(inst);
     EnsureArg(name);
 
@@ -877,7 +976,7 @@ AER_EXPORT AERLocal AERInstanceDeleteModLocal(AERInstance* inst,
                                               const char* name,
                                               bool public) {
 #define errRet (AERLocal){0};
-    EnsureStage(STAGE_ACTION);
+    EnsureStageMut(STAGE_ACTION);
     EnsureArg(inst);
     EnsureArg(name);
 
@@ -0,0 +1,519 @@
+/**
+ * @copyright 2021 the libaermre authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <assert.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "foxutils/arraymacs.h"
+#include "foxutils/mapmacs.h"
+
+#include "aer/job.h"
+#include "internal/core.h"
+#include "internal/err.h"
+#include "internal/export.h"
+#include "internal/job.h"
+#include "internal/log.h"
+#include "internal/mod.h"
+#include "internal/option.h"
+#include "internal/profile.h"
+
+/* ----- PRIVATE TYPES ----- */
+
+typedef struct Job {
+    uint64_t id;
+    void (*func)(void*);
+    void (*callback)(void*);
+    void* arg;
+    int32_t modIdx;
+    uint32_t numPendingDeps;
+    bool done;
+    FoxArray dependents;
+} Job;
+
+/*
+ * Owners push and pop at the back while thieves take from the front, so the
+ * oldest (and usually largest) work gets stolen first.
+ */
+typedef struct JobDeque {
+    pthread_mutex_t mutex;
+    Job** jobs;
+    uint32_t capacity;
+    uint32_t head;
+    uint32_t size;
+} JobDeque;
+
+/* ----- PRIVATE CONSTANTS ----- */
+
+static const uint32_t DEQUE_INIT_CAPACITY = 64;
+
+static const long WAIT_POLL_NS = 1000000;
+
+/* ----- PRIVATE GLOBALS ----- */
+
+static pthread_t* workers = NULL;
+
+static JobDeque* deques = NULL;
+
+static uint32_t numWorkers = 0;
+
+static uint32_t nextDequeIdx = 0;
+
+static uint32_t numQueued = 0;
+
+static bool stopping = false;
+
+static pthread_mutex_t sleepMutex = PTHREAD_MUTEX_INITIALIZER;
+
+static pthread_cond_t wakeCond = PTHREAD_COND_INITIALIZER;
+
+/* Guards everything below, as well as the `done` and dependency fields of
+ * every job. */
+static pthread_mutex_t tableMutex = PTHREAD_MUTEX_INITIALIZER;
+
+static pthread_cond_t doneCond = PTHREAD_COND_INITIALIZER;
+
+static FoxMap jobTable = {0};
+
+static FoxArray finishedJobs = {0};
+
+static FoxArray dispatchJobs = {0};
+
+static uint64_t nextJobId = 1;
+
+static uint32_t numUnfinished = 0;
+
+static __thread int32_t workerIdx = -1;
+
+/* ----- PRIVATE FUNCTIONS ----- */
+
+static void JobDequeInit(JobDeque* deque) {
+    pthread_mutex_init(&deque->mutex, NULL);
+    deque->jobs = malloc(DEQUE_INIT_CAPACITY * sizeof(Job*));
+    assert(deque->jobs);
+    deque->capacity = DEQUE_INIT_CAPACITY;
+    deque->head = 0;
+    deque->size = 0;
+
+    return;
+}
+
+static void JobDequeDeinit(JobDeque* deque) {
+    pthread_mutex_destroy(&deque->mutex);
+    free(deque->jobs);
+    *deque = (JobDeque){0};
+
+    return;
+}
+
+static void JobDequePushBack(JobDeque* deque, Job* job) {
+    pthread_mutex_lock(&deque->mutex);
+
+    if (deque->size == deque->capacity) {
+        uint32_t newCapacity = deque->capacity * 2;
+        Job** newJobs = malloc(newCapacity * sizeof(Job*));
+        assert(newJobs);
+        for (uint32_t idx = 0; idx < deque->size; idx++) {
+            newJobs[idx] = deque->jobs[(deque->head + idx) % deque->capacity];
+        }
+        free(deque->jobs);
+        deque->jobs = newJobs;
+        deque->capacity = newCapacity;
+        deque->head = 0;
+    }
+    deque->jobs[(deque->head + deque->size++) % deque->capacity] = job;
+
+    pthread_mutex_unlock(&deque->mutex);
+    return;
+}
+
+static Job* JobDequePopBack(JobDeque* deque) {
+    Job* job = NULL;
+    pthread_mutex_lock(&deque->mutex);
+
+    if (deque->size > 0)
+        job = deque->jobs[(deque->head + --deque->size) % deque->capacity];
+
+    pthread_mutex_unlock(&deque->mutex);
+    return job;
+}
+
+static Job* JobDequePopFront(JobDeque* deque) {
+    Job* job = NULL;
+    pthread_mutex_lock(&deque->mutex);
+
+    if (deque->size > 0) {
+        job = deque->jobs[deque->head];
+        deque->head = (deque->head + 1) % deque->capacity;
+        deque->size--;
+    }
+
+    pthread_mutex_unlock(&deque->mutex);
+    return job;
+}
+
+static void JobEnqueue(Job* job) {
+    /* Workers keep their own work local; everyone else spreads it out. */
+    uint32_t dequeIdx =
+        (workerIdx >= 0)
+            ? (uint32_t)workerIdx
+            : __atomic_fetch_add(&nextDequeIdx, 1, __ATOMIC_RELAXED) %
+                  numWorkers;
+    JobDequePushBack(deques + dequeIdx, job);
+    __atomic_fetch_add(&numQueued, 1, __ATOMIC_RELEASE);
+
+    pthread_mutex_lock(&sleepMutex);
+    pthread_cond_signal(&wakeCond);
+    pthread_mutex_unlock(&sleepMutex);
+
+    return;
+}
+
+static Job* JobTake(void) {
+    if (__atomic_load_n(&numQueued, __ATOMIC_ACQUIRE) == 0)
+        return NULL;
+
+    Job* job = NULL;
+    uint32_t startIdx = 0;
+    if (workerIdx >= 0) {
+        startIdx = (uint32_t)workerIdx;
+        job = JobDequePopBack(deques + startIdx);
+    }
+    for (uint32_t idx = 0; !job && idx < numWorkers; idx++) {
+        job = JobDequePopFront(deques + (startIdx + idx) % numWorkers);
+    }
+    if (job)
+        __atomic_fetch_sub(&numQueued, 1, __ATOMIC_RELAXED);
+
+    return job;
+}
+
+static void JobRun(Job* job) {
+    /*
+     * The main thread may run jobs while waiting on one, so make sure the job
+     * sees the same (lack of) stage that it would on a worker thread.
+     */
+    CoreStage origStage = stage;
+    stage = STAGE_INIT;
+    job->func(job->arg);
+    stage = origStage;
+
+    pthread_mutex_lock(&tableMutex);
+    job->done = true;
+    numUnfinished--;
+    size_t numDependents = FoxArrayMSize(Job*, &job->dependents);
+    for (uint32_t idx = 0; idx < numDependents; idx++) {
+        Job* dependent = *FoxArrayMIndex(Job*, &job->dependents, idx);
+        if (--dependent->numPendingDeps == 0)
+            JobEnqueue(dependent);
+    }
+    *FoxArrayMPush(Job*, &finishedJobs) = job;
+    pthread_cond_broadcast(&doneCond);
+    pthread_mutex_unlock(&tableMutex);
+
+    return;
+}
+
+static void* JobWorker(void* ctx) {
+    workerIdx = (int32_t)(intptr_t)ctx;
+    ErrUseThreadLocal();
+
+    while (true) {
+        Job* job = JobTake();
+        if (job) {
+            JobRun(job);
+            continue;
+        }
+
+        pthread_mutex_lock(&sleepMutex);
+        while (!stopping && __atomic_load_n(&numQueued, __ATOMIC_ACQUIRE) == 0)
+            pthread_cond_wait(&wakeCond, &sleepMutex);
+        bool stop =
+            stopping && __atomic_load_n(&numQueued, __ATOMIC_ACQUIRE) == 0;
+        pthread_mutex_unlock(&sleepMutex);
+        if (stop)
+            break;
+    }
+
+    return NULL;
+}
+
+/* Must be called with `tableMutex` held. */
+static bool JobIsDoneLocked(uint64_t jobId) {
+    if (jobId == AER_JOB_NULL)
+        return numUnfinished == 0;
+
+    Job** job = FoxMapMIndex(uint64_t, Job*, &jobTable, jobId);
+    return !job || (*job)->done;
+}
+
+/* Help run queued jobs until the given job (or all jobs) finish. */
+static void JobHelpUntilDone(uint64_t jobId) {
+    while (true) {
+        pthread_mutex_lock(&tableMutex);
+        bool done = JobIsDoneLocked(jobId);
+        pthread_mutex_unlock(&tableMutex);
+        if (done)
+            break;
+
+        Job* job = JobTake();
+        if (job) {
+            JobRun(job);
+            continue;
+        }
+
+        /*
+         * Jobs that become runnable don't signal `doneCond`, so poll in case
+         * this thread is the only one free to run them.
+         */
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_nsec += WAIT_POLL_NS;
+        if (deadline.tv_nsec >= 1000000000) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000;
+        }
+        pthread_mutex_lock(&tableMutex);
+        if (!JobIsDoneLocked(jobId))
+            pthread_cond_timedwait(&doneCond, &tableMutex, &deadline);
+        pthread_mutex_unlock(&tableMutex);
+    }
+
+    return;
+}
+
+static uint64_t JobSubmit(void (*func)(void*),
+                          void* arg,
+                          void (*callback)(void*),
+                          size_t numDeps,
+                          const uint64_t* deps,
+                          Mod* mod) {
+    Job* job = malloc(sizeof(Job));
+    assert(job);
+    *job = (Job){
+        .func = func,
+        .callback = callback,
+        .arg = arg,
+        .modIdx = (mod) ? mod->idx : MOD_NULL,
+    };
+    FoxArrayMInit(Job*, &job->dependents);
+
+    pthread_mutex_lock(&tableMutex);
+    uint64_t jobId = job->id = nextJobId++;
+    *FoxMapMInsert(uint64_t, Job*, &jobTable, jobId) = job;
+    numUnfinished++;
+    for (uint32_t idx = 0; idx < numDeps; idx++) {
+        Job** dep = FoxMapMIndex(uint64_t, Job*, &jobTable, deps[idx]);
+        if (dep && !(*dep)->done) {
+            *FoxArrayMPush(Job*, &(*dep)->dependents) = job;
+            job->numPendingDeps++;
+        }
+    }
+    if (job->numPendingDeps == 0)
+        JobEnqueue(job);
+    pthread_mutex_unlock(&tableMutex);
+
+    return jobId;
+}
+
+/* ----- INTERNAL FUNCTIONS ----- */
+
+uint64_t JobManSubmit(void (*func)(void*), void* arg, int32_t modIdx) {
+    assert(func);
+
+    return JobSubmit(func, arg, NULL, 0, NULL,
+                     (modIdx == MOD_NULL) ? NULL : ModManGetMod(modIdx));
+}
+
+void JobManWait(uint64_t jobId) {
+    assert(jobId != AER_JOB_NULL);
+
+    JobHelpUntilDone(jobId);
+
+    return;
+}
+
+void JobManDispatchCallbacks(void) {
+    pthread_mutex_lock(&tableMutex);
+    if (FoxArrayMEmpty(Job*, &finishedJobs)) {
+        pthread_mutex_unlock(&tableMutex);
+        return;
+    }
+    FoxArray tmp = finishedJobs;
+    finishedJobs = dispatchJobs;
+    dispatchJobs = tmp;
+    size_t numJobs = FoxArrayMSize(Job*, &dispatchJobs);
+    for (uint32_t idx = 0; idx < numJobs; idx++) {
+        Job* job = *FoxArrayMIndex(Job*, &dispatchJobs, idx);
+        (void)FoxMapMRemove(uint64_t, Job*, &jobTable, job->id);
+    }
+    pthread_mutex_unlock(&tableMutex);
+
+    /* Call completion callbacks in completion order. */
+    for (uint32_t idx = 0; idx < numJobs; idx++) {
+        Job* job = *FoxArrayMIndex(Job*, &dispatchJobs, idx);
+        if (job->callback) {
+            ProfileManEnterMod(job->modIdx);
+            job->callback(job->arg);
+            ProfileManLeaveMod();
+        }
+        FoxArrayMDeinit(Job*, &job->dependents);
+        free(job);
+    }
+    while (!FoxArrayMEmpty(Job*, &dispatchJobs)) {
+        FoxArrayMPop(Job*, &dispatchJobs);
+    }
+
+    return;
+}
+
+void JobManFinishAll(void) {
+    JobHelpUntilDone(AER_JOB_NULL);
+    JobManDispatchCallbacks();
+
+    return;
+}
+
+void JobManConstructor(void) {
+    LogInfo("Initializing job module...");
+
+    FoxMapMInit(uint64_t, Job*, &jobTable);
+    FoxArrayMInit(Job*, &finishedJobs);
+    FoxArrayMInit(Job*, &dispatchJobs);
+
+    /* Leave one CPU for the main thread by default. */
+    numWorkers = opts.jobThreads;
+    if (numWorkers == 0) {
+        long numCpus = sysconf(_SC_NPROCESSORS_ONLN);
+        numWorkers = (numCpus > 1) ? (uint32_t)numCpus - 1 : 1;
+    }
+
+    deques = malloc(numWorkers * sizeof(JobDeque));
+    assert(deques);
+    workers = malloc(numWorkers * sizeof(pthread_t));
+    assert(workers);
+    for (uint32_t idx = 0; idx < numWorkers; idx++) {
+        JobDequeInit(deques + idx);
+    }
+    for (uint32_t idx = 0; idx < numWorkers; idx++) {
+        if (pthread_create(workers + idx, NULL, JobWorker,
+                           (void*)(intptr_t)idx) != 0) {
+            LogErr("Could not start job worker thread %u.", idx);
+            abort();
+        }
+    }
+
+    LogInfo("Done initializing job module with %u worker thread(s).",
+            numWorkers);
+    return;
+}
+
+void JobManDestructor(void) {
+    LogInfo("Deinitializing job module...");
+
+    /* Let workers drain their queues before stopping. */
+    pthread_mutex_lock(&sleepMutex);
+    stopping = true;
+    pthread_cond_broadcast(&wakeCond);
+    pthread_mutex_unlock(&sleepMutex);
+    for (uint32_t idx = 0; idx < numWorkers; idx++) {
+        pthread_join(workers[idx], NULL);
+    }
+
+    /* Callbacks of jobs that finished during shutdown are never called. */
+    JobHelpUntilDone(AER_JOB_NULL);
+    size_t numDropped = FoxArrayMSize(Job*, &finishedJobs);
+    while (!FoxArrayMEmpty(Job*, &finishedJobs)) {
+        Job* job = *FoxArrayMPop(Job*, &finishedJobs);
+        FoxArrayMDeinit(Job*, &job->dependents);
+        free(job);
+    }
+
+    for (uint32_t idx = 0; idx < numWorkers; idx++) {
+        JobDequeDeinit(deques + idx);
+    }
+    free(deques);
+    deques = NULL;
+    free(workers);
+    workers = NULL;
+    numWorkers = 0;
+    FoxMapMDeinit(uint64_t, Job*, &jobTable);
+    FoxArrayMDeinit(Job*, &finishedJobs);
+    FoxArrayMDeinit(Job*, &dispatchJobs);
+
+    LogInfo("Done deinitializing job module. Dropped %zu callback(s).",
+            numDropped);
+    return;
+}
+
+/* ----- PUBLIC FUNCTIONS ----- */
+
+AER_EXPORT uint64_t AERJobSubmit(void (*func)(void* arg), void* arg) {
+#define errRet AER_JOB_NULL
+    EnsureArg(func);
+
+    Ok(JobSubmit(func, arg, NULL, 0, NULL, ModManGetCurrentMod()));
+#undef errRet
+}
+
+AER_EXPORT uint64_t AERJobSubmitAdv(void (*func)(void* arg),
+                                    void* arg,
+                                    void (*callback)(void* arg),
+                                    size_t numDeps,
+                                    const uint64_t* deps) {
+#define errRet AER_JOB_NULL
+    EnsureArg(func);
+    EnsureArgBuf(deps, numDeps);
+    for (uint32_t idx = 0; idx < numDeps; idx++) {
+        EnsureLookup(deps[idx] != AER_JOB_NULL);
+    }
+
+    Ok(JobSubmit(func, arg, callback, numDeps, deps, ModManGetCurrentMod()));
+#undef errRet
+}
+
+AER_EXPORT void AERJobWait(uint64_t job) {
+#define errRet
+    EnsureLookup(job != AER_JOB_NULL);
+
+    JobHelpUntilDone(job);
+
+    Ok();
+#undef errRet
+}
+
+AER_EXPORT bool AERJobIsDone(uint64_t job) {
+#define errRet false
+    EnsureLookup(job != AER_JOB_NULL);
+
+    pthread_mutex_lock(&tableMutex);
+    bool done = JobIsDoneLocked(job);
+    pthread_mutex_unlock(&tableMutex);
+
+    Ok(done);
+#undef errRet
+}
+
+AER_EXPORT size_t AERJobGetNumWorkers(void) {
+#define errRet 0
+    Ok(numWorkers);
+#undef errRet
+}
@@ -14,19 +14,30 @@
  * limitations under the License.
  */
 #include <assert.h>
+#include <pthread.h>
+#include <sched.h>
 #include <stdarg.h>
+#include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 #include <time.h>
 
 #include "aer/log.h"
 #include "internal/err.h"
+#include "internal/binlog.h"
 #include "internal/export.h"
 #include "internal/log.h"
 #include "internal/mod.h"
+#include "internal/option.h"
 
 /* ----- PRIVATE MACROS ----- */
 
+/* Always define the real functions, whatever mods compile out. */
+#undef AERLogInfo
+#undef AERLogWarn
+
 #define BuildMsgFromVA(fmt, lastArg)                                 \
     ({                                                               \
         va_list BuildMsgFromVA_va;                                   \
@@ -36,15 +47,35 @@
         msgBuf;                                                      \
     })
 
-#define GetCurrentModName()                                        \
-    ({                                                             \
-        Mod* GetCurrentModName_mod = ModManGetCurrentMod();        \
-        GetCurrentModName_mod ? GetCurrentModName_mod->name : "?"; \
-    })
+#define BinLogFromVA(logLvl, moduleName, fmt, lastArg)               \
+    do {                                                             \
+        va_list BinLogFromVA_va;                                     \
+        va_start(BinLogFromVA_va, (lastArg));                        \
+        BinLogWrite((logLvl), (moduleName), (fmt), BinLogFromVA_va); \
+        va_end(BinLogFromVA_va);                                     \
+    } while (0)
+
+#define GetCaller() __builtin_extract_return_addr(__builtin_return_address(0))
+
+#define LOG_RING_SIZE 1024
+
+#define LOG_RECORD_MSG_SIZE 480
+#define LOG_RECORD_NAME_SIZE 64
 
 /* ----- PRIVATE TYPES ----- */
 
-typedef enum LogLevel { LOG_INFO, LOG_WARN, LOG_ERR } LogLevel;
+/*
+ * Mod names are freed during teardown before the writer thread drains its
+ * last records, so the module name is copied alongside the message.
+ */
+typedef struct LogRecord {
+    uint32_t seq;
+    LogLevel lvl;
+    FILE* fp;
+    char moduleName[LOG_RECORD_NAME_SIZE];
+    time_t time;
+    char msg[LOG_RECORD_MSG_SIZE];
+} LogRecord;
 
 /* ----- PRIVATE CONSTANTS ----- */
 
@@ -56,17 +87,149 @@ static const char* INTERNAL_MOD_NAME = "mre";
 
 /* ----- PRIVATE GLOBALS ----- */
 
-static char msgBuf[8 * 1024];
+static __thread char msgBuf[8 * 1024];
+
+/*
+ * Bounded multi-producer, single-consumer ring. Each record carries a
+ * sequence number which tells producers when it is free and the writer when
+ * it is full.
+ */
+static LogRecord ring[LOG_RING_SIZE];
+
+static uint32_t enqueuePos = 0;
+
+static uint32_t dequeuePos = 0;
+
+static pthread_once_t writerOnce = PTHREAD_ONCE_INIT;
+
+static pthread_t writer;
+
+static bool writerRunning = false;
+
+static bool writerSleeping = false;
+
+static bool writerStopping = false;
+
+static uint32_t writtenPos = 0;
+
+static pthread_mutex_t writerMutex = PTHREAD_MUTEX_INITIALIZER;
+
+static pthread_cond_t wakeCond = PTHREAD_COND_INITIALIZER;
+
+static pthread_cond_t flushCond = PTHREAD_COND_INITIALIZER;
+
+static time_t cachedTime = -1;
+
+static char cachedTimeBuf[9];
 
 /* ----- PRIVATE FUNCTIONS ----- */
 
-static void FmtCurTime(char buf[9]) {
+static inline bool ModLogLevelEnabled(Mod* mod, LogLevel logLvl) {
+    LogLevel minLvl = (mod && opts.modLogLevels) ? opts.modLogLevels[mod->idx]
+                                                 : opts.logLevel;
+    return logLvl >= minLvl;
+}
+
+static void FmtTime(time_t rawtime, char buf[9]) {
     assert(buf != NULL);
 
-    time_t rawtime;
-    time(&rawtime);
-    struct tm* timeinfo = localtime(&rawtime);
-    strftime(buf, 9, "%H:%M:%S", timeinfo);
+    struct tm timeinfo;
+    localtime_r(&rawtime, &timeinfo);
+    strftime(buf, 9, "%H:%M:%S", &timeinfo);
+
+    return;
+}
+
+static void WriteRecord(const LogRecord* rec) {
+    /* Only the writer thread uses the cached timestamp. */
+    if (rec->time != cachedTime) {
+        cachedTime = rec->time;
+        FmtTime(cachedTime, cachedTimeBuf);
+    }
+
+    fprintf(rec->fp, MSG_FMT, cachedTimeBuf, rec->moduleName,
+            LVL_STRS[rec->lvl], rec->msg);
+
+    return;
+}
+
+static bool RingIsEmpty(void) {
+    LogRecord* rec = ring + (dequeuePos % LOG_RING_SIZE);
+    return __atomic_load_n(&rec->seq, __ATOMIC_ACQUIRE) != dequeuePos + 1;
+}
+
+static void WakeWriter(void) {
+    pthread_mutex_lock(&writerMutex);
+    pthread_cond_signal(&wakeCond);
+    pthread_mutex_unlock(&writerMutex);
+
+    return;
+}
+
+static void* LogWriter(void* ctx) {
+    (void)ctx;
+
+    while (true) {
+        /* Drain everything that is ready. */
+        uint32_t numWritten = 0;
+        while (!RingIsEmpty()) {
+            LogRecord* rec = ring + (dequeuePos % LOG_RING_SIZE);
+            WriteRecord(rec);
+            __atomic_store_n(&rec->seq, dequeuePos + LOG_RING_SIZE,
+                             __ATOMIC_RELEASE);
+            dequeuePos++;
+            numWritten++;
+        }
+        if (numWritten > 0) {
+            fflush(stdout);
+            fflush(stderr);
+            pthread_mutex_lock(&writerMutex);
+            writtenPos = dequeuePos;
+            pthread_cond_broadcast(&flushCond);
+            pthread_mutex_unlock(&writerMutex);
+            continue;
+        }
+
+        /* Sleep until a producer publishes a record. */
+        pthread_mutex_lock(&writerMutex);
+        __atomic_store_n(&writerSleeping, true, __ATOMIC_SEQ_CST);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        while (!writerStopping && RingIsEmpty())
+            pthread_cond_wait(&wakeCond, &writerMutex);
+        __atomic_store_n(&writerSleeping, false, __ATOMIC_RELAXED);
+        bool stop = writerStopping && RingIsEmpty();
+        pthread_mutex_unlock(&writerMutex);
+        if (stop)
+            break;
+    }
+
+    return NULL;
+}
+
+static void StartWriter(void) {
+    for (uint32_t idx = 0; idx < LOG_RING_SIZE; idx++) {
+        ring[idx].seq = idx;
+    }
+    if (pthread_create(&writer, NULL, LogWriter, NULL) == 0)
+        __atomic_store_n(&writerRunning, true, __ATOMIC_RELEASE);
+
+    return;
+}
+
+static void Flush(void) {
+    if (!__atomic_load_n(&writerRunning, __ATOMIC_ACQUIRE)) {
+        fflush(stdout);
+        fflush(stderr);
+        return;
+    }
+
+    uint32_t target = __atomic_load_n(&enqueuePos, __ATOMIC_ACQUIRE);
+    pthread_mutex_lock(&writerMutex);
+    while ((int32_t)(writtenPos - target) < 0) {
+        pthread_cond_signal(&wakeCond);
+        pthread_cond_wait(&flushCond, &writerMutex);
+    }
+    pthread_mutex_unlock(&writerMutex);
 
     return;
 }
@@ -80,12 +243,56 @@ static void Log(FILE* fp,
     assert(moduleName != NULL);
     assert(msg != NULL);
 
-    /* Get current time. */
-    char timeBuf[9];
-    FmtCurTime(timeBuf);
-
-    /* Print formatted message. */
-    fprintf(fp, MSG_FMT, timeBuf, moduleName, LVL_STRS[logLvl], msg);
+    pthread_once(&writerOnce, StartWriter);
+    time_t now = time(NULL);
+
+    /*
+     * Messages that don't fit in a record (or that arrive while the writer
+     * isn't running) are printed directly once everything before them is out.
+     */
+    size_t msgSize = strlen(msg) + 1;
+    if (msgSize > LOG_RECORD_MSG_SIZE ||
+        !__atomic_load_n(&writerRunning, __ATOMIC_ACQUIRE)) {
+        Flush();
+        char timeBuf[9];
+        FmtTime(now, timeBuf);
+        fprintf(fp, MSG_FMT, timeBuf, moduleName, LVL_STRS[logLvl], msg);
+        return;
+    }
+
+    /* Claim a record. */
+    uint32_t pos = __atomic_load_n(&enqueuePos, __ATOMIC_RELAXED);
+    LogRecord* rec;
+    while (true) {
+        rec = ring + (pos % LOG_RING_SIZE);
+        int32_t diff =
+            (int32_t)(__atomic_load_n(&rec->seq, __ATOMIC_ACQUIRE) - pos);
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&enqueuePos, &pos, pos + 1, true,
+                                            __ATOMIC_RELAXED,
+                                            __ATOMIC_RELAXED))
+                break;
+        } else if (diff < 0) {
+            /* Ring is full, so give the writer a chance to catch up. */
+            WakeWriter();
+            sched_yield();
+            pos = __atomic_load_n(&enqueuePos, __ATOMIC_RELAXED);
+        } else {
+            pos = __atomic_load_n(&enqueuePos, __ATOMIC_RELAXED);
+        }
+    }
+
+    /* Fill and publish record. */
+    rec->lvl = logLvl;
+    rec->fp = fp;
+    snprintf(rec->moduleName, LOG_RECORD_NAME_SIZE, "%s", moduleName);
+    rec->time = now;
+    memcpy(rec->msg, msg, msgSize);
+    __atomic_store_n(&rec->seq, pos + 1, __ATOMIC_RELEASE);
+
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&writerSleeping, __ATOMIC_SEQ_CST))
+        WakeWriter();
 
     return;
 }
@@ -94,6 +301,14 @@ static void Log(FILE* fp,
 
 void LogInfo(const char* fmt, ...) {
     assert(fmt);
+    if (opts.logLevel > LOG_INFO)
+        return;
+
+    /* Informational messages only go to the binary log when it's open. */
+    if (BinLogIsOpen()) {
+        BinLogFromVA(LOG_INFO, INTERNAL_MOD_NAME, fmt, fmt);
+        return;
+    }
 
     /* Call common log function. */
     Log(stdout, LOG_INFO, INTERNAL_MOD_NAME, BuildMsgFromVA(fmt, fmt));
@@ -103,6 +318,11 @@ void LogInfo(const char* fmt, ...) {
 
 void LogWarn(const char* fmt, ...) {
     assert(fmt);
+    if (opts.logLevel > LOG_WARN)
+        return;
+
+    if (BinLogIsOpen())
+        BinLogFromVA(LOG_WARN, INTERNAL_MOD_NAME, fmt, fmt);
 
     /* Call common log function. */
     Log(stderr, LOG_WARN, INTERNAL_MOD_NAME, BuildMsgFromVA(fmt, fmt));
@@ -113,9 +333,39 @@ void LogWarn(const char* fmt, ...) {
 void LogErr(const char* fmt, ...) {
     assert(fmt);
 
+    if (BinLogIsOpen())
+        BinLogFromVA(LOG_ERR, INTERNAL_MOD_NAME, fmt, fmt);
+
     /* Call common log function. */
     Log(stderr, LOG_ERR, INTERNAL_MOD_NAME, BuildMsgFromVA(fmt, fmt));
 
+    /* Errors usually precede an abort, so make sure they're seen. */
+    Flush();
+
+    return;
+}
+
+void LogFlush(void) {
+    Flush();
+
+    return;
+}
+
+void LogDestructor(void) {
+    if (!__atomic_load_n(&writerRunning, __ATOMIC_ACQUIRE))
+        return;
+
+    pthread_mutex_lock(&writerMutex);
+    writerStopping = true;
+    pthread_cond_signal(&wakeCond);
+    pthread_mutex_unlock(&writerMutex);
+    pthread_join(writer, NULL);
+
+    /* Any later messages are printed directly. */
+    __atomic_store_n(&writerRunning, false, __ATOMIC_RELEASE);
+    fflush(stdout);
+    fflush(stderr);
+
     return;
 }
 
@@ -125,8 +375,21 @@ AER_EXPORT void AERLogInfo(const char* fmt, ...) {
 #define errRet
     EnsureArg(fmt);
 
+    /* Filter before doing any real work. */
+    Mod* mod = ModManGetCallerMod(GetCaller());
+    if (!ModLogLevelEnabled(mod, LOG_INFO))
+        Ok();
+
+    const char* moduleName = (mod) ? mod->name : "?";
+
+    /* Informational messages only go to the binary log when it's open. */
+    if (BinLogIsOpen()) {
+        BinLogFromVA(LOG_INFO, moduleName, fmt, fmt);
+        Ok();
+    }
+
     /* Call common log function. */
-    Log(stdout, LOG_INFO, GetCurrentModName(), BuildMsgFromVA(fmt, fmt));
+    Log(stdout, LOG_INFO, moduleName, BuildMsgFromVA(fmt, fmt));
 
     Ok();
 #undef errRet
@@ -136,8 +399,17 @@ AER_EXPORT void AERLogWarn(const char* fmt, ...) {
 #define errRet
     EnsureArg(fmt);
 
+    /* Filter before doing any real work. */
+    Mod* mod = ModManGetCallerMod(GetCaller());
+    if (!ModLogLevelEnabled(mod, LOG_WARN))
+        Ok();
+
+    const char* moduleName = (mod) ? mod->name : "?";
+    if (BinLogIsOpen())
+        BinLogFromVA(LOG_WARN, moduleName, fmt, fmt);
+
     /* Call common log function. */
-    Log(stdout, LOG_WARN, GetCurrentModName(), BuildMsgFromVA(fmt, fmt));
+    Log(stdout, LOG_WARN, moduleName, BuildMsgFromVA(fmt, fmt));
 
     Ok();
 #undef errRet
@@ -147,8 +419,18 @@ AER_EXPORT void AERLogErr(const char* fmt, ...) {
 #define errRet
     EnsureArg(fmt);
 
+    /* Filter before doing any real work. */
+    Mod* mod = ModManGetCallerMod(GetCaller());
+    if (!ModLogLevelEnabled(mod, LOG_ERR))
+        Ok();
+
+    const char* moduleName = (mod) ? mod->name : "?";
+    if (BinLogIsOpen())
+        BinLogFromVA(LOG_ERR, moduleName, fmt, fmt);
+
     /* Call common log function. */
-    Log(stdout, LOG_ERR, GetCurrentModName(), BuildMsgFromVA(fmt, fmt));
+    Log(stdout, LOG_ERR, moduleName, BuildMsgFromVA(fmt, fmt));
+    Flush();
 
     Ok();
 #undef errRet
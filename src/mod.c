@@ -17,26 +17,95 @@
 
 #include <assert.h>
 #include <dlfcn.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/inotify.h>
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
 
 #include "foxutils/arraymacs.h"
 #include "foxutils/mapmacs.h"
 
 #include "aer/err.h"
+#include "aer/fast.h"
 #include "aer/mod.h"
+#include "internal/core.h"
+#include "internal/err.h"
+#include "internal/event.h"
+#include "internal/export.h"
+#include "internal/instance.h"
+#include "internal/job.h"
 #include "internal/log.h"
 #include "internal/mod.h"
 #include "internal/option.h"
+#include "internal/profile.h"
 
 /* ----- PRIVATE MACROS ----- */
 
 #define FormatLibname(name, bufSize, buf) \
     snprintf((buf), (bufSize), MOD_LIBNAME_FMT, (name))
 
+#define CALLER_CACHE_SIZE 256
+
+/* ----- PRIVATE TYPES ----- */
+
+typedef enum ModLoadStatus {
+    MOD_LOAD_PENDING,
+    MOD_LOAD_OK,
+    MOD_LOAD_BAD_LIB,
+    MOD_LOAD_BAD_DEF,
+    MOD_LOAD_BAD_BASE
+} ModLoadStatus;
+
+typedef struct ModLoadJob {
+    const char* name;
+    char libname[128];
+    ModLoadStatus status;
+    void* libHandle;
+    void* libBase;
+    char* libPath;
+    void (*defMod)(AERModDef*);
+    pthread_t worker;
+    struct timespec libStart;
+    struct timespec libEnd;
+    struct timespec defStart;
+    struct timespec defEnd;
+    struct timespec ctorEnd;
+} ModLoadJob;
+
+typedef struct ModReloadContext {
+    const char* name;
+    void* oldBase;
+    void* newHandle;
+} ModReloadContext;
+
+typedef struct ParallelListenerContext {
+    void (*func)(void);
+    int32_t modIdx;
+    uint64_t jobId;
+    uint64_t elapsedNs;
+} ParallelListenerContext;
+
+typedef struct ModLoadContext {
+    ModLoadJob* jobs;
+    size_t numJobs;
+    uint32_t nextJobIdx;
+} ModLoadContext;
+
+typedef struct CallerCacheEntry {
+    void* caller;
+    Mod* mod;
+    uint32_t generation;
+} CallerCacheEntry;
+
 /* ----- PRIVATE CONSTANTS ----- */
 
 static const char* MOD_LIBNAME_FMT = "lib%s.so";
@@ -56,6 +125,8 @@ static FoxMap modMemMap = {0};
 
 static FoxArray gameStepListeners = {0};
 
+static FoxArray parallelGameStepListeners = {0};
+
 static FoxArray gamePauseListeners = {0};
 
 static FoxArray gameSaveListeners = {0};
@@ -66,82 +137,143 @@ static FoxArray roomStartListeners = {0};
 
 static FoxArray roomEndListeners = {0};
 
+static int watchFd = -1;
+
+static uint32_t modGeneration = 0;
+
+/*
+ * Resolving a caller's mod means a `dladdr` call and a map lookup, which can
+ * dwarf the cost of whatever the caller wanted. Call sites don't move (short
+ * of a mod being hot reloaded), so remember them.
+ */
+static __thread CallerCacheEntry callerCache[CALLER_CACHE_SIZE];
+
 /* ----- PRIVATE FUNCTIONS ----- */
 
-static void ModInit(Mod* mod, int32_t idx, const char* name) {
-    LogInfo("Loading mod \"%s\"...", name);
+static double ElapsedMs(const struct timespec* start,
+                        const struct timespec* end) {
+    return (double)(end->tv_sec - start->tv_sec) * 1000.0 +
+           (double)(end->tv_nsec - start->tv_nsec) * 0.000001;
+}
 
-    /* Set index. */
-    mod->idx = idx;
+static void (*ModFindDefinition(void* libHandle))(AERModDef*) {
+    size_t numDefModNames = sizeof(DEF_MOD_NAMES) / sizeof(const char*);
+    for (uint32_t idx = 0; idx < numDefModNames; idx++) {
+        void (*defMod)(AERModDef*) = dlsym(libHandle, DEF_MOD_NAMES[idx]);
+        if (defMod)
+            return defMod;
+    }
 
-    /* Set name. */
-    mod->name = name;
+    return NULL;
+}
+
+/*
+ * This part of mod loading does not touch any MRE state, so it may run on a
+ * worker thread. Errors are recorded in the job and reported later by the main
+ * thread.
+ */
+static void ModLoadLibrary(ModLoadJob* job) {
+    clock_gettime(CLOCK_MONOTONIC, &job->libStart);
 
     /* Load library. */
-    char libname[128];
-    FormatLibname(name, 128, libname);
-    void* libHandle = dlopen(libname, RTLD_NOW);
-    if (!(mod->libHandle = libHandle)) {
-        LogErr(
-            "While loading mod \"%s\", could not load corresponding library "
-            "\"%s\".\n"
-            "If you are using this mod, make sure its directory is in "
-            "the \"LD_LIBRARY_PATH\" environment variable.\n"
-            "If you are developing this mod, make sure all of the symbols it "
-            "references are defined.",
-            name, libname);
-        abort();
+    FormatLibname(job->name, sizeof(job->libname), job->libname);
+    void* libHandle = dlopen(job->libname, RTLD_NOW);
+    if (!(job->libHandle = libHandle)) {
+        job->status = MOD_LOAD_BAD_LIB;
+        goto done;
     }
 
     /* Load mod definition function. */
-    void (*defMod)(AERModDef*);
-    size_t numDefModNames = sizeof(DEF_MOD_NAMES) / sizeof(const char*);
-    for (uint32_t idx = 0; idx < numDefModNames; idx++) {
-        defMod = dlsym(libHandle, DEF_MOD_NAMES[idx]);
-        if (defMod)
-            break;
+    if (!(job->defMod = ModFindDefinition(libHandle))) {
+        job->status = MOD_LOAD_BAD_DEF;
+        goto done;
     }
-    if (!defMod) {
-        /* TODO Create dedicated string concatenation function. */
-        /* Efficiently concatenate all valid def mod function names. */
-        char defModNamesBuf[256];
-        uint32_t charIdxOut = 0;
-        for (uint32_t nameIdx = 0; nameIdx < numDefModNames; nameIdx++) {
-            /* Prevent buffer overflow. */
-            if (charIdxOut == sizeof(defModNamesBuf) - 1)
-                break;
-            defModNamesBuf[charIdxOut++] = ' ';
-            const char* name = DEF_MOD_NAMES[nameIdx];
-            uint32_t charIdxIn = 0;
-            char charCur = name[charIdxIn];
-            while (charCur != '\0') {
-                /* Prevent buffer overflow. */
-                if (charIdxOut == sizeof(defModNamesBuf) - 1)
-                    break;
-                defModNamesBuf[charIdxOut++] = charCur;
-                charCur = name[++charIdxIn];
-            }
+
+    /* Find mod library's base address. */
+    Dl_info memInfo;
+    if (dladdr(job->defMod, &memInfo) == 0 || memInfo.dli_fbase == NULL) {
+        job->status = MOD_LOAD_BAD_BASE;
+        goto done;
+    }
+    job->libBase = memInfo.dli_fbase;
+    job->libPath = strdup(memInfo.dli_fname);
+    assert(job->libPath);
+    job->status = MOD_LOAD_OK;
+
+done:
+    clock_gettime(CLOCK_MONOTONIC, &job->libEnd);
+    return;
+}
+
+static void* ModLoadWorker(ModLoadContext* ctx) {
+    uint32_t jobIdx;
+    while ((jobIdx = __atomic_fetch_add(&ctx->nextJobIdx, 1,
+                                        __ATOMIC_RELAXED)) < ctx->numJobs) {
+        ModLoadJob* job = ctx->jobs + jobIdx;
+        job->worker = pthread_self();
+        ModLoadLibrary(job);
+    }
+
+    return NULL;
+}
+
+static void ModLoadLibraries(ModLoadContext* ctx, uint32_t numThreads) {
+    /* No need to spin up threads when loading serially. */
+    if (numThreads <= 1) {
+        ModLoadWorker(ctx);
+        return;
+    }
+
+    pthread_t* threads = malloc(numThreads * sizeof(pthread_t));
+    assert(threads);
+    uint32_t numStarted = 0;
+    for (; numStarted < numThreads; numStarted++) {
+        if (pthread_create(threads + numStarted, NULL,
+                           (void* (*)(void*))ModLoadWorker, ctx) != 0) {
+            LogWarn(
+                "Could only start %u of %u mod loading thread(s). Loading "
+                "remaining mods on main thread.",
+                numStarted, numThreads);
+            break;
         }
-        defModNamesBuf[charIdxOut] = '\0';
-        /* Display error. */
-        LogErr(
-            "While loading mod \"%s\", could not find mod definition function "
-            "with one of the following names:%s.",
-            name, defModNamesBuf);
-        abort();
     }
-    AERModDef def = {0};
 
-    /* Record mod memory map. */
+    /* Pick up any remaining work (only matters if thread creation failed). */
+    ModLoadWorker(ctx);
+
+    for (uint32_t idx = 0; idx < numStarted; idx++) {
+        pthread_join(threads[idx], NULL);
+    }
+    free(threads);
+
+    return;
+}
+
+static void ModCheckFastLayout(Mod* mod) {
+    /* Only a symbol from the mod library itself counts, not a dependency's. */
+    const uint32_t* version = dlsym(mod->libHandle, "aerFastLayoutVersion");
     Dl_info memInfo;
-    if (dladdr(defMod, &memInfo) == 0 || memInfo.dli_fbase == NULL) {
+    if (!version || dladdr(version, &memInfo) == 0 ||
+        memInfo.dli_fbase != mod->libBase)
+        return;
+
+    if (*version > aerFastLayout.version) {
         LogErr(
-            "While loading mod \"%s\", could not determine mod library's base "
-            "address.",
-            name);
+            "Mod \"%s\" was built against version %u of \"aer/fast.h\", but "
+            "this MRE only provides version %u.",
+            mod->name, *version, aerFastLayout.version);
         abort();
     }
-    *FoxMapMInsert(void*, int32_t, &modMemMap, memInfo.dli_fbase) = idx;
+
+    return;
+}
+
+static void ModDefine(Mod* mod, void (*defMod)(AERModDef*)) {
+    AERModDef def = {0};
+    int32_t idx = mod->idx;
+
+    /* Make sure any unchecked accessors the mod uses are backed. */
+    ModCheckFastLayout(mod);
 
     /* Call mod definition function. */
     defMod(&def);
@@ -154,28 +286,32 @@ static void ModInit(Mod* mod, int32_t idx, const char* name) {
 
     /* Record pseudoevent listeners. */
     if (def.gameStepListener) {
-        *FoxArrayMPush(void*, &gameStepListeners) = def.gameStepListener;
+        ModManInsertListener(&gameStepListeners, def.gameStepListener, idx);
+    }
+    if (def.parallelGameStepListener) {
+        ModManInsertListener(&parallelGameStepListeners,
+                             def.parallelGameStepListener, idx);
     }
     if (def.gamePauseListener) {
-        *FoxArrayMPush(void*, &gamePauseListeners) = def.gamePauseListener;
+        ModManInsertListener(&gamePauseListeners, def.gamePauseListener, idx);
     }
     if (def.gameSaveListener) {
-        *FoxArrayMPush(void*, &gameSaveListeners) = def.gameSaveListener;
+        ModManInsertListener(&gameSaveListeners, def.gameSaveListener, idx);
     }
     if (def.gameLoadListener) {
-        *FoxArrayMPush(void*, &gameLoadListeners) = def.gameLoadListener;
+        ModManInsertListener(&gameLoadListeners, def.gameLoadListener, idx);
     }
     if (def.roomEndListener) {
-        *FoxArrayMPush(void*, &roomEndListeners) = def.roomEndListener;
+        ModManInsertListener(&roomEndListeners, def.roomEndListener, idx);
     }
     if (def.roomStartListener) {
-        *FoxArrayMPush(void*, &roomStartListeners) = def.roomStartListener;
+        ModManInsertListener(&roomStartListeners, def.roomStartListener, idx);
         /* We have to use `roomChangeListener` for the sake of compatability, so
          * allow this one use of a deprecated struct member. */
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wdeprecated-declarations"
     } else if (def.roomChangeListener) {
-        *FoxArrayMPush(void*, &roomStartListeners) = def.roomChangeListener;
+        ModManInsertListener(&roomStartListeners, def.roomChangeListener, idx);
     }
 #pragma GCC diagnostic pop
 
@@ -183,14 +319,140 @@ static void ModInit(Mod* mod, int32_t idx, const char* name) {
     mod->constructor = def.constructor;
     mod->destructor = def.destructor;
 
+    return;
+}
+
+static void ModInit(Mod* mod, int32_t idx, ModLoadJob* job) {
+    const char* name = job->name;
+    LogInfo("Loading mod \"%s\"...", name);
+
+    /* Set index. */
+    mod->idx = idx;
+
+    /* Set name. */
+    mod->name = name;
+
+    /* Set library. */
+    mod->libHandle = job->libHandle;
+    switch (job->status) {
+        case MOD_LOAD_OK:
+            break;
+
+        case MOD_LOAD_BAD_LIB:
+            LogErr(
+                "While loading mod \"%s\", could not load corresponding "
+                "library \"%s\".\n"
+                "If you are using this mod, make sure its directory is in "
+                "the \"LD_LIBRARY_PATH\" environment variable.\n"
+                "If you are developing this mod, make sure all of the symbols "
+                "it references are defined.",
+                name, job->libname);
+            abort();
+
+        case MOD_LOAD_BAD_DEF: {
+            /* TODO Create dedicated string concatenation function. */
+            /* Efficiently concatenate all valid def mod function names. */
+            size_t numDefModNames =
+                sizeof(DEF_MOD_NAMES) / sizeof(const char*);
+            char defModNamesBuf[256];
+            uint32_t charIdxOut = 0;
+            for (uint32_t nameIdx = 0; nameIdx < numDefModNames; nameIdx++) {
+                /* Prevent buffer overflow. */
+                if (charIdxOut == sizeof(defModNamesBuf) - 1)
+                    break;
+                defModNamesBuf[charIdxOut++] = ' ';
+                const char* name = DEF_MOD_NAMES[nameIdx];
+                uint32_t charIdxIn = 0;
+                char charCur = name[charIdxIn];
+                while (charCur != '\0') {
+                    /* Prevent buffer overflow. */
+                    if (charIdxOut == sizeof(defModNamesBuf) - 1)
+                        break;
+                    defModNamesBuf[charIdxOut++] = charCur;
+                    charCur = name[++charIdxIn];
+                }
+            }
+            defModNamesBuf[charIdxOut] = '\0';
+            /* Display error. */
+            LogErr(
+                "While loading mod \"%s\", could not find mod definition "
+                "function with one of the following names:%s.",
+                name, defModNamesBuf);
+            abort();
+        }
+
+        case MOD_LOAD_BAD_BASE:
+            LogErr(
+                "While loading mod \"%s\", could not determine mod library's "
+                "base address.",
+                name);
+            abort();
+
+        default:
+            LogErr("While loading mod \"%s\", library was never loaded.",
+                   name);
+            abort();
+    }
+
+    /* Record mod memory map. */
+    *FoxMapMInsert(void*, int32_t, &modMemMap, job->libBase) = idx;
+
+    /* Record mod library location. */
+    mod->libBase = job->libBase;
+    mod->libPath = job->libPath;
+    job->libPath = NULL;
+    mod->watchDesc = -1;
+    mod->reloadPending = false;
+
+    /* Define mod. */
+    ModDefine(mod, job->defMod);
+
     LogInfo("Successfully loaded mod \"%s\".", name);
     return;
 }
 
+static void ModLogTimeline(ModLoadContext* ctx,
+                           const struct timespec* start,
+                           const struct timespec* end) {
+    if (ctx->numJobs == 0)
+        return;
+    LogInfo("Mod loading timeline (milliseconds since start of loading):");
+
+    /* Give each distinct loading thread a small, stable number. */
+    pthread_t* workers = malloc(ctx->numJobs * sizeof(pthread_t));
+    assert(workers);
+    uint32_t numWorkers = 0;
+
+    for (uint32_t idx = 0; idx < ctx->numJobs; idx++) {
+        ModLoadJob* job = ctx->jobs + idx;
+        uint32_t workerNum;
+        for (workerNum = 0; workerNum < numWorkers; workerNum++) {
+            if (pthread_equal(workers[workerNum], job->worker))
+                break;
+        }
+        if (workerNum == numWorkers)
+            workers[numWorkers++] = job->worker;
+
+        LogInfo(
+            "  [%u] \"%s\": library %.2f-%.2f (thread %u), "
+            "definition %.2f-%.2f, constructor %.2f-%.2f.",
+            idx, job->name, ElapsedMs(start, &job->libStart),
+            ElapsedMs(start, &job->libEnd), workerNum,
+            ElapsedMs(start, &job->defStart), ElapsedMs(start, &job->defEnd),
+            ElapsedMs(start, &job->defEnd), ElapsedMs(start, &job->ctorEnd));
+    }
+    free(workers);
+
+    LogInfo("Loaded %zu mod(s) in %.2f ms using %u thread(s).", ctx->numJobs,
+            ElapsedMs(start, end), numWorkers);
+    return;
+}
+
 static void ModDeinit(Mod* mod) {
     LogInfo("Unloading mod \"%s\"...", mod->name);
 
     dlclose(mod->libHandle);
+    free(mod->libPath);
 
     const char* name = mod->name;
 
@@ -200,6 +462,246 @@ static void ModDeinit(Mod* mod) {
     return;
 }
 
+static const char* ModGetLibBasename(const Mod* mod) {
+    const char* sep = strrchr(mod->libPath, '/');
+    return (sep) ? sep + 1 : mod->libPath;
+}
+
+static void ModWatchLibraries(void) {
+    LogInfo("Watching mod libraries for changes...");
+
+    watchFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (watchFd < 0) {
+        LogWarn("Could not initialize mod library watcher: %s.",
+                strerror(errno));
+        return;
+    }
+
+    size_t numWatched = 0;
+    for (uint32_t idx = 0; idx < opts.numModNames; idx++) {
+        Mod* mod = mods + idx;
+
+        /* Watch the directory so that replaced files are also noticed. */
+        char dir[4096];
+        const char* base = ModGetLibBasename(mod);
+        size_t dirLen = (base == mod->libPath) ? 0 : base - mod->libPath;
+        if (dirLen == 0) {
+            strcpy(dir, ".");
+        } else if (dirLen < sizeof(dir)) {
+            memcpy(dir, mod->libPath, dirLen);
+            dir[dirLen] = '\0';
+        } else {
+            LogWarn("Path of mod \"%s\" library is too long to watch.",
+                    mod->name);
+            continue;
+        }
+
+        mod->watchDesc =
+            inotify_add_watch(watchFd, dir, IN_CLOSE_WRITE | IN_MOVED_TO);
+        if (mod->watchDesc < 0) {
+            LogWarn("Could not watch library of mod \"%s\": %s.", mod->name,
+                    strerror(errno));
+            continue;
+        }
+        numWatched++;
+    }
+
+    LogInfo("Done. Watching %zu mod librar(ies).", numWatched);
+    return;
+}
+
+/*
+ * The dynamic loader would hand back the already-loaded library if asked to
+ * open the same file again, so load a private copy instead.
+ */
+static void* ModOpenLibraryCopy(const Mod* mod) {
+    char tmpPath[] = "/tmp/aermre-reload-XXXXXX.so";
+    int tmpFd = mkstemps(tmpPath, 3);
+    if (tmpFd < 0) {
+        LogWarn("While reloading mod \"%s\", could not create copy: %s.",
+                mod->name, strerror(errno));
+        return NULL;
+    }
+
+    bool copied = false;
+    int libFd = open(mod->libPath, O_RDONLY | O_CLOEXEC);
+    struct stat libStat;
+    if (libFd >= 0 && fstat(libFd, &libStat) == 0) {
+        off_t offset = 0;
+        copied = true;
+        while (offset < libStat.st_size) {
+            if (sendfile(tmpFd, libFd, &offset, libStat.st_size - offset) <=
+                0) {
+                copied = false;
+                break;
+            }
+        }
+    }
+    if (libFd >= 0)
+        close(libFd);
+    close(tmpFd);
+
+    void* libHandle = NULL;
+    if (!copied) {
+        LogWarn("While reloading mod \"%s\", could not copy library \"%s\".",
+                mod->name, mod->libPath);
+    } else if (!(libHandle = dlopen(tmpPath, RTLD_NOW))) {
+        LogWarn("While reloading mod \"%s\", could not load library: %s.",
+                mod->name, dlerror());
+    }
+
+    /* The mapping outlives the file, so it can go right away. */
+    unlink(tmpPath);
+
+    return libHandle;
+}
+
+static void* ModRelocateSymbol(void* sym, ModReloadContext* ctx) {
+    Dl_info symInfo;
+    if (dladdr(sym, &symInfo) == 0 || symInfo.dli_fbase != ctx->oldBase)
+        return sym;
+
+    void* newSym = NULL;
+    if (symInfo.dli_sname && symInfo.dli_saddr == sym)
+        newSym = dlsym(ctx->newHandle, symInfo.dli_sname);
+    if (!newSym) {
+        LogWarn(
+            "While reloading mod \"%s\", could not find mod local destructor "
+            "in new library. It will not be called.",
+            ctx->name);
+    }
+
+    return newSym;
+}
+
+static void ModReload(Mod* mod) {
+    const char* name = mod->name;
+    LogInfo("Reloading mod \"%s\"...", name);
+
+    /* Load new library alongside the old one. */
+    void* newHandle = ModOpenLibraryCopy(mod);
+    if (!newHandle) {
+        LogWarn("Keeping previously loaded library of mod \"%s\".", name);
+        return;
+    }
+    void (*defMod)(AERModDef*) = ModFindDefinition(newHandle);
+    Dl_info memInfo;
+    if (!defMod || dladdr(defMod, &memInfo) == 0 ||
+        memInfo.dli_fbase == NULL) {
+        LogWarn(
+            "While reloading mod \"%s\", could not find mod definition "
+            "function. Keeping previously loaded library.",
+            name);
+        dlclose(newHandle);
+        return;
+    }
+
+    /* Jobs and their callbacks may still refer to old library. */
+    JobManFinishAll();
+
+    /* Destruct old library. */
+    if (mod->destructor) {
+        mod->destructor();
+    }
+
+    /* Mod locals survive the reload, but their destructors must not. */
+    ModReloadContext ctx = {
+        .name = name, .oldBase = mod->libBase, .newHandle = newHandle};
+    InstanceManRelocateModLocalDestructors(
+        mod->idx, (void* (*)(void*, void*))ModRelocateSymbol, &ctx);
+
+    /* Drop listeners that point into old library. */
+    int32_t idx = mod->idx;
+    ModManRemoveListeners(&gameStepListeners, idx);
+    ModManRemoveListeners(&parallelGameStepListeners, idx);
+    ModManRemoveListeners(&gamePauseListeners, idx);
+    ModManRemoveListeners(&gameSaveListeners, idx);
+    ModManRemoveListeners(&gameLoadListeners, idx);
+    ModManRemoveListeners(&roomStartListeners, idx);
+    ModManRemoveListeners(&roomEndListeners, idx);
+    EventManRemoveModListeners(idx);
+
+    /* Swap libraries. */
+    __atomic_fetch_add(&modGeneration, 1, __ATOMIC_RELEASE);
+    (void)FoxMapMRemove(void*, int32_t, &modMemMap, mod->libBase);
+    dlclose(mod->libHandle);
+    mod->libHandle = newHandle;
+    mod->libBase = memInfo.dli_fbase;
+    *FoxMapMInsert(void*, int32_t, &modMemMap, mod->libBase) = idx;
+
+    /* Redefine and construct mod. */
+    ModDefine(mod, defMod);
+    if (mod->constructor) {
+        mod->constructor();
+    }
+
+    /*
+     * Sprites, fonts and objects already live in the engine, so only object
+     * listeners are registered again.
+     */
+    if (mod->registerObjectListeners) {
+        CoreStage origStage = stage;
+        stage = STAGE_LISTENER_REG;
+        mod->registerObjectListeners();
+        stage = origStage;
+        EventManSortSubscriptionArrays();
+    }
+
+    LogInfo("Successfully reloaded mod \"%s\".", name);
+    return;
+}
+
+static void ModRunParallelListener(ParallelListenerContext* ctx) {
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    /*
+     * Jobs normally run without a stage, but these may read game state. The
+     * dedicated stage lets lazily-filled caches refuse to build off the main
+     * thread; everything they serve is prepared before the jobs start.
+     */
+    CoreStage origStage = stage;
+    stage = STAGE_READ_ONLY;
+    ctx->func();
+    stage = origStage;
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    ctx->elapsedNs = (uint64_t)(ElapsedMs(&start, &end) * 1000000.0);
+
+    return;
+}
+
+static void ModExecuteParallelGameStepListeners(void) {
+    size_t numListeners =
+        FoxArrayMSize(ModListener, &parallelGameStepListeners);
+    if (numListeners == 0)
+        return;
+
+    ParallelListenerContext* ctxs =
+        malloc(numListeners * sizeof(ParallelListenerContext));
+    assert(ctxs);
+    for (uint32_t idx = 0; idx < numListeners; idx++) {
+        ModListener* modListener =
+            FoxArrayMIndex(ModListener, &parallelGameStepListeners, idx);
+        ParallelListenerContext* ctx = ctxs + idx;
+        *ctx = (ParallelListenerContext){.func = modListener->func,
+                                         .modIdx = modListener->modIdx};
+        ctx->jobId =
+            JobManSubmit((void (*)(void*))ModRunParallelListener, ctx,
+                         ctx->modIdx);
+    }
+
+    /* Main thread helps out until every listener has finished. */
+    for (uint32_t idx = 0; idx < numListeners; idx++) {
+        ParallelListenerContext* ctx = ctxs + idx;
+        JobManWait(ctx->jobId);
+        ProfileManAddModTime(ctx->modIdx, ctx->elapsedNs);
+    }
+    free(ctxs);
+
+    return;
+}
+
 /* ----- INTERNAL FUNCTIONS ----- */
 
 size_t ModManGetNumMods(void) {
@@ -226,67 +728,148 @@ Mod* ModManGetOwningMod(void* sym) {
     return NULL;
 }
 
+Mod* ModManGetCallerMod(void* caller) {
+    assert(caller);
+
+    CallerCacheEntry* entry =
+        callerCache + ((uintptr_t)caller >> 2) % CALLER_CACHE_SIZE;
+    uint32_t generation = ModManGetGeneration();
+    if (entry->caller != caller || entry->generation != generation) {
+        entry->caller = caller;
+        entry->mod = ModManGetOwningMod(caller);
+        entry->generation = generation;
+    }
+
+    return entry->mod;
+}
+
+uint32_t ModManGetGeneration(void) {
+    return __atomic_load_n(&modGeneration, __ATOMIC_ACQUIRE);
+}
+
+ModListener* ModManInsertListener(FoxArray* listeners,
+                                  void* func,
+                                  int32_t modIdx) {
+    assert(listeners);
+    assert(func);
+
+    /*
+     * Keep listeners in mod priority order so that a reloaded mod's listeners
+     * land where they were originally.
+     */
+    size_t idx = FoxArrayMSize(ModListener, listeners);
+    FoxArrayMPush(ModListener, listeners);
+    while (idx > 0) {
+        ModListener* prev = FoxArrayMIndex(ModListener, listeners, idx - 1);
+        if (prev->modIdx <= modIdx)
+            break;
+        *FoxArrayMIndex(ModListener, listeners, idx--) = *prev;
+    }
+    ModListener* listener = FoxArrayMIndex(ModListener, listeners, idx);
+    *listener = (ModListener){.func = func, .modIdx = modIdx};
+
+    return listener;
+}
+
+void ModManRemoveListeners(FoxArray* listeners, int32_t modIdx) {
+    assert(listeners);
+
+    size_t numListeners = FoxArrayMSize(ModListener, listeners);
+    size_t numKept = 0;
+    for (uint32_t idx = 0; idx < numListeners; idx++) {
+        ModListener listener = *FoxArrayMIndex(ModListener, listeners, idx);
+        if (listener.modIdx != modIdx)
+            *FoxArrayMIndex(ModListener, listeners, numKept++) = listener;
+    }
+    for (; numKept < numListeners; numKept++) {
+        FoxArrayMPop(ModListener, listeners);
+    }
+
+    return;
+}
+
 void ModManExecuteGameStepListeners(void) {
-    size_t numListeners = FoxArrayMSize(void*, &gameStepListeners);
+    /* Read-only listeners run first, while the game is at rest. */
+    ModExecuteParallelGameStepListeners();
+
+    size_t numListeners = FoxArrayMSize(ModListener, &gameStepListeners);
     for (uint32_t idx = 0; idx < numListeners; idx++) {
-        void (*listener)(void) =
-            *FoxArrayMIndex(void*, &gameStepListeners, idx);
+        ModListener* modListener =
+            FoxArrayMIndex(ModListener, &gameStepListeners, idx);
+        void (*listener)(void) = modListener->func;
+        ProfileManEnterMod(modListener->modIdx);
         listener();
+        ProfileManLeaveMod();
     }
 
     return;
 }
 
 void ModManExecuteGamePauseListeners(bool paused) {
-    size_t numListeners = FoxArrayMSize(void*, &gamePauseListeners);
+    size_t numListeners = FoxArrayMSize(ModListener, &gamePauseListeners);
     for (uint32_t idx = 0; idx < numListeners; idx++) {
-        void (*listener)(bool) =
-            *FoxArrayMIndex(void*, &gamePauseListeners, idx);
+        ModListener* modListener =
+            FoxArrayMIndex(ModListener, &gamePauseListeners, idx);
+        void (*listener)(bool) = modListener->func;
+        ProfileManEnterMod(modListener->modIdx);
         listener(paused);
+        ProfileManLeaveMod();
     }
 
     return;
 }
 
 void ModManExecuteGameSaveListeners(int32_t curSlotIdx) {
-    size_t numListeners = FoxArrayMSize(void*, &gameSaveListeners);
+    size_t numListeners = FoxArrayMSize(ModListener, &gameSaveListeners);
     for (uint32_t idx = 0; idx < numListeners; idx++) {
-        void (*listener)(int32_t) =
-            *FoxArrayMIndex(void*, &gameSaveListeners, idx);
+        ModListener* modListener =
+            FoxArrayMIndex(ModListener, &gameSaveListeners, idx);
+        void (*listener)(int32_t) = modListener->func;
+        ProfileManEnterMod(modListener->modIdx);
         listener(curSlotIdx);
+        ProfileManLeaveMod();
     }
 
     return;
 }
 
 void ModManExecuteGameLoadListeners(int32_t curSlotIdx) {
-    size_t numListeners = FoxArrayMSize(void*, &gameLoadListeners);
+    size_t numListeners = FoxArrayMSize(ModListener, &gameLoadListeners);
     for (uint32_t idx = 0; idx < numListeners; idx++) {
-        void (*listener)(int32_t) =
-            *FoxArrayMIndex(void*, &gameLoadListeners, idx);
+        ModListener* modListener =
+            FoxArrayMIndex(ModListener, &gameLoadListeners, idx);
+        void (*listener)(int32_t) = modListener->func;
+        ProfileManEnterMod(modListener->modIdx);
         listener(curSlotIdx);
+        ProfileManLeaveMod();
     }
 
     return;
 }
 
 void ModManExecuteRoomStartListeners(int32_t newRoomIdx, int32_t prevRoomIdx) {
-    size_t numListeners = FoxArrayMSize(void*, &roomStartListeners);
+    size_t numListeners = FoxArrayMSize(ModListener, &roomStartListeners);
     for (uint32_t idx = 0; idx < numListeners; idx++) {
-        void (*listener)(int32_t, int32_t) =
-            *FoxArrayMIndex(void*, &roomStartListeners, idx);
+        ModListener* modListener =
+            FoxArrayMIndex(ModListener, &roomStartListeners, idx);
+        void (*listener)(int32_t, int32_t) = modListener->func;
+        ProfileManEnterMod(modListener->modIdx);
         listener(newRoomIdx, prevRoomIdx);
+        ProfileManLeaveMod();
     }
 
     return;
 }
 
 void ModManExecuteRoomEndListeners(int32_t newRoomIdx, int32_t prevRoomIdx) {
-    size_t numListeners = FoxArrayMSize(void*, &roomEndListeners);
+    size_t numListeners = FoxArrayMSize(ModListener, &roomEndListeners);
     for (uint32_t idx = 0; idx < numListeners; idx++) {
-        void (*listener)(int32_t, int32_t) =
-            *FoxArrayMIndex(void*, &roomEndListeners, idx);
+        ModListener* modListener =
+            FoxArrayMIndex(ModListener, &roomEndListeners, idx);
+        void (*listener)(int32_t, int32_t) = modListener->func;
+        ProfileManEnterMod(modListener->modIdx);
         listener(newRoomIdx, prevRoomIdx);
+        ProfileManLeaveMod();
     }
 
     return;
@@ -294,25 +877,110 @@ void ModManExecuteRoomEndListeners(int32_t newRoomIdx, int32_t prevRoomIdx) {
 
 void ModManLoadMods(void) {
     LogInfo("Loading mods...");
+    struct timespec loadStart, loadEnd;
+    clock_gettime(CLOCK_MONOTONIC, &loadStart);
 
     /* Allocate mod array. */
     mods = malloc(opts.numModNames * sizeof(Mod));
 
-    /* Load mod libraries. */
-    for (uint32_t idx = 0; idx < opts.numModNames; idx++) {
+    /* Prepare loading jobs. */
+    ModLoadContext ctx = {
+        .jobs = calloc(opts.numModNames, sizeof(ModLoadJob)),
+        .numJobs = opts.numModNames,
+        .nextJobIdx = 0,
+    };
+    assert(ctx.jobs || ctx.numJobs == 0);
+    for (uint32_t idx = 0; idx < ctx.numJobs; idx++) {
+        ctx.jobs[idx].name = opts.modNames[idx];
+    }
+
+    /* Load mod libraries (possibly in parallel). */
+    uint32_t numThreads = opts.loadThreads;
+    if (numThreads == 0) {
+        long numCpus = sysconf(_SC_NPROCESSORS_ONLN);
+        numThreads = (numCpus > 0) ? (uint32_t)numCpus : 1;
+    }
+    if (numThreads > ctx.numJobs)
+        numThreads = ctx.numJobs;
+    ModLoadLibraries(&ctx, numThreads);
+
+    /*
+     * Define and construct mods in priority order. This keeps mod indices and
+     * listener ordering identical to serial loading.
+     */
+    for (uint32_t idx = 0; idx < ctx.numJobs; idx++) {
         Mod* mod = mods + idx;
-        ModInit(mod, idx, opts.modNames[idx]);
+        ModLoadJob* job = ctx.jobs + idx;
+        clock_gettime(CLOCK_MONOTONIC, &job->defStart);
+        ModInit(mod, idx, job);
+        clock_gettime(CLOCK_MONOTONIC, &job->defEnd);
         if (mod->constructor) {
             mod->constructor();
         }
+        clock_gettime(CLOCK_MONOTONIC, &job->ctorEnd);
     }
 
+    clock_gettime(CLOCK_MONOTONIC, &loadEnd);
+    ModLogTimeline(&ctx, &loadStart, &loadEnd);
+    free(ctx.jobs);
+
     LogInfo("Done. Loaded %zu mod(s).", opts.numModNames);
+
+    if (opts.hotReload)
+        ModWatchLibraries();
+}
+
+void ModManReloadChangedMods(void) {
+    if (watchFd < 0)
+        return;
+
+    /* Drain change notifications. */
+    char buf[4096]
+        __attribute__((aligned(__alignof__(struct inotify_event))));
+    bool changed = false;
+    ssize_t len;
+    while ((len = read(watchFd, buf, sizeof(buf))) > 0) {
+        char* ptr = buf;
+        while (ptr < buf + len) {
+            const struct inotify_event* event =
+                (const struct inotify_event*)ptr;
+            ptr += sizeof(struct inotify_event) + event->len;
+            if (event->len == 0)
+                continue;
+
+            for (uint32_t idx = 0; idx < opts.numModNames; idx++) {
+                Mod* mod = mods + idx;
+                if (mod->watchDesc == event->wd &&
+                    strcmp(ModGetLibBasename(mod), event->name) == 0) {
+                    mod->reloadPending = true;
+                    changed = true;
+                }
+            }
+        }
+    }
+    if (!changed)
+        return;
+
+    for (uint32_t idx = 0; idx < opts.numModNames; idx++) {
+        Mod* mod = mods + idx;
+        if (mod->reloadPending) {
+            mod->reloadPending = false;
+            ModReload(mod);
+        }
+    }
+
+    return;
 }
 
 void ModManUnloadMods(void) {
     LogInfo("Unloading mods...");
 
+    /* Stop watching for changes. */
+    if (watchFd >= 0) {
+        close(watchFd);
+        watchFd = -1;
+    }
+
     /* Destruct mods in reverse order. */
     for (uint32_t idx = 0; idx < opts.numModNames; idx++) {
         int32_t modIdx = (int32_t)(opts.numModNames - idx - 1);
@@ -331,12 +999,13 @@ void ModManConstructor(void) {
     LogInfo("Initializing mod manager...");
 
     FoxMapMInit(void*, int32_t, &modMemMap);
-    FoxArrayMInit(void*, &gameStepListeners);
-    FoxArrayMInit(void*, &gamePauseListeners);
-    FoxArrayMInit(void*, &gameSaveListeners);
-    FoxArrayMInit(void*, &gameLoadListeners);
-    FoxArrayMInit(void*, &roomStartListeners);
-    FoxArrayMInit(void*, &roomEndListeners);
+    FoxArrayMInit(ModListener, &gameStepListeners);
+    FoxArrayMInit(ModListener, &parallelGameStepListeners);
+    FoxArrayMInit(ModListener, &gamePauseListeners);
+    FoxArrayMInit(ModListener, &gameSaveListeners);
+    FoxArrayMInit(ModListener, &gameLoadListeners);
+    FoxArrayMInit(ModListener, &roomStartListeners);
+    FoxArrayMInit(ModListener, &roomEndListeners);
 
     LogInfo("Done initializing mod manager.", opts.numModNames);
     return;
@@ -347,13 +1016,42 @@ void ModManDestructor(void) {
 
     free(mods);
     FoxMapMDeinit(void*, int32_t, &modMemMap);
-    FoxArrayMDeinit(void*, &gameStepListeners);
-    FoxArrayMDeinit(void*, &gamePauseListeners);
-    FoxArrayMDeinit(void*, &gameSaveListeners);
-    FoxArrayMDeinit(void*, &gameLoadListeners);
-    FoxArrayMDeinit(void*, &roomStartListeners);
-    FoxArrayMDeinit(void*, &roomEndListeners);
+    FoxArrayMDeinit(ModListener, &gameStepListeners);
+    FoxArrayMDeinit(ModListener, &parallelGameStepListeners);
+    FoxArrayMDeinit(ModListener, &gamePauseListeners);
+    FoxArrayMDeinit(ModListener, &gameSaveListeners);
+    FoxArrayMDeinit(ModListener, &gameLoadListeners);
+    FoxArrayMDeinit(ModListener, &roomStartListeners);
+    FoxArrayMDeinit(ModListener, &roomEndListeners);
 
     LogInfo("Done deinitializing mod manager.");
     return;
 }
+
+/* ----- PUBLIC FUNCTIONS ----- */
+
+AER_EXPORT size_t AERModGetNumMods(void) {
+#define errRet 0
+    EnsureStage(STAGE_SPRITE_REG);
+
+    Ok(opts.numModNames);
+#undef errRet
+}
+
+AER_EXPORT const char* AERModGetName(int32_t modIdx) {
+#define errRet NULL
+    EnsureStage(STAGE_SPRITE_REG);
+    EnsureLookup(modIdx >= 0 && (size_t)modIdx < opts.numModNames);
+
+    Ok(mods[modIdx].name);
+#undef errRet
+}
+
+AER_EXPORT double AERModGetFrameTime(int32_t modIdx) {
+#define errRet 0.0
+    EnsureStage(STAGE_ACTION);
+    EnsureLookup(modIdx >= 0 && (size_t)modIdx < opts.numModNames);
+
+    Ok(ProfileManGetFrameTime(modIdx));
+#undef errRet
+}
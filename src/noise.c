@@ -0,0 +1,651 @@
+/**
+ * @copyright 2021 the libaermre authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "foxutils/math.h"
+
+#include "aer/noise.h"
+#include "internal/err.h"
+#include "internal/export.h"
+
+/* ----- PRIVATE MACROS ----- */
+
+#define NUM_LANES 4
+
+/* Lattice hashing constants from FastNoise Lite. */
+#define HASH_PRIME_X 501125321u
+
+#define HASH_PRIME_Y 1136930381u
+
+#define HASH_PRIME_Z 1720413743u
+
+#define HASH_MUL 0x27D4EB2Du
+
+/* Bring the largest magnitude of each dimension's noise just under `1.0`. */
+#define NOISE2_SCALE 1.3f
+
+#define NOISE3_SCALE 0.96f
+
+/*
+ * These expand identically for scalars and vectors, so that batches round
+ * exactly like single evaluations. Hashes use the top bits of the product,
+ * which depend on every bit of the lattice coordinates.
+ */
+#define Hash(val) (((val) * HASH_MUL) >> 28)
+
+#define Fade(t) ((t) * (t) * (t) * ((t) * ((t) * 6.0f - 15.0f) + 10.0f))
+
+#define Lerp(t, a, b) ((a) + (t) * ((b) - (a)))
+
+/* Per-lane `mask ? a : b`, selecting bits so that it is exact. */
+#define LanesSelect(mask, a, b) \
+    ((LaneVec)(((mask) & (LaneVecInt)(a)) | (~(mask) & (LaneVecInt)(b))))
+
+/* Per-lane `cond ? -val : val`, by flipping the sign bit. */
+#define LanesNegateIf(cond, val)  \
+    ((LaneVec)((LaneVecUInt)(val) ^ \
+               ((LaneVecUInt)((cond) != 0) << 31)))
+
+/* ----- PRIVATE TYPES ----- */
+
+/*
+ * Vectors are only ever passed by pointer, so they never depend on the
+ * calling convention for SSE registers.
+ */
+typedef float LaneVec __attribute__((vector_size(NUM_LANES * 4)));
+
+typedef int32_t LaneVecInt __attribute__((vector_size(NUM_LANES * 4)));
+
+typedef uint32_t LaneVecUInt __attribute__((vector_size(NUM_LANES * 4)));
+
+/*
+ * Gradients come from hashing lattice coordinates rather than from a
+ * permutation table, so lanes never need to gather from memory.
+ */
+typedef struct Noise {
+    uint32_t seed;
+} Noise;
+
+/* ----- PRIVATE FUNCTIONS ----- */
+
+/* SplitMix64's finalizer, so that nearby seeds give unrelated noise. */
+static inline uint32_t MixSeed(uint64_t seed) {
+    seed = (seed ^ (seed >> 30)) * UINT64_C(0xBF58476D1CE4E5B9);
+    seed = (seed ^ (seed >> 27)) * UINT64_C(0x94D049BB133111EB);
+    return (uint32_t)(seed ^ (seed >> 31));
+}
+
+static inline int32_t Floor(float val) {
+    int32_t trunc = (int32_t)val;
+    return trunc - ((float)trunc > val);
+}
+
+/* Assumes no lane overflows. */
+static inline void LanesFloor(const LaneVec* vec, LaneVecInt* result) {
+    LaneVecInt trunc = __builtin_convertvector(*vec, LaneVecInt);
+    *result = trunc + (__builtin_convertvector(trunc, LaneVec) > *vec);
+
+    return;
+}
+
+static inline float AmpNorm(uint32_t octaves, float gain) {
+    float total = 0.0f;
+    float amp = 1.0f;
+    for (uint32_t octave = 0; octave < octaves; octave++) {
+        total += amp;
+        amp *= gain;
+    }
+
+    return (total != 0.0f) ? 1.0f / total : 1.0f;
+}
+
+/*
+ * Gradients are picked by random hash bits, so branches would mispredict
+ * constantly. These select and negate through the bits instead.
+ */
+static inline float Select(bool cond, float a, float b) {
+    uint32_t mask = -(uint32_t)cond;
+    uint32_t aBits, bBits;
+    memcpy(&aBits, &a, sizeof(float));
+    memcpy(&bBits, &b, sizeof(float));
+    aBits = (mask & aBits) | (~mask & bBits);
+    memcpy(&a, &aBits, sizeof(float));
+    return a;
+}
+
+static inline float NegateIf(bool cond, float val) {
+    uint32_t bits;
+    memcpy(&bits, &val, sizeof(float));
+    bits ^= (uint32_t)cond << 31;
+    memcpy(&val, &bits, sizeof(float));
+    return val;
+}
+
+/* Slopes of +-0.25 to +-2.0. */
+static inline float Grad1(uint32_t hash, float x) {
+    float grad = (float)(int32_t)((hash & 7) + 1) * 0.25f;
+    return NegateIf(hash & 8, grad) * x;
+}
+
+/* Gradients (+-1, +-0.5) and (+-0.5, +-1). */
+static inline float Grad2(uint32_t hash, float x, float y) {
+    bool swap = hash & 4;
+    float u = Select(swap, y, x);
+    float v = Select(swap, x, y);
+    return NegateIf(hash & 1, u) + 0.5f * NegateIf(hash & 2, v);
+}
+
+/* Perlin's twelve cube edge gradients, padded to sixteen. */
+static inline float Grad3(uint32_t hash, float x, float y, float z) {
+    bool useX = (hash == 12) | (hash == 14);
+    float u = Select(hash < 8, x, y);
+    float v = Select(hash < 4, y, Select(useX, x, z));
+    return NegateIf(hash & 1, u) + NegateIf(hash & 2, v);
+}
+
+static float Noise1(const Noise* noise, float x) {
+    int32_t xi = Floor(x);
+    float xf = x - (float)xi;
+    uint32_t x0 = noise->seed ^ ((uint32_t)xi * HASH_PRIME_X);
+    uint32_t x1 = noise->seed ^ ((uint32_t)xi * HASH_PRIME_X + HASH_PRIME_X);
+
+    float n0 = Grad1(Hash(x0), xf);
+    float n1 = Grad1(Hash(x1), xf - 1.0f);
+
+    return Lerp(Fade(xf), n0, n1);
+}
+
+static float Noise2(const Noise* noise, float x, float y) {
+    int32_t xi = Floor(x);
+    int32_t yi = Floor(y);
+    float xf = x - (float)xi;
+    float yf = y - (float)yi;
+    uint32_t x0 = noise->seed ^ ((uint32_t)xi * HASH_PRIME_X);
+    uint32_t x1 = noise->seed ^ ((uint32_t)xi * HASH_PRIME_X + HASH_PRIME_X);
+    uint32_t y0 = (uint32_t)yi * HASH_PRIME_Y;
+    uint32_t y1 = y0 + HASH_PRIME_Y;
+
+    float n00 = Grad2(Hash(x0 ^ y0), xf, yf);
+    float n10 = Grad2(Hash(x1 ^ y0), xf - 1.0f, yf);
+    float n01 = Grad2(Hash(x0 ^ y1), xf, yf - 1.0f);
+    float n11 = Grad2(Hash(x1 ^ y1), xf - 1.0f, yf - 1.0f);
+
+    float u = Fade(xf);
+    return Lerp(Fade(yf), Lerp(u, n00, n10), Lerp(u, n01, n11)) *
+           NOISE2_SCALE;
+}
+
+static float Noise3(const Noise* noise, float x, float y, float z) {
+    int32_t xi = Floor(x);
+    int32_t yi = Floor(y);
+    int32_t zi = Floor(z);
+    float xf = x - (float)xi;
+    float yf = y - (float)yi;
+    float zf = z - (float)zi;
+    uint32_t x0 = noise->seed ^ ((uint32_t)xi * HASH_PRIME_X);
+    uint32_t x1 = noise->seed ^ ((uint32_t)xi * HASH_PRIME_X + HASH_PRIME_X);
+    uint32_t y0 = (uint32_t)yi * HASH_PRIME_Y;
+    uint32_t y1 = y0 + HASH_PRIME_Y;
+    uint32_t z0 = (uint32_t)zi * HASH_PRIME_Z;
+    uint32_t z1 = z0 + HASH_PRIME_Z;
+    float xm = xf - 1.0f;
+    float ym = yf - 1.0f;
+    float zm = zf - 1.0f;
+
+    float n000 = Grad3(Hash(x0 ^ y0 ^ z0), xf, yf, zf);
+    float n100 = Grad3(Hash(x1 ^ y0 ^ z0), xm, yf, zf);
+    float n010 = Grad3(Hash(x0 ^ y1 ^ z0), xf, ym, zf);
+    float n110 = Grad3(Hash(x1 ^ y1 ^ z0), xm, ym, zf);
+    float n001 = Grad3(Hash(x0 ^ y0 ^ z1), xf, yf, zm);
+    float n101 = Grad3(Hash(x1 ^ y0 ^ z1), xm, yf, zm);
+    float n011 = Grad3(Hash(x0 ^ y1 ^ z1), xf, ym, zm);
+    float n111 = Grad3(Hash(x1 ^ y1 ^ z1), xm, ym, zm);
+
+    float u = Fade(xf);
+    float v = Fade(yf);
+    return Lerp(Fade(zf), Lerp(v, Lerp(u, n000, n100), Lerp(u, n010, n110)),
+                Lerp(v, Lerp(u, n001, n101), Lerp(u, n011, n111))) *
+           NOISE3_SCALE;
+}
+
+/*
+ * The lane versions mirror the scalar ones operation for operation, so that
+ * every lane rounds exactly like a single evaluation.
+ */
+static inline void Grad1Lanes(const LaneVecUInt* hash,
+                              const LaneVec* x,
+                              LaneVec* result) {
+    LaneVec grad =
+        __builtin_convertvector((LaneVecInt)((*hash & 7) + 1), LaneVec) *
+        0.25f;
+    *result = LanesNegateIf(*hash & 8, grad) * *x;
+
+    return;
+}
+
+static inline void Grad2Lanes(const LaneVecUInt* hash,
+                              const LaneVec* x,
+                              const LaneVec* y,
+                              LaneVec* result) {
+    LaneVecInt swap = (*hash & 4) != 0;
+    LaneVec u = LanesSelect(swap, *y, *x);
+    LaneVec v = LanesSelect(swap, *x, *y);
+    *result = LanesNegateIf(*hash & 1, u) + 0.5f * LanesNegateIf(*hash & 2, v);
+
+    return;
+}
+
+static inline void Grad3Lanes(const LaneVecUInt* hash,
+                              const LaneVec* x,
+                              const LaneVec* y,
+                              const LaneVec* z,
+                              LaneVec* result) {
+    LaneVecInt useX = (*hash == 12) | (*hash == 14);
+    LaneVec u = LanesSelect(*hash < 8, *x, *y);
+    LaneVec v = LanesSelect(*hash < 4, *y, LanesSelect(useX, *x, *z));
+    *result = LanesNegateIf(*hash & 1, u) + LanesNegateIf(*hash & 2, v);
+
+    return;
+}
+
+static void Noise1Lanes(const Noise* noise,
+                        const LaneVec* x,
+                        LaneVec* result) {
+    LaneVecInt xi;
+    LanesFloor(x, &xi);
+    LaneVec xf = *x - __builtin_convertvector(xi, LaneVec);
+    LaneVec xm = xf - 1.0f;
+    LaneVecUInt x0 = noise->seed ^ ((LaneVecUInt)xi * HASH_PRIME_X);
+    LaneVecUInt x1 =
+        noise->seed ^ ((LaneVecUInt)xi * HASH_PRIME_X + HASH_PRIME_X);
+
+    LaneVecUInt hash;
+    LaneVec n0, n1;
+    hash = Hash(x0);
+    Grad1Lanes(&hash, &xf, &n0);
+    hash = Hash(x1);
+    Grad1Lanes(&hash, &xm, &n1);
+
+    *result = Lerp(Fade(xf), n0, n1);
+    return;
+}
+
+static void Noise2Lanes(const Noise* noise,
+                        const LaneVec* x,
+                        const LaneVec* y,
+                        LaneVec* result) {
+    LaneVecInt xi, yi;
+    LanesFloor(x, &xi);
+    LanesFloor(y, &yi);
+    LaneVec xf = *x - __builtin_convertvector(xi, LaneVec);
+    LaneVec yf = *y - __builtin_convertvector(yi, LaneVec);
+    LaneVec xm = xf - 1.0f;
+    LaneVec ym = yf - 1.0f;
+    LaneVecUInt x0 = noise->seed ^ ((LaneVecUInt)xi * HASH_PRIME_X);
+    LaneVecUInt x1 =
+        noise->seed ^ ((LaneVecUInt)xi * HASH_PRIME_X + HASH_PRIME_X);
+    LaneVecUInt y0 = (LaneVecUInt)yi * HASH_PRIME_Y;
+    LaneVecUInt y1 = y0 + HASH_PRIME_Y;
+
+    LaneVecUInt hash;
+    LaneVec n00, n10, n01, n11;
+    hash = Hash(x0 ^ y0);
+    Grad2Lanes(&hash, &xf, &yf, &n00);
+    hash = Hash(x1 ^ y0);
+    Grad2Lanes(&hash, &xm, &yf, &n10);
+    hash = Hash(x0 ^ y1);
+    Grad2Lanes(&hash, &xf, &ym, &n01);
+    hash = Hash(x1 ^ y1);
+    Grad2Lanes(&hash, &xm, &ym, &n11);
+
+    LaneVec u = Fade(xf);
+    *result = Lerp(Fade(yf), Lerp(u, n00, n10), Lerp(u, n01, n11)) *
+              NOISE2_SCALE;
+    return;
+}
+
+static void Noise3Lanes(const Noise* noise,
+                        const LaneVec* x,
+                        const LaneVec* y,
+                        const LaneVec* z,
+                        LaneVec* result) {
+    LaneVecInt xi, yi, zi;
+    LanesFloor(x, &xi);
+    LanesFloor(y, &yi);
+    LanesFloor(z, &zi);
+    LaneVec xf = *x - __builtin_convertvector(xi, LaneVec);
+    LaneVec yf = *y - __builtin_convertvector(yi, LaneVec);
+    LaneVec zf = *z - __builtin_convertvector(zi, LaneVec);
+    LaneVec xm = xf - 1.0f;
+    LaneVec ym = yf - 1.0f;
+    LaneVec zm = zf - 1.0f;
+    LaneVecUInt x0 = noise->seed ^ ((LaneVecUInt)xi * HASH_PRIME_X);
+    LaneVecUInt x1 =
+        noise->seed ^ ((LaneVecUInt)xi * HASH_PRIME_X + HASH_PRIME_X);
+    LaneVecUInt y0 = (LaneVecUInt)yi * HASH_PRIME_Y;
+    LaneVecUInt y1 = y0 + HASH_PRIME_Y;
+    LaneVecUInt z0 = (LaneVecUInt)zi * HASH_PRIME_Z;
+    LaneVecUInt z1 = z0 + HASH_PRIME_Z;
+
+    LaneVecUInt hash;
+    LaneVec n000, n100, n010, n110, n001, n101, n011, n111;
+    hash = Hash(x0 ^ y0 ^ z0);
+    Grad3Lanes(&hash, &xf, &yf, &zf, &n000);
+    hash = Hash(x1 ^ y0 ^ z0);
+    Grad3Lanes(&hash, &xm, &yf, &zf, &n100);
+    hash = Hash(x0 ^ y1 ^ z0);
+    Grad3Lanes(&hash, &xf, &ym, &zf, &n010);
+    hash = Hash(x1 ^ y1 ^ z0);
+    Grad3Lanes(&hash, &xm, &ym, &zf, &n110);
+    hash = Hash(x0 ^ y0 ^ z1);
+    Grad3Lanes(&hash, &xf, &yf, &zm, &n001);
+    hash = Hash(x1 ^ y0 ^ z1);
+    Grad3Lanes(&hash, &xm, &yf, &zm, &n101);
+    hash = Hash(x0 ^ y1 ^ z1);
+    Grad3Lanes(&hash, &xf, &ym, &zm, &n011);
+    hash = Hash(x1 ^ y1 ^ z1);
+    Grad3Lanes(&hash, &xm, &ym, &zm, &n111);
+
+    LaneVec u = Fade(xf);
+    LaneVec v = Fade(yf);
+    *result =
+        Lerp(Fade(zf), Lerp(v, Lerp(u, n000, n100), Lerp(u, n010, n110)),
+             Lerp(v, Lerp(u, n001, n101), Lerp(u, n011, n111))) *
+        NOISE3_SCALE;
+    return;
+}
+
+static float FBm(const Noise* noise,
+                 uint32_t dims,
+                 const float* coords,
+                 uint32_t octaves,
+                 float lacunarity,
+                 float gain) {
+    float sum = 0.0f;
+    float freq = 1.0f;
+    float amp = 1.0f;
+    for (uint32_t octave = 0; octave < octaves; octave++) {
+        float val;
+        switch (dims) {
+            case 1:
+                val = Noise1(noise, coords[0] * freq);
+                break;
+            case 2:
+                val = Noise2(noise, coords[0] * freq, coords[1] * freq);
+                break;
+            default:
+                val = Noise3(noise, coords[0] * freq, coords[1] * freq,
+                             coords[2] * freq);
+        }
+        sum += val * amp;
+        freq *= lacunarity;
+        amp *= gain;
+    }
+
+    return sum * AmpNorm(octaves, gain);
+}
+
+static void FBmLanes(const Noise* noise,
+                     uint32_t dims,
+                     const LaneVec* coords,
+                     uint32_t octaves,
+                     float lacunarity,
+                     float gain,
+                     LaneVec* result) {
+    LaneVec sum = {0};
+    float freq = 1.0f;
+    float amp = 1.0f;
+    for (uint32_t octave = 0; octave < octaves; octave++) {
+        LaneVec val;
+        LaneVec x = coords[0] * freq;
+        if (dims == 1) {
+            Noise1Lanes(noise, &x, &val);
+        } else {
+            LaneVec y = coords[1] * freq;
+            if (dims == 2) {
+                Noise2Lanes(noise, &x, &y, &val);
+            } else {
+                LaneVec z = coords[2] * freq;
+                Noise3Lanes(noise, &x, &y, &z, &val);
+            }
+        }
+        sum += val * amp;
+        freq *= lacunarity;
+        amp *= gain;
+    }
+
+    *result = sum * AmpNorm(octaves, gain);
+    return;
+}
+
+/* Pads the final partial group of lanes with zeroes. */
+static void Fill(const Noise* noise,
+                 uint32_t dims,
+                 size_t bufSize,
+                 const float* const* coordBufs,
+                 uint32_t octaves,
+                 float lacunarity,
+                 float gain,
+                 float* noiseBuf) {
+    for (size_t idx = 0; idx < bufSize; idx += NUM_LANES) {
+        size_t numLanes = FoxMin(bufSize - idx, NUM_LANES);
+
+        LaneVec coords[3] = {{0}};
+        for (uint32_t dim = 0; dim < dims; dim++)
+            memcpy(&coords[dim], coordBufs[dim] + idx,
+                   numLanes * sizeof(float));
+
+        LaneVec result;
+        FBmLanes(noise, dims, coords, octaves, lacunarity, gain, &result);
+        memcpy(noiseBuf + idx, &result, numLanes * sizeof(float));
+    }
+
+    return;
+}
+
+/* ----- PUBLIC FUNCTIONS ----- */
+
+AER_EXPORT AERNoise* AERNoiseNew(uint64_t seed) {
+    Noise* noise = malloc(sizeof(Noise));
+    assert(noise);
+    noise->seed = MixSeed(seed);
+
+    Ok((AERNoise*)noise);
+}
+
+AER_EXPORT void AERNoiseFree(AERNoise* noise) {
+#define errRet
+    EnsureArg(noise);
+
+    free(noise);
+
+    Ok();
+#undef errRet
+}
+
+AER_EXPORT float AERNoise1(const AERNoise* noise, float x) {
+#define errRet 0.0f
+    EnsureArg(noise);
+
+    Ok(Noise1(noise, x));
+#undef errRet
+}
+
+AER_EXPORT float AERNoise2(const AERNoise* noise, float x, float y) {
+#define errRet 0.0f
+    EnsureArg(noise);
+
+    Ok(Noise2(noise, x, y));
+#undef errRet
+}
+
+AER_EXPORT float AERNoise3(const AERNoise* noise, float x, float y, float z) {
+#define errRet 0.0f
+    EnsureArg(noise);
+
+    Ok(Noise3(noise, x, y, z));
+#undef errRet
+}
+
+AER_EXPORT float AERNoiseFBm1(const AERNoise* noise,
+                              float x,
+                              uint32_t octaves,
+                              float lacunarity,
+                              float gain) {
+#define errRet 0.0f
+    EnsureArg(noise);
+    EnsureMinExc(octaves, 0);
+
+    Ok(FBm(noise, 1, &x, octaves, lacunarity, gain));
+#undef errRet
+}
+
+AER_EXPORT float AERNoiseFBm2(const AERNoise* noise,
+                              float x,
+                              float y,
+                              uint32_t octaves,
+                              float lacunarity,
+                              float gain) {
+#define errRet 0.0f
+    EnsureArg(noise);
+    EnsureMinExc(octaves, 0);
+
+    float coords[2] = {x, y};
+    Ok(FBm(noise, 2, coords, octaves, lacunarity, gain));
+#undef errRet
+}
+
+AER_EXPORT float AERNoiseFBm3(const AERNoise* noise,
+                              float x,
+                              float y,
+                              float z,
+                              uint32_t octaves,
+                              float lacunarity,
+                              float gain) {
+#define errRet 0.0f
+    EnsureArg(noise);
+    EnsureMinExc(octaves, 0);
+
+    float coords[3] = {x, y, z};
+    Ok(FBm(noise, 3, coords, octaves, lacunarity, gain));
+#undef errRet
+}
+
+AER_EXPORT void AERNoiseFill1(const AERNoise* noise,
+                              size_t bufSize,
+                              const float* xBuf,
+                              uint32_t octaves,
+                              float lacunarity,
+                              float gain,
+                              float* noiseBuf) {
+#define errRet
+    EnsureArg(noise);
+    EnsureArgBuf(xBuf, bufSize);
+    EnsureArgBuf(noiseBuf, bufSize);
+    EnsureMinExc(octaves, 0);
+
+    Fill(noise, 1, bufSize, &xBuf, octaves, lacunarity, gain, noiseBuf);
+
+    Ok();
+#undef errRet
+}
+
+AER_EXPORT void AERNoiseFill2(const AERNoise* noise,
+                              size_t bufSize,
+                              const float* xBuf,
+                              const float* yBuf,
+                              uint32_t octaves,
+                              float lacunarity,
+                              float gain,
+                              float* noiseBuf) {
+#define errRet
+    EnsureArg(noise);
+    EnsureArgBuf(xBuf, bufSize);
+    EnsureArgBuf(yBuf, bufSize);
+    EnsureArgBuf(noiseBuf, bufSize);
+    EnsureMinExc(octaves, 0);
+
+    const float* coordBufs[2] = {xBuf, yBuf};
+    Fill(noise, 2, bufSize, coordBufs, octaves, lacunarity, gain, noiseBuf);
+
+    Ok();
+#undef errRet
+}
+
+AER_EXPORT void AERNoiseFill3(const AERNoise* noise,
+                              size_t bufSize,
+                              const float* xBuf,
+                              const float* yBuf,
+                              const float* zBuf,
+                              uint32_t octaves,
+                              float lacunarity,
+                              float gain,
+                              float* noiseBuf) {
+#define errRet
+    EnsureArg(noise);
+    EnsureArgBuf(xBuf, bufSize);
+    EnsureArgBuf(yBuf, bufSize);
+    EnsureArgBuf(zBuf, bufSize);
+    EnsureArgBuf(noiseBuf, bufSize);
+    EnsureMinExc(octaves, 0);
+
+    const float* coordBufs[3] = {xBuf, yBuf, zBuf};
+    Fill(noise, 3, bufSize, coordBufs, octaves, lacunarity, gain, noiseBuf);
+
+    Ok();
+#undef errRet
+}
+
+AER_EXPORT void AERNoiseFillGrid2(const AERNoise* noise,
+                                  float x,
+                                  float y,
+                                  float step,
+                                  size_t width,
+                                  size_t height,
+                                  uint32_t octaves,
+                                  float lacunarity,
+                                  float gain,
+                                  float* noiseBuf) {
+#define errRet
+    EnsureArg(noise);
+    Ensure(height == 0 || width <= SIZE_MAX / height, AER_BAD_VAL);
+    EnsureArgBuf(noiseBuf, width * height);
+    EnsureMinExc(octaves, 0);
+
+    for (size_t row = 0; row < height; row++) {
+        float* rowBuf = noiseBuf + row * width;
+        LaneVec coords[2];
+        for (uint32_t lane = 0; lane < NUM_LANES; lane++)
+            coords[1][lane] = y + (float)row * step;
+
+        for (size_t col = 0; col < width; col += NUM_LANES) {
+            for (uint32_t lane = 0; lane < NUM_LANES; lane++)
+                coords[0][lane] = x + (float)(col + lane) * step;
+
+            LaneVec result;
+            FBmLanes(noise, 2, coords, octaves, lacunarity, gain, &result);
+            memcpy(rowBuf + col, &result,
+                   FoxMin(width - col, NUM_LANES) * sizeof(float));
+        }
+    }
+
+    Ok();
+#undef errRet
+}
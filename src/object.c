@@ -352,7 +352,7 @@ AER_EXPORT bool AERObjectGetCollisions(int32_t objIdx) {
 
 AER_EXPORT void AERObjectSetCollisions(int32_t objIdx, bool collisions) {
 #define errRet
-    EnsureStage(STAGE_OBJECT_REG);
+    EnsureStageMut(STAGE_OBJECT_REG);
 
     HLDObject* obj = HLDObjectLookup(objIdx);
     EnsureLookup(obj);
@@ -375,7 +375,7 @@ AER_EXPORT bool AERObjectGetPersistent(int32_t objIdx) {
 
 AER_EXPORT void AERObjectSetPersistent(int32_t objIdx, bool persistent) {
 #define errRet
-    EnsureStage(STAGE_OBJECT_REG);
+    EnsureStageMut(STAGE_OBJECT_REG);
 
     HLDObject* obj = HLDObjectLookup(objIdx);
     EnsureLookup(obj);
@@ -398,7 +398,7 @@ AER_EXPORT bool AERObjectGetVisible(int32_t objIdx) {
 
 AER_EXPORT void AERObjectSetVisible(int32_t objIdx, bool visible) {
 #define errRet
-    EnsureStage(STAGE_OBJECT_REG);
+    EnsureStageMut(STAGE_OBJECT_REG);
 
     HLDObject* obj = HLDObjectLookup(objIdx);
     EnsureLookup(obj);
@@ -413,8 +413,9 @@ AER_EXPORT void AERObjectAttachCreateListener(int32_t objIdx,
                                                                AERInstance*,
                                                                AERInstance*)) {
 #define errRet
+    Mod* mod = ModManGetCurrentMod();
     LogInfo("Attaching create listener to object %i for mod \"%s\"...", objIdx,
-            ModManGetCurrentMod()->name);
+            mod->name);
 
     EnsureStageStrict(STAGE_LISTENER_REG);
     EnsureArg(listener);
@@ -424,7 +425,7 @@ AER_EXPORT void AERObjectAttachCreateListener(int32_t objIdx,
 
     EventKey key =
         (EventKey){.type = HLD_EVENT_CREATE, .num = 0, .objIdx = objIdx};
-    EventManRegisterEventListener(obj, key, listener);
+    EventManRegisterEventListener(obj, key, listener, mod->idx, false);
 
     LogInfo("Successfully attached create listener.");
     Ok();
@@ -436,8 +437,9 @@ AER_EXPORT void AERObjectAttachDestroyListener(int32_t objIdx,
                                                                 AERInstance*,
                                                                 AERInstance*)) {
 #define errRet
+    Mod* mod = ModManGetCurrentMod();
     LogInfo("Attaching destroy listener to object %i for mod \"%s\"...", objIdx,
-            ModManGetCurrentMod()->name);
+            mod->name);
 
     EnsureStageStrict(STAGE_LISTENER_REG);
     EnsureArg(listener);
@@ -446,7 +448,7 @@ AER_EXPORT void AERObjectAttachDestroyListener(int32_t objIdx,
     EnsureLookup(obj);
 
     EventKey key = {.type = HLD_EVENT_DESTROY, .num = 0, .objIdx = objIdx};
-    EventManRegisterEventListener(obj, key, listener);
+    EventManRegisterEventListener(obj, key, listener, mod->idx, false);
 
     LogInfo("Successfully attached destroy listener.");
     Ok();
@@ -459,8 +461,9 @@ AER_EXPORT void AERObjectAttachAlarmListener(int32_t objIdx,
                                                               AERInstance*,
                                                               AERInstance*)) {
 #define errRet
+    Mod* mod = ModManGetCurrentMod();
     LogInfo("Attaching alarm %u listener to object %i for mod \"%s\"...",
-            alarmIdx, objIdx, ModManGetCurrentMod()->name);
+            alarmIdx, objIdx, mod->name);
 
     EnsureStageStrict(STAGE_LISTENER_REG);
     EnsureArg(listener);
@@ -470,7 +473,7 @@ AER_EXPORT void AERObjectAttachAlarmListener(int32_t objIdx,
     EnsureLookup(obj);
 
     EventKey key = {.type = HLD_EVENT_ALARM, .num = alarmIdx, .objIdx = objIdx};
-    EventManRegisterEventListener(obj, key, listener);
+    EventManRegisterEventListener(obj, key, listener, mod->idx, false);
 
     LogInfo("Successfully attached alarm %u listener.", alarmIdx);
     Ok();
@@ -482,8 +485,9 @@ AER_EXPORT void AERObjectAttachStepListener(int32_t objIdx,
                                                              AERInstance*,
                                                              AERInstance*)) {
 #define errRet
+    Mod* mod = ModManGetCurrentMod();
     LogInfo("Attaching step listener to object %i for mod \"%s\"...", objIdx,
-            ModManGetCurrentMod()->name);
+            mod->name);
 
     EnsureStageStrict(STAGE_LISTENER_REG);
     EnsureArg(listener);
@@ -493,7 +497,7 @@ AER_EXPORT void AERObjectAttachStepListener(int32_t objIdx,
 
     EventKey key = {
         .type = HLD_EVENT_STEP, .num = HLD_EVENT_STEP_NORMAL, .objIdx = objIdx};
-    EventManRegisterEventListener(obj, key, listener);
+    EventManRegisterEventListener(obj, key, listener, mod->idx, false);
 
     LogInfo("Successfully attached step listener.");
     Ok();
@@ -505,8 +509,9 @@ AER_EXPORT void AERObjectAttachPreStepListener(int32_t objIdx,
                                                                 AERInstance*,
                                                                 AERInstance*)) {
 #define errRet
+    Mod* mod = ModManGetCurrentMod();
     LogInfo("Attaching pre-step listener to object %i for mod \"%s\"...",
-            objIdx, ModManGetCurrentMod()->name);
+            objIdx, mod->name);
 
     EnsureStageStrict(STAGE_LISTENER_REG);
     EnsureArg(listener);
@@ -516,7 +521,7 @@ AER_EXPORT void AERObjectAttachPreStepListener(int32_t objIdx,
 
     EventKey key = {
         .type = HLD_EVENT_STEP, .num = HLD_EVENT_STEP_PRE, .objIdx = objIdx};
-    EventManRegisterEventListener(obj, key, listener);
+    EventManRegisterEventListener(obj, key, listener, mod->idx, false);
 
     LogInfo("Successfully attached pre-step listener.");
     Ok();
@@ -527,8 +532,9 @@ AER_EXPORT void AERObjectAttachPostStepListener(
     int32_t objIdx,
     bool (*listener)(AEREvent*, AERInstance*, AERInstance*)) {
 #define errRet
+    Mod* mod = ModManGetCurrentMod();
     LogInfo("Attaching post-step listener to object %i for mod \"%s\"...",
-            objIdx, ModManGetCurrentMod()->name);
+            objIdx, mod->name);
 
     EnsureStageStrict(STAGE_LISTENER_REG);
     EnsureArg(listener);
@@ -538,7 +544,7 @@ AER_EXPORT void AERObjectAttachPostStepListener(
 
     EventKey key = {
         .type = HLD_EVENT_STEP, .num = HLD_EVENT_STEP_POST, .objIdx = objIdx};
-    EventManRegisterEventListener(obj, key, listener);
+    EventManRegisterEventListener(obj, key, listener, mod->idx, false);
 
     LogInfo("Successfully attached post-step listener.");
     Ok();
@@ -550,8 +556,9 @@ AER_EXPORT void AERObjectAttachCollisionListener(
     int32_t otherObjIdx,
     bool (*listener)(AEREvent*, AERInstance*, AERInstance*)) {
 #define errRet
+    Mod* mod = ModManGetCurrentMod();
     LogInfo("Attaching %i collision listener to object %i for mod \"%s\"...",
-            otherObjIdx, targetObjIdx, ModManGetCurrentMod()->name);
+            otherObjIdx, targetObjIdx, mod->name);
 
     EnsureStageStrict(STAGE_LISTENER_REG);
     EnsureArg(listener);
@@ -563,7 +570,7 @@ AER_EXPORT void AERObjectAttachCollisionListener(
     EventKey key = {.type = HLD_EVENT_COLLISION,
                     .num = otherObjIdx,
                     .objIdx = targetObjIdx};
-    EventManRegisterEventListener(obj, key, listener);
+    EventManRegisterEventListener(obj, key, listener, mod->idx, false);
 
     LogInfo("Successfully attached %i collision listener.", otherObjIdx);
     Ok();
@@ -576,8 +583,9 @@ AER_EXPORT void AERObjectAttachRoomStartListener(
                      AERInstance* target,
                      AERInstance* other)) {
 #define errRet
+    Mod* mod = ModManGetCurrentMod();
     LogInfo("Attaching room start listener to object %i for mod \"%s\"...",
-            objIdx, ModManGetCurrentMod()->name);
+            objIdx, mod->name);
 
     EnsureStageStrict(STAGE_LISTENER_REG);
     EnsureArg(listener);
@@ -588,7 +596,7 @@ AER_EXPORT void AERObjectAttachRoomStartListener(
     EventKey key = {.type = HLD_EVENT_OTHER,
                     .num = HLD_EVENT_OTHER_ROOM_START,
                     .objIdx = objIdx};
-    EventManRegisterEventListener(obj, key, listener);
+    EventManRegisterEventListener(obj, key, listener, mod->idx, false);
 
     LogInfo("Successfully attached room start listener.");
     Ok();
@@ -601,8 +609,9 @@ AER_EXPORT void AERObjectAttachRoomEndListener(
                      AERInstance* target,
                      AERInstance* other)) {
 #define errRet
+    Mod* mod = ModManGetCurrentMod();
     LogInfo("Attaching room end listener to object %i for mod \"%s\"...",
-            objIdx, ModManGetCurrentMod()->name);
+            objIdx, mod->name);
 
     EnsureStageStrict(STAGE_LISTENER_REG);
     EnsureArg(listener);
@@ -613,7 +622,7 @@ AER_EXPORT void AERObjectAttachRoomEndListener(
     EventKey key = {.type = HLD_EVENT_OTHER,
                     .num = HLD_EVENT_OTHER_ROOM_END,
                     .objIdx = objIdx};
-    EventManRegisterEventListener(obj, key, listener);
+    EventManRegisterEventListener(obj, key, listener, mod->idx, false);
 
     LogInfo("Successfully attached room end listener.");
     Ok();
@@ -624,8 +633,9 @@ AER_EXPORT void AERObjectAttachAnimationEndListener(
     int32_t objIdx,
     bool (*listener)(AEREvent*, AERInstance*, AERInstance*)) {
 #define errRet
+    Mod* mod = ModManGetCurrentMod();
     LogInfo("Attaching animation end listener to object %i for mod \"%s\"...",
-            objIdx, ModManGetCurrentMod()->name);
+            objIdx, mod->name);
 
     EnsureStageStrict(STAGE_LISTENER_REG);
     EnsureArg(listener);
@@ -636,7 +646,7 @@ AER_EXPORT void AERObjectAttachAnimationEndListener(
     EventKey key = {.type = HLD_EVENT_OTHER,
                     .num = HLD_EVENT_OTHER_ANIMATION_END,
                     .objIdx = objIdx};
-    EventManRegisterEventListener(obj, key, listener);
+    EventManRegisterEventListener(obj, key, listener, mod->idx, false);
 
     LogInfo("Successfully attached animation end listener.");
     Ok();
@@ -649,8 +659,35 @@ AER_EXPORT void AERObjectAttachDrawListener(
                      AERInstance* target,
                      AERInstance* other)) {
 #define errRet
+    Mod* mod = ModManGetCurrentMod();
     LogInfo("Attaching draw listener to object %i for mod \"%s\"...", objIdx,
-            ModManGetCurrentMod()->name);
+            mod->name);
+
+    EnsureStageStrict(STAGE_LISTENER_REG);
+    EnsureArg(listener);
+
+    HLDObject* obj = HLDObjectLookup(objIdx);
+    EnsureLookup(obj);
+
+    EventKey key = {
+        .type = HLD_EVENT_DRAW, .num = HLD_EVENT_DRAW_NORMAL, .objIdx = objIdx};
+    EventManRegisterEventListener(obj, key, listener, mod->idx, false);
+
+    LogInfo("Successfully attached draw listener.");
+    Ok();
+#undef errRet
+}
+
+AER_EXPORT void AERObjectAttachDrawListenerAdv(
+    int32_t objIdx,
+    bool (*listener)(AEREvent* event,
+                     AERInstance* target,
+                     AERInstance* other),
+    bool cull) {
+#define errRet
+    Mod* mod = ModManGetCurrentMod();
+    LogInfo("Attaching draw listener to object %i for mod \"%s\"...", objIdx,
+            mod->name);
 
     EnsureStageStrict(STAGE_LISTENER_REG);
     EnsureArg(listener);
@@ -660,7 +697,7 @@ AER_EXPORT void AERObjectAttachDrawListener(
 
     EventKey key = {
         .type = HLD_EVENT_DRAW, .num = HLD_EVENT_DRAW_NORMAL, .objIdx = objIdx};
-    EventManRegisterEventListener(obj, key, listener);
+    EventManRegisterEventListener(obj, key, listener, mod->idx, cull);
 
     LogInfo("Successfully attached draw listener.");
     Ok();
@@ -673,8 +710,9 @@ AER_EXPORT void AERObjectAttachGUIDrawListener(
                      AERInstance* target,
                      AERInstance* other)) {
 #define errRet
+    Mod* mod = ModManGetCurrentMod();
     LogInfo("Attaching GUI-draw listener to object %i for mod \"%s\"...",
-            objIdx, ModManGetCurrentMod()->name);
+            objIdx, mod->name);
 
     EnsureStageStrict(STAGE_LISTENER_REG);
     EnsureArg(listener);
@@ -685,7 +723,7 @@ AER_EXPORT void AERObjectAttachGUIDrawListener(
     EventKey key = {.type = HLD_EVENT_DRAW,
                     .num = HLD_EVENT_DRAW_GUI_NORMAL,
                     .objIdx = objIdx};
-    EventManRegisterEventListener(obj, key, listener);
+    EventManRegisterEventListener(obj, key, listener, mod->idx, false);
 
     LogInfo("Successfully attached GUI-draw listener.");
     Ok();
@@ -14,17 +14,167 @@
  * limitations under the License.
  */
 #include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "aer/conf.h"
 #include "aer/err.h"
 #include "internal/log.h"
 #include "internal/option.h"
 
+/* ----- PRIVATE CONSTANTS ----- */
+
+static const char* LOG_LEVEL_NAMES[] = {"info", "warn", "error", "none"};
+
 /* ----- INTERNAL GLOBALS ----- */
 
 Options opts = {0};
 
+/* ----- PRIVATE FUNCTIONS ----- */
+
+static bool GetOptionalBool(const char* key, bool defaultVal) {
+    aererr = AER_TRY;
+    bool result = AERConfGetBool(key);
+    switch (aererr) {
+        case AER_OK:
+            LogInfo(
+                "Found optional configuration key \"%s\" with value \"%i\".",
+                key, result);
+            break;
+        case AER_FAILED_PARSE:
+            LogErr("Optional configuration key \"%s\" must be a boolean.", key);
+            abort();
+        default:
+            LogInfo(
+                "Optional configuration key \"%s\" is undefined. Using default "
+                "value \"%i\".",
+                key, (result = defaultVal));
+    }
+
+    return result;
+}
+
+static uint32_t GetOptionalUInt(const char* key, uint32_t defaultVal) {
+    aererr = AER_TRY;
+    int64_t result = AERConfGetInt(key);
+    switch (aererr) {
+        case AER_OK:
+            if (result < 0 || result > UINT32_MAX) {
+                LogErr(
+                    "Optional configuration key \"%s\" must be a non-negative "
+                    "integer less than or equal to %u.",
+                    key, UINT32_MAX);
+                abort();
+            }
+            LogInfo(
+                "Found optional configuration key \"%s\" with value \"%lli\".",
+                key, (long long)result);
+            break;
+        case AER_FAILED_PARSE:
+            LogErr("Optional configuration key \"%s\" must be an integer.",
+                   key);
+            abort();
+        default:
+            LogInfo(
+                "Optional configuration key \"%s\" is undefined. Using default "
+                "value \"%u\".",
+                key, defaultVal);
+            result = defaultVal;
+    }
+
+    return (uint32_t)result;
+}
+
+static double GetOptionalNonNegDouble(const char* key, double defaultVal) {
+    aererr = AER_TRY;
+    double result = AERConfGetDouble(key);
+    switch (aererr) {
+        case AER_OK:
+            if (!(result >= 0.0)) {
+                LogErr(
+                    "Optional configuration key \"%s\" must be a "
+                    "non-negative number.",
+                    key);
+                abort();
+            }
+            LogInfo(
+                "Found optional configuration key \"%s\" with value \"%f\".",
+                key, result);
+            break;
+        case AER_FAILED_PARSE:
+            LogErr("Optional configuration key \"%s\" must be a float.", key);
+            abort();
+        default:
+            LogInfo(
+                "Optional configuration key \"%s\" is undefined. Using default "
+                "value \"%f\".",
+                key, defaultVal);
+            result = defaultVal;
+    }
+
+    return result;
+}
+
+static const char* GetOptionalString(const char* key,
+                                     const char* defaultVal) {
+    aererr = AER_TRY;
+    const char* result = AERConfGetString(key);
+    switch (aererr) {
+        case AER_OK:
+            LogInfo(
+                "Found optional configuration key \"%s\" with value \"%s\".",
+                key, result);
+            break;
+        case AER_FAILED_PARSE:
+            LogErr("Optional configuration key \"%s\" must be a string.",
+                   key);
+            abort();
+        default:
+            LogInfo(
+                "Optional configuration key \"%s\" is undefined. Using default "
+                "value \"%s\".",
+                key, defaultVal ? defaultVal : "(none)");
+            result = defaultVal;
+    }
+
+    return result;
+}
+
+static LogLevel GetOptionalLogLevel(const char* key, LogLevel defaultVal) {
+    aererr = AER_TRY;
+    const char* result = AERConfGetString(key);
+    switch (aererr) {
+        case AER_OK:
+            for (uint32_t lvl = LOG_INFO; lvl <= LOG_NONE; lvl++) {
+                if (strcmp(result, LOG_LEVEL_NAMES[lvl]) == 0) {
+                    LogInfo(
+                        "Found optional configuration key \"%s\" with value "
+                        "\"%s\".",
+                        key, result);
+                    return (LogLevel)lvl;
+                }
+            }
+            LogErr(
+                "Optional configuration key \"%s\" must be one of \"info\", "
+                "\"warn\", \"error\" or \"none\".",
+                key);
+            abort();
+        case AER_FAILED_PARSE:
+            LogErr("Optional configuration key \"%s\" must be a string.",
+                   key);
+            abort();
+        default:
+            LogInfo(
+                "Optional configuration key \"%s\" is undefined. Using default "
+                "value \"%s\".",
+                key, LOG_LEVEL_NAMES[defaultVal]);
+    }
+
+    return defaultVal;
+}
+
 /* ----- INTERNAL FUNCTIONS ----- */
 
 void OptionConstructor(void) {
@@ -57,25 +207,58 @@ void OptionConstructor(void) {
 
     /* Optional keys. */
 
-    key = "error.promote_unhandled";
-    aererr = AER_TRY;
-    opts.promoteUnhandledErrors = AERConfGetBool(key);
-    switch (aererr) {
-        case AER_OK:
-            LogInfo(
-                "Found optional configuration key \"%s\" with value \"%i\".",
-                key, opts.promoteUnhandledErrors);
-            break;
-        case AER_FAILED_PARSE:
-            LogErr("Optional configuration key \"%s\" must be a boolean.", key);
-            abort();
-        default:
-            LogInfo(
-                "Optional configuration key \"%s\" is undefined. Using default "
-                "value \"%i\".",
-                key, (opts.promoteUnhandledErrors = false));
+    opts.promoteUnhandledErrors =
+        GetOptionalBool("error.promote_unhandled", false);
+
+    opts.loadThreads = GetOptionalUInt("load.threads", 1);
+
+    opts.jobThreads = GetOptionalUInt("jobs.threads", 0);
+
+    opts.hotReload = GetOptionalBool("dev.hot_reload", false);
+
+    double frameBudget = GetOptionalNonNegDouble("budget.frame_ms", 0.0);
+    opts.modFrameBudgets = malloc(opts.numModNames * sizeof(double));
+    assert(opts.modFrameBudgets || opts.numModNames == 0);
+    for (uint32_t idx = 0; idx < opts.numModNames; idx++) {
+        char modKey[128];
+        snprintf(modKey, sizeof(modKey), "budget.mods.%s.frame_ms",
+                 opts.modNames[idx]);
+        opts.modFrameBudgets[idx] =
+            GetOptionalNonNegDouble(modKey, frameBudget);
     }
 
+    opts.budgetSkipSteps = GetOptionalUInt("budget.skip_after", 0);
+
+    opts.drawReportSteps = GetOptionalUInt("profile.draw_report_steps", 0);
+
+    opts.assetPrescan = GetOptionalBool("load.prescan_assets", true);
+
+    opts.lazySpriteReplace = GetOptionalBool("load.lazy_sprite_replace", false);
+
+    opts.prefetchRoomSprites =
+        GetOptionalBool("load.prefetch_room_sprites", true);
+
+    opts.prefetchSpritesPerRoom =
+        GetOptionalUInt("load.prefetch_sprites_per_room", 0);
+
+    LogLevel logLevel = GetOptionalLogLevel("log.level", LOG_INFO);
+    opts.modLogLevels = malloc(opts.numModNames * sizeof(LogLevel));
+    assert(opts.modLogLevels || opts.numModNames == 0);
+    for (uint32_t idx = 0; idx < opts.numModNames; idx++) {
+        char modKey[128];
+        snprintf(modKey, sizeof(modKey), "log.mods.%s.level",
+                 opts.modNames[idx]);
+        opts.modLogLevels[idx] = GetOptionalLogLevel(modKey, logLevel);
+    }
+
+    opts.binLogPath = GetOptionalString("log.binary.path", NULL);
+
+    opts.binLogMaxSize =
+        GetOptionalUInt("log.binary.max_size", 64 * 1024 * 1024);
+
+    /* Set last so that all of the above still gets logged. */
+    opts.logLevel = logLevel;
+
     LogInfo("Done initializing options.");
     return;
 }
@@ -85,6 +268,12 @@ void OptionDestructor(void) {
 
     /* Mod names. */
     free(opts.modNames);
+
+    /* Mod frame budgets. */
+    free(opts.modFrameBudgets);
+
+    /* Mod log levels. */
+    free(opts.modLogLevels);
     opts = (Options){0};
 
     LogInfo("Done deinitializing options.");
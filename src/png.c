@@ -0,0 +1,592 @@
+/**
+ * @copyright 2021 the libaermre authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "internal/png.h"
+
+/* ----- PRIVATE MACROS ----- */
+
+/* Deflate never refers back further than this. */
+#define WINDOW_SIZE 32768
+
+/* ----- PRIVATE TYPES ----- */
+
+typedef struct Huffman {
+    uint16_t counts[16];
+    uint16_t symbols[288];
+} Huffman;
+
+typedef struct BitReader {
+    const uint8_t* cur;
+    const uint8_t* end;
+    uint32_t bits;
+    uint32_t numBits;
+    bool failed;
+} BitReader;
+
+/*
+ * Receives inflated bytes, handing each row on as soon as it is complete. Only
+ * the last `WINDOW_SIZE` bytes and two rows are ever kept.
+ */
+typedef struct RowSink {
+    uint8_t* window;
+    size_t pos;
+    size_t size;
+    /* Each raw row starts with its filter type. */
+    uint8_t* row;
+    uint8_t* prevRow;
+    size_t rowPos;
+    size_t rowSize;
+    uint32_t y;
+    bool (*finishRow)(struct RowSink* sink);
+} RowSink;
+
+typedef struct PNGHeader {
+    uint32_t width;
+    uint32_t height;
+    uint8_t depth;
+    uint8_t colorType;
+    uint32_t channels;
+    bool subByte;
+    uint8_t palette[256][4];
+    int32_t transGray;
+    int32_t transRGB[3];
+} PNGHeader;
+
+typedef struct RowDecoder {
+    RowSink sink;
+    const PNGHeader* header;
+    uint8_t* pixels;
+    PNGRowCallback callback;
+    void* ctx;
+} RowDecoder;
+
+typedef struct ImageBuilder {
+    PNGImage* image;
+    bool failed;
+} ImageBuilder;
+
+/* ----- PRIVATE CONSTANTS ----- */
+
+static const uint8_t PNG_SIGNATURE[8] = {0x89, 'P',  'N',  'G',
+                                         '\r', '\n', 0x1a, '\n'};
+
+static const uint16_t LENGTH_BASES[29] = {
+    3,  4,  5,  6,  7,  8,  9,  10, 11,  13,  15,  17,  19,  23, 27,
+    31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+
+static const uint8_t LENGTH_EXTRAS[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1,
+                                          1, 1, 2, 2, 2, 2, 3, 3, 3, 3,
+                                          4, 4, 4, 4, 5, 5, 5, 5, 0};
+
+static const uint16_t DIST_BASES[30] = {
+    1,   2,   3,   4,   5,   7,    9,    13,   17,   25,
+    33,  49,  65,  97,  129, 193,  257,  385,  513,  769,
+    1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+
+static const uint8_t DIST_EXTRAS[30] = {0, 0, 0, 0, 1, 1, 2,  2,  3,  3,
+                                        4, 4, 5, 5, 6, 6, 7,  7,  8,  8,
+                                        9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+static const uint8_t CODE_LENGTH_ORDER[19] = {16, 17, 18, 0, 8,  7, 9,
+                                              6,  10, 5,  11, 4, 12, 3,
+                                              13, 2,  14, 1,  15};
+
+/* ----- PRIVATE FUNCTIONS ----- */
+
+static inline uint32_t ReadU32BE(const uint8_t* data) {
+    return ((uint32_t)data[0] << 24) | ((uint32_t)data[1] << 16) |
+           ((uint32_t)data[2] << 8) | data[3];
+}
+
+static uint32_t ReadBits(BitReader* reader, uint32_t numBits) {
+    while (reader->numBits < numBits) {
+        if (reader->cur == reader->end) {
+            reader->failed = true;
+            return 0;
+        }
+        reader->bits |= (uint32_t)*reader->cur++ << reader->numBits;
+        reader->numBits += 8;
+    }
+
+    uint32_t result = reader->bits & ((1u << numBits) - 1);
+    reader->bits >>= numBits;
+    reader->numBits -= numBits;
+
+    return result;
+}
+
+static bool BuildHuffman(Huffman* huff,
+                         const uint8_t* lengths,
+                         uint32_t numSymbols) {
+    uint16_t offsets[16];
+
+    memset(huff->counts, 0, sizeof(huff->counts));
+    for (uint32_t sym = 0; sym < numSymbols; sym++)
+        huff->counts[lengths[sym]]++;
+    huff->counts[0] = 0;
+
+    /* Reject oversubscribed codes. */
+    int32_t left = 1;
+    for (uint32_t len = 1; len < 16; len++) {
+        left = (left << 1) - huff->counts[len];
+        if (left < 0)
+            return false;
+    }
+
+    offsets[1] = 0;
+    for (uint32_t len = 1; len < 15; len++)
+        offsets[len + 1] = offsets[len] + huff->counts[len];
+    for (uint32_t sym = 0; sym < numSymbols; sym++) {
+        if (lengths[sym] != 0)
+            huff->symbols[offsets[lengths[sym]]++] = (uint16_t)sym;
+    }
+
+    return true;
+}
+
+static int32_t DecodeSymbol(BitReader* reader, const Huffman* huff) {
+    int32_t code = 0;
+    int32_t first = 0;
+    int32_t index = 0;
+    for (uint32_t len = 1; len < 16; len++) {
+        code |= (int32_t)ReadBits(reader, 1);
+        int32_t count = huff->counts[len];
+        if (code - first < count)
+            return huff->symbols[index + (code - first)];
+        index += count;
+        first = (first + count) << 1;
+        code <<= 1;
+    }
+    reader->failed = true;
+
+    return -1;
+}
+
+static inline bool Emit(RowSink* sink, uint8_t byte) {
+    if (sink->pos == sink->size)
+        return false;
+    sink->window[sink->pos++ % WINDOW_SIZE] = byte;
+    sink->row[sink->rowPos++] = byte;
+    if (sink->rowPos < sink->rowSize)
+        return true;
+
+    sink->rowPos = 0;
+    bool finished = sink->finishRow(sink);
+    uint8_t* row = sink->row;
+    sink->row = sink->prevRow;
+    sink->prevRow = row;
+    sink->y++;
+
+    return finished;
+}
+
+static bool InflateBlock(BitReader* reader,
+                         const Huffman* lits,
+                         const Huffman* dists,
+                         RowSink* sink) {
+    while (!reader->failed) {
+        int32_t sym = DecodeSymbol(reader, lits);
+        if (sym < 0)
+            return false;
+        if (sym < 256) {
+            if (!Emit(sink, (uint8_t)sym))
+                return false;
+            continue;
+        }
+        if (sym == 256)
+            return true;
+
+        sym -= 257;
+        if (sym >= 29)
+            return false;
+        size_t length =
+            LENGTH_BASES[sym] + ReadBits(reader, LENGTH_EXTRAS[sym]);
+        int32_t distSym = DecodeSymbol(reader, dists);
+        if (distSym < 0 || distSym >= 30)
+            return false;
+        size_t dist =
+            DIST_BASES[distSym] + ReadBits(reader, DIST_EXTRAS[distSym]);
+        if (dist > sink->pos || length > sink->size - sink->pos)
+            return false;
+        for (size_t idx = 0; idx < length; idx++) {
+            if (!Emit(sink, sink->window[(sink->pos - dist) % WINDOW_SIZE]))
+                return false;
+        }
+    }
+
+    return false;
+}
+
+static bool InflateDynamicTables(BitReader* reader,
+                                 Huffman* lits,
+                                 Huffman* dists) {
+    uint8_t lengths[320];
+
+    uint32_t numLits = ReadBits(reader, 5) + 257;
+    uint32_t numDists = ReadBits(reader, 5) + 1;
+    uint32_t numCodes = ReadBits(reader, 4) + 4;
+    if (numLits > 286 || numDists > 30)
+        return false;
+
+    memset(lengths, 0, 19);
+    for (uint32_t idx = 0; idx < numCodes; idx++)
+        lengths[CODE_LENGTH_ORDER[idx]] = (uint8_t)ReadBits(reader, 3);
+    Huffman codeLengths;
+    if (!BuildHuffman(&codeLengths, lengths, 19))
+        return false;
+
+    uint32_t idx = 0;
+    while (idx < numLits + numDists && !reader->failed) {
+        int32_t sym = DecodeSymbol(reader, &codeLengths);
+        if (sym < 0)
+            return false;
+        if (sym < 16) {
+            lengths[idx++] = (uint8_t)sym;
+            continue;
+        }
+
+        uint8_t len = 0;
+        uint32_t repeat;
+        if (sym == 16) {
+            if (idx == 0)
+                return false;
+            len = lengths[idx - 1];
+            repeat = 3 + ReadBits(reader, 2);
+        } else if (sym == 17) {
+            repeat = 3 + ReadBits(reader, 3);
+        } else {
+            repeat = 11 + ReadBits(reader, 7);
+        }
+        if (idx + repeat > numLits + numDists)
+            return false;
+        while (repeat-- > 0)
+            lengths[idx++] = len;
+    }
+
+    return !reader->failed && lengths[256] != 0 &&
+           BuildHuffman(lits, lengths, numLits) &&
+           BuildHuffman(dists, lengths + numLits, numDists);
+}
+
+static bool Inflate(const uint8_t* data, size_t size, RowSink* sink) {
+    /* Skip the zlib header; the PNG's CRCs already guard the data. */
+    if (size < 2 || (data[0] & 0x0f) != 8 || (data[1] & 0x20))
+        return false;
+    BitReader reader = {.cur = data + 2, .end = data + size};
+
+    bool last = false;
+    while (!last) {
+        last = ReadBits(&reader, 1);
+        uint32_t type = ReadBits(&reader, 2);
+        if (type == 0) {
+            reader.bits = 0;
+            reader.numBits = 0;
+            if (reader.end - reader.cur < 4)
+                return false;
+            size_t length = reader.cur[0] | (reader.cur[1] << 8);
+            reader.cur += 4;
+            if ((size_t)(reader.end - reader.cur) < length)
+                return false;
+            for (size_t idx = 0; idx < length; idx++) {
+                if (!Emit(sink, reader.cur[idx]))
+                    return false;
+            }
+            reader.cur += length;
+            continue;
+        }
+
+        Huffman lits;
+        Huffman dists;
+        if (type == 1) {
+            uint8_t lengths[288 + 30];
+            memset(lengths, 8, 144);
+            memset(lengths + 144, 9, 112);
+            memset(lengths + 256, 7, 24);
+            memset(lengths + 280, 8, 8);
+            memset(lengths + 288, 5, 30);
+            BuildHuffman(&lits, lengths, 288);
+            BuildHuffman(&dists, lengths + 288, 30);
+        } else if (type != 2 || !InflateDynamicTables(&reader, &lits, &dists)) {
+            return false;
+        }
+        if (!InflateBlock(&reader, &lits, &dists, sink))
+            return false;
+    }
+
+    return sink->pos == sink->size;
+}
+
+static inline uint8_t Paeth(uint8_t a, uint8_t b, uint8_t c) {
+    int32_t p = (int32_t)a + b - c;
+    int32_t pa = abs(p - a);
+    int32_t pb = abs(p - b);
+    int32_t pc = abs(p - c);
+
+    return (pa <= pb && pa <= pc) ? a : (pb <= pc) ? b : c;
+}
+
+/* The previous row is all zeros before the first one. */
+static bool UnfilterRow(uint8_t* row,
+                        const uint8_t* prevRow,
+                        size_t stride,
+                        uint32_t bpp) {
+    uint8_t filter = row[0];
+    row++;
+    prevRow++;
+    for (size_t x = 0; x < stride; x++) {
+        uint8_t a = (x >= bpp) ? row[x - bpp] : 0;
+        uint8_t b = prevRow[x];
+        uint8_t c = (x >= bpp) ? prevRow[x - bpp] : 0;
+        switch (filter) {
+            case 0:
+                break;
+            case 1:
+                row[x] += a;
+                break;
+            case 2:
+                row[x] += b;
+                break;
+            case 3:
+                row[x] += (uint8_t)((a + b) / 2);
+                break;
+            case 4:
+                row[x] += Paeth(a, b, c);
+                break;
+            default:
+                return false;
+        }
+    }
+
+    return true;
+}
+
+static void ConvertRow(const PNGHeader* header,
+                       const uint8_t* row,
+                       uint8_t* out) {
+    uint32_t channels = header->channels;
+    uint32_t depth = header->depth;
+    for (uint32_t x = 0; x < header->width; x++, out += 4) {
+        uint32_t val = row[x * channels * depth / 8];
+        if (header->subByte) {
+            uint32_t shift = 8 - depth - (x * depth) % 8;
+            val = (val >> shift) & ((1u << depth) - 1);
+        }
+
+        switch (header->colorType) {
+            case 0: {
+                uint8_t gray =
+                    (uint8_t)(header->subByte ? val * 255 / ((1u << depth) - 1)
+                                              : val);
+                out[0] = out[1] = out[2] = gray;
+                out[3] = ((int32_t)val == header->transGray) ? 0 : 255;
+                break;
+            }
+            case 3:
+                memcpy(out, header->palette[val], 4);
+                break;
+            case 2:
+                memcpy(out, row + x * 3, 3);
+                out[3] = (out[0] == header->transRGB[0] &&
+                          out[1] == header->transRGB[1] &&
+                          out[2] == header->transRGB[2])
+                             ? 0
+                             : 255;
+                break;
+            case 4:
+                out[0] = out[1] = out[2] = row[x * 2];
+                out[3] = row[x * 2 + 1];
+                break;
+            default:
+                memcpy(out, row + x * 4, 4);
+        }
+    }
+
+    return;
+}
+
+static bool FinishRow(RowSink* sink) {
+    RowDecoder* decoder = (RowDecoder*)sink;
+    const PNGHeader* header = decoder->header;
+    uint32_t bpp = (header->channels * header->depth + 7) / 8;
+    if (!UnfilterRow(sink->row, sink->prevRow, sink->rowSize - 1, bpp))
+        return false;
+    ConvertRow(header, sink->row + 1, decoder->pixels);
+
+    return decoder->callback(decoder->ctx, header->width, header->height,
+                             sink->y, decoder->pixels);
+}
+
+/* On failure, any image data read so far is left for the caller to free. */
+static bool ReadHeader(const uint8_t* data,
+                       size_t size,
+                       PNGHeader* header,
+                       uint8_t** idat,
+                       size_t* idatSize) {
+    *header = (PNGHeader){.transGray = -1, .transRGB = {-1, -1, -1}};
+    memset(header->palette, 0xff, sizeof(header->palette));
+    *idat = NULL;
+    *idatSize = 0;
+
+    size_t pos = 8;
+    bool ended = false;
+    while (!ended && size - pos >= 12) {
+        uint32_t length = ReadU32BE(data + pos);
+        const uint8_t* type = data + pos + 4;
+        const uint8_t* body = data + pos + 8;
+        if (length > size - pos - 12)
+            break;
+
+        if (memcmp(type, "IHDR", 4) == 0 && length >= 13) {
+            header->width = ReadU32BE(body);
+            header->height = ReadU32BE(body + 4);
+            header->depth = body[8];
+            header->colorType = body[9];
+            if (body[12] != 0)
+                return false;
+        } else if (memcmp(type, "PLTE", 4) == 0) {
+            uint32_t numPalette = (length / 3 < 256) ? length / 3 : 256;
+            for (uint32_t idx = 0; idx < numPalette; idx++)
+                memcpy(header->palette[idx], body + idx * 3, 3);
+        } else if (memcmp(type, "tRNS", 4) == 0) {
+            if (header->colorType == 3) {
+                for (uint32_t idx = 0; idx < length && idx < 256; idx++)
+                    header->palette[idx][3] = body[idx];
+            } else if (header->colorType == 0 && length >= 2) {
+                header->transGray = (body[0] << 8) | body[1];
+            } else if (header->colorType == 2 && length >= 6) {
+                for (uint32_t idx = 0; idx < 3; idx++) {
+                    header->transRGB[idx] =
+                        (body[idx * 2] << 8) | body[idx * 2 + 1];
+                }
+            }
+        } else if (memcmp(type, "IDAT", 4) == 0) {
+            uint8_t* grown = realloc(*idat, *idatSize + length);
+            if (!grown)
+                return false;
+            *idat = grown;
+            memcpy(*idat + *idatSize, body, length);
+            *idatSize += length;
+        } else if (memcmp(type, "IEND", 4) == 0) {
+            ended = true;
+        }
+        pos += (size_t)length + 12;
+    }
+
+    switch (header->colorType) {
+        case 0:
+        case 3:
+            header->channels = 1;
+            break;
+        case 2:
+            header->channels = 3;
+            break;
+        case 4:
+            header->channels = 2;
+            break;
+        case 6:
+            header->channels = 4;
+            break;
+        default:
+            header->channels = 0;
+    }
+    uint8_t depth = header->depth;
+    header->subByte = (header->colorType == 0 || header->colorType == 3) &&
+                      (depth == 1 || depth == 2 || depth == 4);
+
+    return header->channels != 0 && (depth == 8 || header->subByte) &&
+           header->width != 0 && header->height != 0 &&
+           header->width <= PNG_MAX_SIZE && header->height <= PNG_MAX_SIZE &&
+           *idat;
+}
+
+static bool AddImageRow(void* ctx,
+                        uint32_t width,
+                        uint32_t height,
+                        uint32_t y,
+                        const uint8_t* pixels) {
+    ImageBuilder* builder = ctx;
+    PNGImage* image = builder->image;
+    if (y == 0) {
+        image->width = width;
+        image->height = height;
+        image->pixels = malloc((size_t)width * height * 4);
+        builder->failed = !image->pixels;
+    }
+    if (builder->failed)
+        return false;
+    memcpy(image->pixels + (size_t)y * width * 4, pixels, (size_t)width * 4);
+
+    return true;
+}
+
+/* ----- INTERNAL FUNCTIONS ----- */
+
+bool PNGDecodeRows(const uint8_t* data,
+                   size_t size,
+                   PNGRowCallback callback,
+                   void* ctx) {
+    if (size < 8 || memcmp(data, PNG_SIGNATURE, 8) != 0)
+        return false;
+
+    PNGHeader header;
+    uint8_t* idat;
+    size_t idatSize;
+    if (!ReadHeader(data, size, &header, &idat, &idatSize)) {
+        free(idat);
+        return false;
+    }
+
+    size_t stride =
+        ((size_t)header.width * header.channels * header.depth + 7) / 8;
+    RowDecoder decoder = {
+        .sink = {.window = malloc(WINDOW_SIZE),
+                 .size = (stride + 1) * header.height,
+                 .row = malloc(stride + 1),
+                 .prevRow = calloc(stride + 1, 1),
+                 .rowSize = stride + 1,
+                 .finishRow = FinishRow},
+        .header = &header,
+        .pixels = malloc((size_t)header.width * 4),
+        .callback = callback,
+        .ctx = ctx};
+    RowSink* sink = &decoder.sink;
+    bool decoded = sink->window && sink->row && sink->prevRow &&
+                   decoder.pixels && Inflate(idat, idatSize, sink);
+    free(decoder.pixels);
+    free(sink->prevRow);
+    free(sink->row);
+    free(sink->window);
+    free(idat);
+
+    return decoded;
+}
+
+bool PNGDecode(const uint8_t* data, size_t size, PNGImage* image) {
+    ImageBuilder builder = {.image = image};
+    image->pixels = NULL;
+    if (!PNGDecodeRows(data, size, AddImageRow, &builder)) {
+        free(image->pixels);
+        image->pixels = NULL;
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,358 @@
+/**
+ * @copyright 2021 the libaermre authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "internal/log.h"
+#include "internal/mod.h"
+#include "internal/option.h"
+#include "internal/profile.h"
+
+/* ----- PRIVATE MACROS ----- */
+
+/* Must be a power of two. */
+#define DRAW_HISTORY_SIZE 256
+
+#define DRAW_HIST_NUM_BUCKETS 16
+
+/* ----- PRIVATE TYPES ----- */
+
+typedef struct ModProfile {
+    uint64_t stepNs;
+    uint64_t prevStepNs;
+    uint64_t budgetNs;
+    uint64_t lastWarnNs;
+    uint32_t numSuppressed;
+    uint32_t numOverSteps;
+    uint32_t numUnderSteps;
+    bool skipping;
+    AERDrawStats drawStep;
+    AERDrawStats prevDrawStep;
+    AERDrawStats drawReport;
+    uint32_t drawHistory[DRAW_HISTORY_SIZE];
+    uint32_t drawHistogram[DRAW_HIST_NUM_BUCKETS];
+} ModProfile;
+
+/* ----- PRIVATE CONSTANTS ----- */
+
+static const uint64_t WARN_INTERVAL_NS = 1000000000;
+
+/* ----- PRIVATE GLOBALS ----- */
+
+static ModProfile* profiles = NULL;
+
+static size_t numProfiles = 0;
+
+/*
+ * Listeners can nest (a listener may perform an event whose listeners belong
+ * to another mod), so time is charged to whichever mod is on top of this
+ * stack.
+ */
+static int32_t modStack[64];
+
+static uint32_t modStackDepth = 0;
+
+static uint64_t lastMarkNs = 0;
+
+/* Draws made outside of any mod are counted here and never reported. */
+static AERDrawStats unownedDrawStats;
+
+static uint32_t drawHistoryPos = 0;
+
+static uint32_t numDrawHistorySteps = 0;
+
+static uint32_t numDrawReportSteps = 0;
+
+/* ----- PRIVATE FUNCTIONS ----- */
+
+static inline uint64_t GetTimeNs(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint64_t)now.tv_sec * 1000000000 + (uint64_t)now.tv_nsec;
+}
+
+static inline void ChargeTopMod(uint64_t nowNs) {
+    if (modStackDepth > 0) {
+        uint32_t topIdx = modStackDepth - 1;
+        size_t stackSize = sizeof(modStack) / sizeof(int32_t);
+        int32_t modIdx =
+            modStack[(topIdx < stackSize) ? topIdx : stackSize - 1];
+        if (modIdx != MOD_NULL)
+            profiles[modIdx].stepNs += nowNs - lastMarkNs;
+    }
+    lastMarkNs = nowNs;
+
+    return;
+}
+
+static void CheckBudget(int32_t modIdx, uint64_t nowNs) {
+    ModProfile* profile = profiles + modIdx;
+    uint32_t skipSteps = opts.budgetSkipSteps;
+
+    if (profile->prevStepNs <= profile->budgetNs) {
+        profile->numOverSteps = 0;
+        profile->numUnderSteps++;
+        if (profile->skipping && profile->numUnderSteps >= skipSteps) {
+            profile->skipping = false;
+            LogInfo("Mod \"%s\" is back within its frame budget.",
+                    ModManGetMod(modIdx)->name);
+        }
+        return;
+    }
+
+    profile->numUnderSteps = 0;
+    profile->numOverSteps++;
+
+    /* Rate-limit warnings so that a slow mod doesn't also flood the log. */
+    if (nowNs - profile->lastWarnNs >= WARN_INTERVAL_NS) {
+        LogWarn(
+            "Mod \"%s\" spent %.3f ms in its listeners during the previous "
+            "step, exceeding its budget of %.3f ms (%u warning(s) suppressed).",
+            ModManGetMod(modIdx)->name, profile->prevStepNs * 0.000001,
+            profile->budgetNs * 0.000001, profile->numSuppressed);
+        profile->lastWarnNs = nowNs;
+        profile->numSuppressed = 0;
+    } else {
+        profile->numSuppressed++;
+    }
+
+    if (skipSteps > 0 && !profile->skipping &&
+        profile->numOverSteps >= skipSteps) {
+        profile->skipping = true;
+        LogWarn(
+            "Mod \"%s\" exceeded its frame budget for %u consecutive steps. "
+            "Skipping its draw listeners until it recovers.",
+            ModManGetMod(modIdx)->name, skipSteps);
+    }
+
+    return;
+}
+
+/*
+ * Bucket 0 holds steps without any draw calls. Bucket N > 0 holds steps with
+ * [2^(N-1), 2^N) draw calls, except for the last bucket which is unbounded.
+ */
+static inline uint32_t GetDrawBucket(uint32_t numCalls) {
+    if (numCalls == 0)
+        return 0;
+
+    uint32_t bucket = 32 - __builtin_clz(numCalls);
+    return (bucket < DRAW_HIST_NUM_BUCKETS) ? bucket
+                                            : DRAW_HIST_NUM_BUCKETS - 1;
+}
+
+static void AddDrawStats(AERDrawStats* dst, const AERDrawStats* src) {
+    dst->numCalls += src->numCalls;
+    dst->numSprites += src->numSprites;
+    dst->numTexts += src->numTexts;
+    dst->numLines += src->numLines;
+    dst->numEllipses += src->numEllipses;
+    dst->numTriangles += src->numTriangles;
+    dst->numRectangles += src->numRectangles;
+    dst->numTextureSwitches += src->numTextureSwitches;
+    dst->numSpritePixels += src->numSpritePixels;
+    dst->numTextChars += src->numTextChars;
+
+    return;
+}
+
+static void RecordDrawStep(ModProfile* profile) {
+    uint32_t* slot = profile->drawHistory + drawHistoryPos;
+    if (numDrawHistorySteps == DRAW_HISTORY_SIZE)
+        profile->drawHistogram[GetDrawBucket(*slot)]--;
+    *slot = profile->drawStep.numCalls;
+    profile->drawHistogram[GetDrawBucket(*slot)]++;
+
+    AddDrawStats(&profile->drawReport, &profile->drawStep);
+    profile->prevDrawStep = profile->drawStep;
+    profile->drawStep = (AERDrawStats){0};
+
+    return;
+}
+
+static void ReportDrawStats(int32_t modIdx) {
+    ModProfile* profile = profiles + modIdx;
+    const AERDrawStats* report = &profile->drawReport;
+    if (report->numCalls == 0)
+        return;
+
+    const char* modName = ModManGetMod(modIdx)->name;
+    double perStep = 1.0 / numDrawReportSteps;
+    uint32_t numPrims = report->numLines + report->numEllipses +
+                        report->numTriangles + report->numRectangles;
+    LogInfo(
+        "Mod \"%s\" made %.1f draw calls per step over the last %u steps "
+        "(%.1f sprites, %.1f texts, %.1f primitives), drawing %.0f sprite "
+        "pixels and %.1f text characters with %.1f texture switches per "
+        "step.",
+        modName, report->numCalls * perStep, numDrawReportSteps,
+        report->numSprites * perStep, report->numTexts * perStep,
+        numPrims * perStep, report->numSpritePixels * perStep,
+        report->numTextChars * perStep, report->numTextureSwitches * perStep);
+
+    char histBuf[512];
+    size_t histLen = 0;
+    for (uint32_t bucket = 0; bucket < DRAW_HIST_NUM_BUCKETS; bucket++) {
+        uint32_t count = profile->drawHistogram[bucket];
+        if (count == 0 || histLen >= sizeof(histBuf))
+            continue;
+
+        uint32_t low = (bucket == 0) ? 0 : 1u << (bucket - 1);
+        uint32_t high = (1u << bucket) - 1;
+        size_t left = sizeof(histBuf) - histLen;
+        if (bucket == DRAW_HIST_NUM_BUCKETS - 1)
+            histLen += snprintf(histBuf + histLen, left, " %u+: %u", low,
+                                count);
+        else if (low >= high)
+            histLen +=
+                snprintf(histBuf + histLen, left, " %u: %u", low, count);
+        else
+            histLen += snprintf(histBuf + histLen, left, " %u-%u: %u", low,
+                                high, count);
+    }
+    LogInfo("Mod \"%s\" draw calls per step over the last %u steps:%s",
+            modName, numDrawHistorySteps, histBuf);
+
+    profile->drawReport = (AERDrawStats){0};
+
+    return;
+}
+
+/* ----- INTERNAL FUNCTIONS ----- */
+
+void ProfileManEnterMod(int32_t modIdx) {
+    ChargeTopMod(GetTimeNs());
+    if (modStackDepth < sizeof(modStack) / sizeof(int32_t))
+        modStack[modStackDepth] = modIdx;
+    modStackDepth++;
+
+    return;
+}
+
+void ProfileManLeaveMod(void) {
+    assert(modStackDepth > 0);
+
+    ChargeTopMod(GetTimeNs());
+    modStackDepth--;
+
+    return;
+}
+
+void ProfileManAddModTime(int32_t modIdx, uint64_t elapsedNs) {
+    assert(modIdx >= 0 && (size_t)modIdx < numProfiles);
+
+    profiles[modIdx].stepNs += elapsedNs;
+
+    return;
+}
+
+bool ProfileManShouldSkip(int32_t modIdx) {
+    return modIdx != MOD_NULL && profiles[modIdx].skipping;
+}
+
+double ProfileManGetFrameTime(int32_t modIdx) {
+    assert(modIdx >= 0 && (size_t)modIdx < numProfiles);
+
+    return profiles[modIdx].prevStepNs * 0.000000001;
+}
+
+AERDrawStats* ProfileManGetDrawStats(int32_t modIdx) {
+    if (modIdx == MOD_NULL)
+        return &unownedDrawStats;
+    assert(modIdx >= 0 && (size_t)modIdx < numProfiles);
+
+    return &profiles[modIdx].drawStep;
+}
+
+const AERDrawStats* ProfileManGetPrevDrawStats(int32_t modIdx) {
+    assert(modIdx >= 0 && (size_t)modIdx < numProfiles);
+
+    return &profiles[modIdx].prevDrawStep;
+}
+
+size_t ProfileManGetDrawHistogram(int32_t modIdx,
+                                  size_t bufSize,
+                                  uint32_t* histBuf) {
+    assert(modIdx >= 0 && (size_t)modIdx < numProfiles);
+
+    const uint32_t* histogram = profiles[modIdx].drawHistogram;
+    for (size_t idx = 0; idx < bufSize && idx < DRAW_HIST_NUM_BUCKETS; idx++)
+        histBuf[idx] = histogram[idx];
+
+    return DRAW_HIST_NUM_BUCKETS;
+}
+
+void ProfileManEndStep(void) {
+    uint64_t nowNs = GetTimeNs();
+    ChargeTopMod(nowNs);
+
+    for (uint32_t idx = 0; idx < numProfiles; idx++) {
+        ModProfile* profile = profiles + idx;
+        profile->prevStepNs = profile->stepNs;
+        profile->stepNs = 0;
+        if (profile->budgetNs > 0)
+            CheckBudget(idx, nowNs);
+        RecordDrawStep(profile);
+    }
+    drawHistoryPos = (drawHistoryPos + 1) & (DRAW_HISTORY_SIZE - 1);
+    if (numDrawHistorySteps < DRAW_HISTORY_SIZE)
+        numDrawHistorySteps++;
+    numDrawReportSteps++;
+
+    if (opts.drawReportSteps > 0 &&
+        numDrawReportSteps >= opts.drawReportSteps) {
+        for (uint32_t idx = 0; idx < numProfiles; idx++)
+            ReportDrawStats(idx);
+        numDrawReportSteps = 0;
+    }
+
+    return;
+}
+
+void ProfileManConstructor(void) {
+    LogInfo("Initializing profile module...");
+
+    numProfiles = opts.numModNames;
+    profiles = calloc(numProfiles, sizeof(ModProfile));
+    assert(profiles || numProfiles == 0);
+    for (uint32_t idx = 0; idx < numProfiles; idx++) {
+        profiles[idx].budgetNs =
+            (uint64_t)(opts.modFrameBudgets[idx] * 1000000.0);
+    }
+
+    LogInfo("Done initializing profile module.");
+    return;
+}
+
+void ProfileManDestructor(void) {
+    LogInfo("Deinitializing profile module...");
+
+    free(profiles);
+    profiles = NULL;
+    numProfiles = 0;
+    drawHistoryPos = 0;
+    numDrawHistorySteps = 0;
+    numDrawReportSteps = 0;
+
+    LogInfo("Done deinitializing profile module.");
+    return;
+}
@@ -13,30 +13,179 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
 #include <time.h>
 
+#include "foxutils/mapmacs.h"
+#include "foxutils/math.h"
 #include "foxutils/rand.h"
 #include "foxutils/xoshiro256ss.h"
 
 #include "aer/rand.h"
+#include "internal/core.h"
 #include "internal/err.h"
 #include "internal/export.h"
+#include "internal/hld.h"
+#include "internal/object.h"
 #include "internal/rand.h"
 
+/* ----- PRIVATE MACROS ----- */
+
+#define NUM_LANES 4
+
+/* Below this many values, seeding lanes costs more than it saves. */
+#define MIN_MULTI_LANE_SIZE 64
+
+/* Ziggurat parameters from Marsaglia and Tsang. */
+#define ZIG_NORM_LAYERS 128
+
+#define ZIG_NORM_R 3.442619855899
+
+#define ZIG_NORM_V 9.91256303526217e-3
+
+#define ZIG_EXP_LAYERS 256
+
+#define ZIG_EXP_R 7.69711747013104972
+
+#define ZIG_EXP_V 3.949659822581572e-3
+
+/* Up to this many samples, a linear scan beats hashing for membership. */
+#define SAMPLE_LINEAR_MAX 32
+
+/* Fibonacci hashing multiplier (2^64 divided by the golden ratio). */
+#define SAMPLE_HASH_MUL UINT64_C(0x9E3779B97F4A7C15)
+
+#define LaneRotL(x, shift) (((x) << (shift)) | ((x) >> (64 - (shift))))
+
+/*
+ * Fisher-Yates shuffle of elements of a fixed width, drawing each index on
+ * [0, bound) with `drawIdx`. With a constant `elemSize`, each `memcpy` lowers
+ * to plain (unaligned) loads and stores.
+ */
+#define ShuffleFixed(prng, drawIdx, elemSize, bufSize, elemBuf)             \
+    do {                                                                    \
+        FoxPRNG* ShuffleFixed_prng = (prng);                                \
+        uint8_t* ShuffleFixed_buf = (uint8_t*)(elemBuf);                    \
+        for (size_t ShuffleFixed_idx = (bufSize); ShuffleFixed_idx > 1;     \
+             ShuffleFixed_idx--) {                                          \
+            uint8_t* ShuffleFixed_a =                                       \
+                ShuffleFixed_buf + (elemSize) * (ShuffleFixed_idx - 1);     \
+            uint8_t* ShuffleFixed_b =                                       \
+                ShuffleFixed_buf +                                          \
+                (elemSize) * drawIdx(ShuffleFixed_prng, ShuffleFixed_idx);  \
+            uint8_t ShuffleFixed_tmp[elemSize];                             \
+            memcpy(ShuffleFixed_tmp, ShuffleFixed_a, (elemSize));           \
+            memcpy(ShuffleFixed_a, ShuffleFixed_b, (elemSize));             \
+            memcpy(ShuffleFixed_b, ShuffleFixed_tmp, (elemSize));           \
+        }                                                                   \
+    } while (0)
+
+/* ----- PRIVATE TYPES ----- */
+
+/*
+ * On SSE2 these lower to pairs of 128-bit operations. xoshiro256** only
+ * multiplies by constants, which reduce to shifts and adds, so nothing here
+ * needs 64-bit vector multiplication.
+ */
+typedef uint64_t LaneVec __attribute__((vector_size(NUM_LANES * 8)));
+
+typedef uint32_t LaneVec32 __attribute__((vector_size(NUM_LANES * 4)));
+
+typedef float LaneVecFloat __attribute__((vector_size(NUM_LANES * 4)));
+
+/* `NUM_LANES` interleaved xoshiro256** generators. */
+typedef struct MultiLanePRNG {
+    LaneVec state[4];
+} MultiLanePRNG;
+
+/*
+ * Walker's alias method. Column `idx` is kept with probability
+ * `thresholds[idx] / 2^32`, otherwise its alias is chosen instead.
+ */
+typedef struct AliasTable {
+    size_t size;
+    uint64_t* thresholds;
+    uint32_t* aliases;
+} AliasTable;
+
+typedef struct SampleInstancesContext {
+    FoxPRNG* prng;
+    size_t numSeen;
+    const size_t bufSize;
+    HLDInstance** const instBuf;
+} SampleInstancesContext;
+
+/* ----- PRIVATE CONSTANTS ----- */
+
+/* Jump polynomial of xoshiro256**, equivalent to 2^128 calls to next. */
+static const uint64_t JUMP_POLY[4] = {0x180EC6D33CFD0ABA, 0xD5A61266F0C9392C,
+                                      0xA9582618E03FC9AA, 0x39ABDC4529B1661C};
+
 /* ----- PRIVATE GLOBALS ----- */
 
 static FoxXoshiro256SS randPRNG = {0};
 
+/*
+ * Layer edges of the ziggurats, widest first, and the fraction of each layer
+ * that lies entirely under the density.
+ */
+static double zigNormX[ZIG_NORM_LAYERS + 1];
+
+static double zigNormR[ZIG_NORM_LAYERS];
+
+static double zigExpX[ZIG_EXP_LAYERS + 1];
+
+static double zigExpR[ZIG_EXP_LAYERS];
+
 /* ----- PRIVATE FUNCTIONS ----- */
 
+/*
+ * Lemire's nearly divisionless method: an unbiased index on [0, bound) from
+ * usually one draw and one multiplication. Argument `bound` must not be `0`.
+ */
+static inline size_t UniformIdx(FoxPRNG* prng, size_t bound) {
+#if SIZE_MAX > UINT32_MAX
+    if (bound > UINT32_MAX)
+        return FoxRandUIntRange(prng, 0, bound);
+#endif
+
+    uint32_t bound32 = bound;
+    uint64_t prod = (FoxRandUInt(prng) >> 32) * bound32;
+    if ((uint32_t)prod < bound32) {
+        uint32_t threshold = -bound32 % bound32;
+        while ((uint32_t)prod < threshold)
+            prod = (FoxRandUInt(prng) >> 32) * bound32;
+    }
+
+    return prod >> 32;
+}
+
+/*
+ * Index draw used by shuffles since before UniformIdx, kept for the original
+ * shuffle functions so that a given seed still yields the same permutation.
+ */
+static inline size_t LegacyIdx(FoxPRNG* prng, size_t bound) {
+    return FoxRandUIntRange(prng, 0, bound);
+}
+
 static inline void MemSwap(size_t size,
                            uint8_t* restrict bufA,
                            uint8_t* restrict bufB) {
-    for (size_t idx = 0; idx < size; idx++) {
-        /*
-         * Temporary variable method of swapping is technically faster than XOR
-         * swapping in this situation due to memory accesses.
-         */
+    /*
+     * Temporary variable method of swapping is technically faster than XOR
+     * swapping in this situation due to memory accesses.
+     */
+    size_t idx = 0;
+    for (; idx + sizeof(uint64_t) <= size; idx += sizeof(uint64_t)) {
+        uint64_t tmp;
+        memcpy(&tmp, bufA + idx, sizeof(uint64_t));
+        memcpy(bufA + idx, bufB + idx, sizeof(uint64_t));
+        memcpy(bufB + idx, &tmp, sizeof(uint64_t));
+    }
+    for (; idx < size; idx++) {
         uint8_t tmp = bufA[idx];
         bufA[idx] = bufB[idx];
         bufB[idx] = tmp;
@@ -45,27 +194,486 @@ static inline void MemSwap(size_t size,
     return;
 }
 
-static inline void Shuffle(FoxPRNG* prng,
-                           size_t elemSize,
+static void Shuffle(FoxPRNG* prng,
+                    size_t elemSize,
+                    size_t bufSize,
+                    void* elemBuf) {
+    switch (elemSize) {
+        case 4:
+            ShuffleFixed(prng, LegacyIdx, 4, bufSize, elemBuf);
+            break;
+        case 8:
+            ShuffleFixed(prng, LegacyIdx, 8, bufSize, elemBuf);
+            break;
+        case 16:
+            ShuffleFixed(prng, LegacyIdx, 16, bufSize, elemBuf);
+            break;
+        default:
+            for (size_t idx = bufSize; idx > 1; idx--) {
+                size_t newIdx = LegacyIdx(prng, idx);
+                if (newIdx != idx - 1) {
+                    MemSwap(elemSize, elemBuf + elemSize * (idx - 1),
+                            elemBuf + elemSize * newIdx);
+                }
+            }
+    }
+
+    return;
+}
+
+/*
+ * Floyd's algorithm, which draws exactly `bufSize` indices. Its output order
+ * is not uniform, so the result is shuffled afterwards.
+ */
+static void Sample(FoxPRNG* prng,
+                   size_t bufSize,
+                   size_t popSize,
+                   size_t* idxBuf) {
+    if (bufSize <= SAMPLE_LINEAR_MAX) {
+        for (size_t idx = 0; idx < bufSize; idx++) {
+            size_t cand = popSize - bufSize + idx;
+            size_t pick = UniformIdx(prng, cand + 1);
+            for (size_t prevIdx = 0; prevIdx < idx; prevIdx++) {
+                if (idxBuf[prevIdx] == pick) {
+                    pick = cand;
+                    break;
+                }
+            }
+            idxBuf[idx] = pick;
+        }
+    } else {
+        /* Open addressing at load factor of at most one half. */
+        uint32_t shift = 64;
+        size_t setSize = 1;
+        while (setSize < 2 * bufSize) {
+            setSize <<= 1;
+            shift--;
+        }
+        size_t mask = setSize - 1;
+        size_t* set = calloc(setSize, sizeof(size_t));
+        assert(set);
+
+        for (size_t idx = 0; idx < bufSize; idx++) {
+            size_t cand = popSize - bufSize + idx;
+            size_t pick = UniformIdx(prng, cand + 1);
+            for (size_t key = pick;; key = cand) {
+                size_t slot = ((uint64_t)key * SAMPLE_HASH_MUL) >> shift;
+                while (set[slot] != 0 && set[slot] != key + 1)
+                    slot = (slot + 1) & mask;
+                if (set[slot] == 0) {
+                    set[slot] = key + 1;
+                    pick = key;
+                    break;
+                }
+            }
+            idxBuf[idx] = pick;
+        }
+
+        free(set);
+    }
+
+    ShuffleFixed(prng, UniformIdx, sizeof(size_t), bufSize, idxBuf);
+
+    return;
+}
+
+/* Algorithm R, walking instance lists in place without copying them. */
+static bool SampleInstancesCallback(const int32_t* objIdx,
+                                    SampleInstancesContext* ctx) {
+    HLDObject* obj = HLDObjectLookup(*objIdx);
+    if (!obj)
+        return false;
+
+    for (HLDNodeDLL* node = obj->instanceFirst; node; node = node->next) {
+        size_t seen = ctx->numSeen++;
+        if (seen < ctx->bufSize) {
+            ctx->instBuf[seen] = node->item;
+        } else {
+            size_t slot = UniformIdx(ctx->prng, seen + 1);
+            if (slot < ctx->bufSize)
+                ctx->instBuf[slot] = node->item;
+        }
+    }
+
+    return true;
+}
+
+static size_t SampleInstances(FoxPRNG* prng,
+                              int32_t objIdx,
+                              bool recursive,
+                              size_t bufSize,
+                              AERInstance** instBuf) {
+    SampleInstancesContext ctx = {
+        .prng = prng,
+        .numSeen = 0,
+        .bufSize = bufSize,
+        .instBuf = (HLDInstance**)instBuf,
+    };
+    SampleInstancesCallback(&objIdx, &ctx);
+
+    if (recursive) {
+        FoxMap* children = ObjectManGetAllChildren(objIdx);
+        if (children) {
+            FoxMapMForEachKey(int32_t, int32_t, children,
+                              SampleInstancesCallback, &ctx);
+        }
+    }
+
+    /* Reservoir order depends on list order, so shuffle what was kept. */
+    ShuffleFixed(prng, UniformIdx, sizeof(AERInstance*),
+                 FoxMin(ctx.numSeen, bufSize), instBuf);
+
+    return ctx.numSeen;
+}
+
+/* Vectors wider than 128 bits are never passed by value, keeping the ABI. */
+static inline void MultiLaneNext(MultiLanePRNG* prng, LaneVec* result) {
+    LaneVec* state = prng->state;
+    LaneVec vals = state[1] + (state[1] << 2);
+    vals = LaneRotL(vals, 7);
+    *result = vals + (vals << 3);
+
+    LaneVec tmp = state[1] << 17;
+    state[2] ^= state[0];
+    state[3] ^= state[1];
+    state[1] ^= state[2];
+    state[0] ^= state[3];
+    state[2] ^= tmp;
+    state[3] = LaneRotL(state[3], 45);
+
+    return;
+}
+
+/*
+ * Lanes are seeded from the source generator, so a fill consumes a fixed
+ * number of its values and stays deterministic for a given source state.
+ */
+static void MultiLaneSeed(MultiLanePRNG* prng, FoxPRNG* src) {
+    for (uint32_t word = 0; word < 4; word++) {
+        for (uint32_t lane = 0; lane < NUM_LANES; lane++)
+            prng->state[word][lane] = FoxRandUInt(src);
+    }
+    /* An all-zero state would only ever produce zeroes. */
+    for (uint32_t lane = 0; lane < NUM_LANES; lane++) {
+        if ((prng->state[0][lane] | prng->state[1][lane] |
+             prng->state[2][lane] | prng->state[3][lane]) == 0)
+            prng->state[0][lane] = 1;
+    }
+
+    return;
+}
+
+static void FillUInt(FoxPRNG* src, size_t bufSize, uint64_t* uintBuf) {
+    if (bufSize < MIN_MULTI_LANE_SIZE) {
+        for (size_t idx = 0; idx < bufSize; idx++)
+            uintBuf[idx] = FoxRandUInt(src);
+        return;
+    }
+
+    MultiLanePRNG prng;
+    MultiLaneSeed(&prng, src);
+    size_t idx = 0;
+    for (; idx + NUM_LANES <= bufSize; idx += NUM_LANES) {
+        LaneVec vals;
+        MultiLaneNext(&prng, &vals);
+        memcpy(uintBuf + idx, &vals, sizeof(vals));
+    }
+    if (idx < bufSize) {
+        LaneVec vals;
+        MultiLaneNext(&prng, &vals);
+        memcpy(uintBuf + idx, &vals, (bufSize - idx) * sizeof(uint64_t));
+    }
+
+    return;
+}
+
+/*
+ * Each 64-bit value yields two floats, one from its top 24 bits and one from
+ * the 24 bits below those.
+ */
+static void FillFloatRange(FoxPRNG* src,
+                           float min,
+                           float max,
                            size_t bufSize,
-                           void* elemBuf) {
-    for (size_t idx = bufSize - 1; idx > 0; idx--) {
-        size_t newIdx = FoxRandUIntRange(prng, 0, idx + 1);
-        if (newIdx != idx) {
-            MemSwap(elemSize, elemBuf + elemSize * idx,
-                    elemBuf + elemSize * newIdx);
+                           float* floatBuf) {
+    float scale = max - min;
+    if (bufSize < MIN_MULTI_LANE_SIZE) {
+        for (size_t idx = 0; idx < bufSize; idx++)
+            floatBuf[idx] = min + FoxRandFloat(src) * scale;
+        return;
+    }
+
+    MultiLanePRNG prng;
+    MultiLaneSeed(&prng, src);
+    LaneVecFloat vecScale = scale * 0x1.0p-24f - (LaneVecFloat){0};
+    LaneVecFloat vecMin = min - (LaneVecFloat){0};
+    size_t idx = 0;
+    while (idx < bufSize) {
+        LaneVec vals;
+        MultiLaneNext(&prng, &vals);
+        LaneVecFloat halves[2] = {
+            __builtin_convertvector(
+                __builtin_convertvector(vals >> 40, LaneVec32), LaneVecFloat),
+            __builtin_convertvector(
+                __builtin_convertvector((vals >> 16) & 0xFFFFFF, LaneVec32),
+                LaneVecFloat)};
+        for (uint32_t half = 0; half < 2 && idx < bufSize; half++) {
+            LaneVecFloat floats = vecMin + halves[half] * vecScale;
+            size_t numToWrite = bufSize - idx;
+            if (numToWrite > NUM_LANES)
+                numToWrite = NUM_LANES;
+            memcpy(floatBuf + idx, &floats, numToWrite * sizeof(float));
+            idx += numToWrite;
+        }
+    }
+
+    return;
+}
+
+static void FillDouble(FoxPRNG* src, size_t bufSize, double* doubleBuf) {
+    if (bufSize < MIN_MULTI_LANE_SIZE) {
+        for (size_t idx = 0; idx < bufSize; idx++)
+            doubleBuf[idx] = FoxRandDouble(src);
+        return;
+    }
+
+    MultiLanePRNG prng;
+    MultiLaneSeed(&prng, src);
+    size_t idx = 0;
+    while (idx < bufSize) {
+        LaneVec vals;
+        MultiLaneNext(&prng, &vals);
+        vals >>= 11;
+        for (uint32_t lane = 0; lane < NUM_LANES && idx < bufSize; lane++)
+            doubleBuf[idx++] = (double)vals[lane] * 0x1.0p-53;
+    }
+
+    return;
+}
+
+/* The only place that depends on the layout of the generator's state. */
+static inline uint64_t* GetGenState(FoxXoshiro256SS* prng) {
+    return prng->state;
+}
+
+static void Jump(FoxXoshiro256SS* prng) {
+    uint64_t* state = GetGenState(prng);
+    uint64_t jumped[4] = {0};
+    for (uint32_t word = 0; word < 4; word++) {
+        for (uint32_t bit = 0; bit < 64; bit++) {
+            if (JUMP_POLY[word] & (UINT64_C(1) << bit)) {
+                jumped[0] ^= state[0];
+                jumped[1] ^= state[1];
+                jumped[2] ^= state[2];
+                jumped[3] ^= state[3];
+            }
+            FoxRandUInt((FoxPRNG*)prng);
         }
     }
+    memcpy(state, jumped, sizeof(jumped));
+
+    return;
+}
+
+/* SplitMix64 finalizer. */
+static inline uint64_t Mix(uint64_t val) {
+    val = (val ^ (val >> 30)) * 0xBF58476D1CE4E5B9;
+    val = (val ^ (val >> 27)) * 0x94D049BB133111EB;
+
+    return val ^ (val >> 31);
+}
+
+static uint64_t GetStreamSeed(uint64_t seed, int32_t roomIdx, int32_t instId) {
+    uint64_t key = ((uint64_t)(uint32_t)roomIdx << 32) | (uint32_t)instId;
+
+    return Mix(seed + Mix(key + 0x9E3779B97F4A7C15));
+}
+
+/* Layout of the ziggurats follows Doornik's "An Improved Ziggurat Method". */
+static void InitZiggurats(void) {
+    double density = exp(-0.5 * ZIG_NORM_R * ZIG_NORM_R);
+    zigNormX[0] = ZIG_NORM_V / density;
+    zigNormX[1] = ZIG_NORM_R;
+    for (uint32_t idx = 2; idx < ZIG_NORM_LAYERS; idx++) {
+        zigNormX[idx] =
+            sqrt(-2.0 * log(ZIG_NORM_V / zigNormX[idx - 1] + density));
+        density = exp(-0.5 * zigNormX[idx] * zigNormX[idx]);
+    }
+    zigNormX[ZIG_NORM_LAYERS] = 0.0;
+    for (uint32_t idx = 0; idx < ZIG_NORM_LAYERS; idx++)
+        zigNormR[idx] = zigNormX[idx + 1] / zigNormX[idx];
+
+    density = exp(-ZIG_EXP_R);
+    zigExpX[0] = ZIG_EXP_V / density;
+    zigExpX[1] = ZIG_EXP_R;
+    for (uint32_t idx = 2; idx < ZIG_EXP_LAYERS; idx++) {
+        zigExpX[idx] = -log(ZIG_EXP_V / zigExpX[idx - 1] + density);
+        density = exp(-zigExpX[idx]);
+    }
+    zigExpX[ZIG_EXP_LAYERS] = 0.0;
+    for (uint32_t idx = 0; idx < ZIG_EXP_LAYERS; idx++)
+        zigExpR[idx] = zigExpX[idx + 1] / zigExpX[idx];
+
+    return;
+}
+
+/* Uniform on the open interval (0.0, 1.0), so it is safe to take the log. */
+static inline double OpenUniform(FoxPRNG* prng) {
+    return ((double)(FoxRandUInt(prng) >> 11) + 0.5) * 0x1.0p-53;
+}
+
+static double SampleNormal(FoxPRNG* prng) {
+    while (true) {
+        /* One draw gives both the layer and the position within it. */
+        uint64_t bits = FoxRandUInt(prng);
+        uint32_t layer = bits & (ZIG_NORM_LAYERS - 1);
+        double pos = (double)(bits >> 11) * 0x1.0p-52 - 1.0;
+        if (fabs(pos) < zigNormR[layer])
+            return pos * zigNormX[layer];
+
+        /* Base layer overhangs into the tail. */
+        if (layer == 0) {
+            double x, y;
+            do {
+                x = log(OpenUniform(prng)) / ZIG_NORM_R;
+                y = log(OpenUniform(prng));
+            } while (-2.0 * y < x * x);
+            return (pos < 0.0) ? x - ZIG_NORM_R : ZIG_NORM_R - x;
+        }
+
+        /* Wedge between this layer's edge and the density. */
+        double x = pos * zigNormX[layer];
+        double xSq = x * x;
+        double outer = exp(-0.5 * (zigNormX[layer] * zigNormX[layer] - xSq));
+        double inner =
+            exp(-0.5 * (zigNormX[layer + 1] * zigNormX[layer + 1] - xSq));
+        if (inner + OpenUniform(prng) * (outer - inner) < 1.0)
+            return x;
+    }
+}
+
+static double SampleExponential(FoxPRNG* prng) {
+    while (true) {
+        uint64_t bits = FoxRandUInt(prng);
+        uint32_t layer = bits & (ZIG_EXP_LAYERS - 1);
+        double pos = (double)(bits >> 11) * 0x1.0p-53;
+        if (pos < zigExpR[layer])
+            return pos * zigExpX[layer];
+
+        /* The tail of an exponential is itself exponential. */
+        if (layer == 0)
+            return ZIG_EXP_R - log(OpenUniform(prng));
+
+        double x = pos * zigExpX[layer];
+        double outer = exp(x - zigExpX[layer]);
+        double inner = exp(x - zigExpX[layer + 1]);
+        if (inner + OpenUniform(prng) * (outer - inner) < 1.0)
+            return x;
+    }
+}
+
+static inline size_t SampleAlias(FoxPRNG* prng, const AliasTable* table) {
+    uint64_t bits = FoxRandUInt(prng);
+    size_t column = ((bits >> 32) * table->size) >> 32;
+
+    return ((bits & 0xFFFFFFFF) < table->thresholds[column])
+               ? column
+               : table->aliases[column];
+}
+
+static void FillNormal(FoxPRNG* prng,
+                       double mean,
+                       double stdDev,
+                       size_t bufSize,
+                       double* doubleBuf) {
+    for (size_t idx = 0; idx < bufSize; idx++)
+        doubleBuf[idx] = mean + stdDev * SampleNormal(prng);
 
     return;
 }
 
+static void FillExponential(FoxPRNG* prng,
+                            double rate,
+                            size_t bufSize,
+                            double* doubleBuf) {
+    double scale = 1.0 / rate;
+    for (size_t idx = 0; idx < bufSize; idx++)
+        doubleBuf[idx] = SampleExponential(prng) * scale;
+
+    return;
+}
+
+static void FillAlias(FoxPRNG* prng,
+                      const AliasTable* table,
+                      size_t bufSize,
+                      size_t* idxBuf) {
+    for (size_t idx = 0; idx < bufSize; idx++)
+        idxBuf[idx] = SampleAlias(prng, table);
+
+    return;
+}
+
+/* Vose's variant, which is numerically stable. */
+static AliasTable* NewAliasTable(size_t numWeights,
+                                 const double* weights,
+                                 double totalWeight) {
+    AliasTable* table = malloc(sizeof(AliasTable) +
+                               numWeights * (sizeof(uint64_t) +
+                                             sizeof(uint32_t)));
+    double* probs = malloc(numWeights * sizeof(double));
+    uint32_t* work = malloc(numWeights * sizeof(uint32_t));
+    assert(table && probs && work);
+    table->size = numWeights;
+    table->thresholds = (uint64_t*)(table + 1);
+    table->aliases = (uint32_t*)(table->thresholds + numWeights);
+
+    /* Small columns fill the work list from the front, large from the back. */
+    size_t numSmall = 0;
+    size_t largeStart = numWeights;
+    for (size_t idx = 0; idx < numWeights; idx++) {
+        probs[idx] = weights[idx] * numWeights / totalWeight;
+        if (probs[idx] < 1.0)
+            work[numSmall++] = idx;
+        else
+            work[--largeStart] = idx;
+    }
+
+    while (numSmall > 0 && largeStart < numWeights) {
+        uint32_t small = work[--numSmall];
+        uint32_t large = work[largeStart];
+        table->thresholds[small] = (uint64_t)(probs[small] * 0x1.0p32);
+        table->aliases[small] = large;
+        probs[large] -= 1.0 - probs[small];
+        if (probs[large] < 1.0) {
+            largeStart++;
+            work[numSmall++] = large;
+        }
+    }
+
+    /* Whatever is left over is full, up to rounding error. */
+    while (numSmall > 0) {
+        uint32_t idx = work[--numSmall];
+        table->thresholds[idx] = UINT64_C(1) << 32;
+        table->aliases[idx] = idx;
+    }
+    for (; largeStart < numWeights; largeStart++) {
+        uint32_t idx = work[largeStart];
+        table->thresholds[idx] = UINT64_C(1) << 32;
+        table->aliases[idx] = idx;
+    }
+
+    free(work);
+    free(probs);
+    return table;
+}
+
 /* ----- INTERNAL FUNCTIONS ----- */
 
 void RandConstructor(void) {
     LogInfo("Initializing random module...");
 
     FoxXoshiro256SSInit(&randPRNG, time(NULL));
+    InitZiggurats();
 
     LogInfo("Done initializing random module.");
     return;
@@ -145,10 +753,218 @@ AER_EXPORT void AERRandShuffle(size_t elemSize, size_t bufSize, void* elemBuf) {
 #undef errRet
 }
 
+AER_EXPORT void AERRandShuffle32(size_t bufSize, void* elemBuf) {
+#define errRet
+    EnsureArgBuf(elemBuf, bufSize);
+
+    ShuffleFixed((FoxPRNG*)&randPRNG, UniformIdx, 4, bufSize, elemBuf);
+
+    Ok();
+#undef errRet
+}
+
+AER_EXPORT void AERRandShuffle64(size_t bufSize, void* elemBuf) {
+#define errRet
+    EnsureArgBuf(elemBuf, bufSize);
+
+    ShuffleFixed((FoxPRNG*)&randPRNG, UniformIdx, 8, bufSize, elemBuf);
+
+    Ok();
+#undef errRet
+}
+
+AER_EXPORT void AERRandShuffle128(size_t bufSize, void* elemBuf) {
+#define errRet
+    EnsureArgBuf(elemBuf, bufSize);
+
+    ShuffleFixed((FoxPRNG*)&randPRNG, UniformIdx, 16, bufSize, elemBuf);
+
+    Ok();
+#undef errRet
+}
+
+AER_EXPORT void AERRandShufflePtr(size_t bufSize, void** ptrBuf) {
+#define errRet
+    EnsureArgBuf(ptrBuf, bufSize);
+
+    ShuffleFixed((FoxPRNG*)&randPRNG, UniformIdx, sizeof(void*), bufSize,
+                 ptrBuf);
+
+    Ok();
+#undef errRet
+}
+
+AER_EXPORT void AERRandSample(size_t bufSize, size_t popSize, size_t* idxBuf) {
+#define errRet
+    EnsureArgBuf(idxBuf, bufSize);
+    EnsureMax(bufSize, popSize);
+
+    Sample((FoxPRNG*)&randPRNG, bufSize, popSize, idxBuf);
+
+    Ok();
+#undef errRet
+}
+
+AER_EXPORT size_t AERRandSampleInstances(int32_t objIdx,
+                                         bool recursive,
+                                         size_t bufSize,
+                                         AERInstance** instBuf) {
+#define errRet 0
+    EnsureStageMut(STAGE_ACTION);
+    EnsureArgBuf(instBuf, bufSize);
+    EnsureLookup(HLDObjectLookup(objIdx));
+
+    Ok(SampleInstances((FoxPRNG*)&randPRNG, objIdx, recursive, bufSize,
+                       instBuf));
+#undef errRet
+}
+
+AER_EXPORT void AERRandFillUInt(size_t bufSize, uint64_t* uintBuf) {
+#define errRet
+    EnsureArgBuf(uintBuf, bufSize);
+
+    FillUInt((FoxPRNG*)&randPRNG, bufSize, uintBuf);
+
+    Ok();
+#undef errRet
+}
+
+AER_EXPORT void AERRandFillFloat(size_t bufSize, float* floatBuf) {
+#define errRet
+    EnsureArgBuf(floatBuf, bufSize);
+
+    FillFloatRange((FoxPRNG*)&randPRNG, 0.0f, 1.0f, bufSize, floatBuf);
+
+    Ok();
+#undef errRet
+}
+
+AER_EXPORT void AERRandFillFloatRange(size_t bufSize,
+                                      float min,
+                                      float max,
+                                      float* floatBuf) {
+#define errRet
+    EnsureArgBuf(floatBuf, bufSize);
+    EnsureMaxExc(min, max);
+
+    FillFloatRange((FoxPRNG*)&randPRNG, min, max, bufSize, floatBuf);
+
+    Ok();
+#undef errRet
+}
+
+AER_EXPORT void AERRandFillDouble(size_t bufSize, double* doubleBuf) {
+#define errRet
+    EnsureArgBuf(doubleBuf, bufSize);
+
+    FillDouble((FoxPRNG*)&randPRNG, bufSize, doubleBuf);
+
+    Ok();
+#undef errRet
+}
+
+AER_EXPORT double AERRandNormal(double mean, double stdDev) {
+#define errRet 0.0
+    EnsureMin(stdDev, 0.0);
+
+    Ok(mean + stdDev * SampleNormal((FoxPRNG*)&randPRNG));
+#undef errRet
+}
+
+AER_EXPORT double AERRandExponential(double rate) {
+#define errRet 0.0
+    EnsureMinExc(rate, 0.0);
+
+    Ok(SampleExponential((FoxPRNG*)&randPRNG) / rate);
+#undef errRet
+}
+
+AER_EXPORT void AERRandFillNormal(size_t bufSize,
+                                  double mean,
+                                  double stdDev,
+                                  double* doubleBuf) {
+#define errRet
+    EnsureArgBuf(doubleBuf, bufSize);
+    EnsureMin(stdDev, 0.0);
+
+    FillNormal((FoxPRNG*)&randPRNG, mean, stdDev, bufSize, doubleBuf);
+
+    Ok();
+#undef errRet
+}
+
+AER_EXPORT void AERRandFillExponential(size_t bufSize,
+                                       double rate,
+                                       double* doubleBuf) {
+#define errRet
+    EnsureArgBuf(doubleBuf, bufSize);
+    EnsureMinExc(rate, 0.0);
+
+    FillExponential((FoxPRNG*)&randPRNG, rate, bufSize, doubleBuf);
+
+    Ok();
+#undef errRet
+}
+
+AER_EXPORT AERRandAliasTable* AERRandAliasTableNew(size_t numWeights,
+                                                   const double* weights) {
+#define errRet NULL
+    EnsureArg(weights);
+    EnsureMinExc(numWeights, 0);
+
+    double totalWeight = 0.0;
+    for (size_t idx = 0; idx < numWeights; idx++) {
+        double weight = weights[idx];
+        Ensure(weight >= 0.0 && isfinite(weight), AER_BAD_VAL);
+        totalWeight += weight;
+    }
+    Ensure(totalWeight > 0.0 && isfinite(totalWeight), AER_BAD_VAL);
+
+    Ok(NewAliasTable(numWeights, weights, totalWeight));
+#undef errRet
+}
+
+AER_EXPORT void AERRandAliasTableFree(AERRandAliasTable* table) {
+#define errRet
+    EnsureArg(table);
+
+    free(table);
+
+    Ok();
+#undef errRet
+}
+
+AER_EXPORT size_t AERRandAlias(const AERRandAliasTable* table) {
+#define errRet 0
+    EnsureArg(table);
+
+    Ok(SampleAlias((FoxPRNG*)&randPRNG, table));
+#undef errRet
+}
+
+AER_EXPORT void AERRandFillAlias(const AERRandAliasTable* table,
+                                 size_t bufSize,
+                                 size_t* idxBuf) {
+#define errRet
+    EnsureArg(table);
+    EnsureArgBuf(idxBuf, bufSize);
+
+    FillAlias((FoxPRNG*)&randPRNG, table, bufSize, idxBuf);
+
+    Ok();
+#undef errRet
+}
+
 AER_EXPORT AERRandGen* AERRandGenNew(uint64_t seed) {
     Ok(FoxXoshiro256SSNew(seed));
 }
 
+AER_EXPORT AERRandGen* AERRandGenNewStream(uint64_t seed,
+                                           int32_t roomIdx,
+                                           int32_t instId) {
+    Ok(FoxXoshiro256SSNew(GetStreamSeed(seed, roomIdx, instId)));
+}
+
 AER_EXPORT void AERRandGenFree(AERRandGen* gen) {
 #define errRet
     EnsureArg(gen);
@@ -169,6 +985,48 @@ AER_EXPORT void AERRandGenSeed(AERRandGen* gen, uint64_t seed) {
 #undef errRet
 }
 
+AER_EXPORT void AERRandGenSeedStream(AERRandGen* gen,
+                                     uint64_t seed,
+                                     int32_t roomIdx,
+                                     int32_t instId) {
+#define errRet
+    EnsureArg(gen);
+
+    FoxXoshiro256SSSeed(gen, GetStreamSeed(seed, roomIdx, instId));
+
+    Ok();
+#undef errRet
+}
+
+AER_EXPORT void AERRandGenJump(AERRandGen* gen) {
+#define errRet
+    EnsureArg(gen);
+
+    Jump(gen);
+
+    Ok();
+#undef errRet
+}
+
+AER_EXPORT void AERRandGenSplit(AERRandGen* gen,
+                                size_t bufSize,
+                                AERRandGen** genBuf) {
+#define errRet
+    EnsureArg(gen);
+    EnsureArgBuf(genBuf, bufSize);
+
+    /* Each new generator owns the next 2^128 values of the original. */
+    for (size_t idx = 0; idx < bufSize; idx++) {
+        FoxXoshiro256SS* newGen = FoxXoshiro256SSNew(0);
+        memcpy(GetGenState(newGen), GetGenState(gen), 4 * sizeof(uint64_t));
+        Jump(gen);
+        genBuf[idx] = newGen;
+    }
+
+    Ok();
+#undef errRet
+}
+
 AER_EXPORT uint64_t AERRandGenUInt(AERRandGen* gen) {
 #define errRet 0
     EnsureArg(gen);
@@ -264,4 +1122,217 @@ AER_EXPORT void AERRandGenShuffle(AERRandGen* gen,
 
     Ok();
 #undef errRet
-}
\ No newline at end of file
+}
+
+AER_EXPORT void AERRandGenShuffle32(AERRandGen* gen,
+                                    size_t bufSize,
+                                    void* elemBuf) {
+#define errRet
+    EnsureArg(gen);
+    EnsureArgBuf(elemBuf, bufSize);
+
+    ShuffleFixed((FoxPRNG*)gen, UniformIdx, 4, bufSize, elemBuf);
+
+    Ok();
+#undef errRet
+}
+
+AER_EXPORT void AERRandGenShuffle64(AERRandGen* gen,
+                                    size_t bufSize,
+                                    void* elemBuf) {
+#define errRet
+    EnsureArg(gen);
+    EnsureArgBuf(elemBuf, bufSize);
+
+    ShuffleFixed((FoxPRNG*)gen, UniformIdx, 8, bufSize, elemBuf);
+
+    Ok();
+#undef errRet
+}
+
+AER_EXPORT void AERRandGenShuffle128(AERRandGen* gen,
+                                     size_t bufSize,
+                                     void* elemBuf) {
+#define errRet
+    EnsureArg(gen);
+    EnsureArgBuf(elemBuf, bufSize);
+
+    ShuffleFixed((FoxPRNG*)gen, UniformIdx, 16, bufSize, elemBuf);
+
+    Ok();
+#undef errRet
+}
+
+AER_EXPORT void AERRandGenShufflePtr(AERRandGen* gen,
+                                     size_t bufSize,
+                                     void** ptrBuf) {
+#define errRet
+    EnsureArg(gen);
+    EnsureArgBuf(ptrBuf, bufSize);
+
+    ShuffleFixed((FoxPRNG*)gen, UniformIdx, sizeof(void*), bufSize, ptrBuf);
+
+    Ok();
+#undef errRet
+}
+
+AER_EXPORT void AERRandGenSample(AERRandGen* gen,
+                                 size_t bufSize,
+                                 size_t popSize,
+                                 size_t* idxBuf) {
+#define errRet
+    EnsureArg(gen);
+    EnsureArgBuf(idxBuf, bufSize);
+    EnsureMax(bufSize, popSize);
+
+    Sample((FoxPRNG*)gen, bufSize, popSize, idxBuf);
+
+    Ok();
+#undef errRet
+}
+
+AER_EXPORT size_t AERRandGenSampleInstances(AERRandGen* gen,
+                                            int32_t objIdx,
+                                            bool recursive,
+                                            size_t bufSize,
+                                            AERInstance** instBuf) {
+#define errRet 0
+    EnsureStage(STAGE_ACTION);
+    EnsureArg(gen);
+    EnsureArgBuf(instBuf, bufSize);
+    EnsureLookup(HLDObjectLookup(objIdx));
+
+    Ok(SampleInstances((FoxPRNG*)gen, objIdx, recursive, bufSize, instBuf));
+#undef errRet
+}
+
+AER_EXPORT void AERRandGenFillUInt(AERRandGen* gen,
+                                   size_t bufSize,
+                                   uint64_t* uintBuf) {
+#define errRet
+    EnsureArg(gen);
+    EnsureArgBuf(uintBuf, bufSize);
+
+    FillUInt((FoxPRNG*)gen, bufSize, uintBuf);
+
+    Ok();
+#undef errRet
+}
+
+AER_EXPORT void AERRandGenFillFloat(AERRandGen* gen,
+                                    size_t bufSize,
+                                    float* floatBuf) {
+#define errRet
+    EnsureArg(gen);
+    EnsureArgBuf(floatBuf, bufSize);
+
+    FillFloatRange((FoxPRNG*)gen, 0.0f, 1.0f, bufSize, floatBuf);
+
+    Ok();
+#undef errRet
+}
+
+AER_EXPORT void AERRandGenFillFloatRange(AERRandGen* gen,
+                                         size_t bufSize,
+                                         float min,
+                                         float max,
+                                         float* floatBuf) {
+#define errRet
+    EnsureArg(gen);
+    EnsureArgBuf(floatBuf, bufSize);
+    EnsureMaxExc(min, max);
+
+    FillFloatRange((FoxPRNG*)gen, min, max, bufSize, floatBuf);
+
+    Ok();
+#undef errRet
+}
+
+AER_EXPORT void AERRandGenFillDouble(AERRandGen* gen,
+                                     size_t bufSize,
+                                     double* doubleBuf) {
+#define errRet
+    EnsureArg(gen);
+    EnsureArgBuf(doubleBuf, bufSize);
+
+    FillDouble((FoxPRNG*)gen, bufSize, doubleBuf);
+
+    Ok();
+#undef errRet
+}
+
+AER_EXPORT double AERRandGenNormal(AERRandGen* gen,
+                                   double mean,
+                                   double stdDev) {
+#define errRet 0.0
+    EnsureArg(gen);
+    EnsureMin(stdDev, 0.0);
+
+    Ok(mean + stdDev * SampleNormal((FoxPRNG*)gen));
+#undef errRet
+}
+
+AER_EXPORT double AERRandGenExponential(AERRandGen* gen, double rate) {
+#define errRet 0.0
+    EnsureArg(gen);
+    EnsureMinExc(rate, 0.0);
+
+    Ok(SampleExponential((FoxPRNG*)gen) / rate);
+#undef errRet
+}
+
+AER_EXPORT void AERRandGenFillNormal(AERRandGen* gen,
+                                     size_t bufSize,
+                                     double mean,
+                                     double stdDev,
+                                     double* doubleBuf) {
+#define errRet
+    EnsureArg(gen);
+    EnsureArgBuf(doubleBuf, bufSize);
+    EnsureMin(stdDev, 0.0);
+
+    FillNormal((FoxPRNG*)gen, mean, stdDev, bufSize, doubleBuf);
+
+    Ok();
+#undef errRet
+}
+
+AER_EXPORT void AERRandGenFillExponential(AERRandGen* gen,
+                                          size_t bufSize,
+                                          double rate,
+                                          double* doubleBuf) {
+#define errRet
+    EnsureArg(gen);
+    EnsureArgBuf(doubleBuf, bufSize);
+    EnsureMinExc(rate, 0.0);
+
+    FillExponential((FoxPRNG*)gen, rate, bufSize, doubleBuf);
+
+    Ok();
+#undef errRet
+}
+
+AER_EXPORT size_t AERRandGenAlias(AERRandGen* gen,
+                                  const AERRandAliasTable* table) {
+#define errRet 0
+    EnsureArg(gen);
+    EnsureArg(table);
+
+    Ok(SampleAlias((FoxPRNG*)gen, table));
+#undef errRet
+}
+
+AER_EXPORT void AERRandGenFillAlias(AERRandGen* gen,
+                                    const AERRandAliasTable* table,
+                                    size_t bufSize,
+                                    size_t* idxBuf) {
+#define errRet
+    EnsureArg(gen);
+    EnsureArg(table);
+    EnsureArgBuf(idxBuf, bufSize);
+
+    FillAlias((FoxPRNG*)gen, table, bufSize, idxBuf);
+
+    Ok();
+#undef errRet
+}
@@ -77,7 +77,7 @@ AER_EXPORT int32_t AERRoomGetCurrent(void) {
 
 AER_EXPORT void AERRoomGoto(int32_t roomIdx) {
 #define errRet
-    EnsureStage(STAGE_ACTION);
+    EnsureStageMut(STAGE_ACTION);
     Ensure(roomIndexAux == AER_ROOM_NULL, AER_SEQ_BREAK);
     EnsureLookup(HLDRoomLookup(roomIdx));
 
@@ -89,7 +89,7 @@ AER_EXPORT void AERRoomGoto(int32_t roomIdx) {
 
 AER_EXPORT void AERRoomEnter(int32_t roomIdx, bool fade) {
 #define errRet
-    EnsureStage(STAGE_ACTION);
+    EnsureStageMut(STAGE_ACTION);
     Ensure(roomIndexAux == AER_ROOM_NULL, AER_SEQ_BREAK);
     EnsureLookup(HLDRoomLookup(roomIdx));
 
@@ -109,7 +109,7 @@ AER_EXPORT void AERRoomEnterWithPosition(int32_t roomIdx,
                                          float x,
                                          float y) {
 #define errRet
-    EnsureStage(STAGE_ACTION);
+    EnsureStageMut(STAGE_ACTION);
     Ensure(roomIndexAux == AER_ROOM_NULL, AER_SEQ_BREAK);
     EnsureLookup(HLDRoomLookup(roomIdx));
 
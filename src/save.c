@@ -364,7 +364,7 @@ AER_EXPORT size_t AERSaveGetKeys(size_t bufSize, const char** keyBuf) {
 
 AER_EXPORT void AERSaveDestroy(const char* key) {
 #define errRet
-    EnsureStage(STAGE_ACTION);
+    EnsureStageMut(STAGE_ACTION);
     EnsureArg(key);
 
     /* Get entry. */
@@ -402,7 +402,7 @@ AER_EXPORT double AERSaveGetDouble(const char* key) {
 
 AER_EXPORT void AERSaveSetDouble(const char* key, double value) {
 #define errRet
-    EnsureStage(STAGE_ACTION);
+    EnsureStageMut(STAGE_ACTION);
     EnsureArg(key);
     Ensure(isfinite(value), AER_BAD_VAL);
 
@@ -446,7 +446,7 @@ AER_EXPORT const char* AERSaveGetString(const char* key) {
 
 AER_EXPORT void AERSaveSetString(const char* key, const char* value) {
 #define errRet
-    EnsureStage(STAGE_ACTION);
+    EnsureStageMut(STAGE_ACTION);
     EnsureArg(key);
     EnsureArg(value);
 
@@ -14,25 +14,717 @@
  * limitations under the License.
  */
 #include <assert.h>
+#include <emmintrin.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
 #include "foxutils/stringmapmacs.h"
 
 #include "aer/sprite.h"
+#include "internal/asset.h"
+#include "internal/atlas.h"
 #include "internal/core.h"
 #include "internal/err.h"
 #include "internal/export.h"
 #include "internal/hld.h"
+#include "internal/job.h"
 #include "internal/log.h"
 #include "internal/mod.h"
+#include "internal/option.h"
+#include "internal/png.h"
+#include "internal/sprite.h"
+
+/* ----- PRIVATE TYPES ----- */
+
+/* Frames refer to pages by their position in the manifest until loaded. */
+typedef struct AtlasManifest {
+    char** pages;
+    size_t numPages;
+    PackedSprite* sprites;
+    size_t numSprites;
+    size_t numFrames;
+} AtlasManifest;
+
+/*
+ * A sprite replacement which is deferred until the sprite is needed. Until
+ * then, queries report the metadata the sprite will have once replaced.
+ */
+typedef struct LazyReplace {
+    char* path;
+    size_t numFrames;
+    HLDVecIntegral size;
+    HLDVecIntegral origin;
+} LazyReplace;
+
+/*
+ * One bit per pixel of an image that sprites are loaded from, set where the
+ * pixel is not fully transparent. Only enabled masks are built, on the main
+ * thread and never while read-only listeners run, so any thread may read them.
+ */
+typedef struct SpriteMask {
+    char* path;
+    bool enabled;
+    uint32_t width;
+    uint32_t height;
+    /* Each row is padded, so that any 128 of its bits can be loaded. */
+    size_t rowWords;
+    uint64_t* bits;
+} SpriteMask;
+
+/* A sprite frame placed in the room, with `mask` `NULL` if it is solid. */
+typedef struct FrameMask {
+    const SpriteMask* mask;
+    int32_t maskLeft;
+    int32_t maskTop;
+    int32_t left;
+    int32_t top;
+    int32_t right;
+    int32_t bottom;
+} FrameMask;
 
 /* ----- PRIVATE GLOBALS ----- */
 
 static FoxMap spriteNames = {0};
 
+static PackedSprite* packedSprites = NULL;
+
+static size_t numPackedSprites = 0;
+
+/* Indexed by sprite, with `path` set only while the replacement is pending. */
+static LazyReplace* lazyReplaces = NULL;
+
+static size_t numLazyReplaces = 0;
+
+static size_t numPendingReplaces = 0;
+
+/* Where prefetching continues from at the next room change. */
+static int32_t prefetchIdx = 0;
+
+/* Indexed by the sprite whose image the mask is built from. */
+static SpriteMask* spriteMasks = NULL;
+
+static size_t numSpriteMasks = 0;
+
+/* ----- PRIVATE FUNCTIONS ----- */
+
+static char* CopyString(const char* str) {
+    size_t size = strlen(str) + 1;
+    char* copy = malloc(size);
+    assert(copy);
+
+    return memcpy(copy, str, size);
+}
+
+static SpriteMask* AddSpriteMask(int32_t spriteIdx) {
+    if ((size_t)spriteIdx >= numSpriteMasks) {
+        size_t numMasks = (size_t)spriteIdx + 1;
+        spriteMasks = realloc(spriteMasks, numMasks * sizeof(SpriteMask));
+        assert(spriteMasks);
+        memset(spriteMasks + numSpriteMasks, 0,
+               (numMasks - numSpriteMasks) * sizeof(SpriteMask));
+        numSpriteMasks = numMasks;
+    }
+
+    return spriteMasks + spriteIdx;
+}
+
+static void SetMaskSource(int32_t spriteIdx, const char* path) {
+    SpriteMask* mask = AddSpriteMask(spriteIdx);
+    bool enabled = mask->enabled;
+    free(mask->path);
+    free(mask->bits);
+    *mask = (SpriteMask){.path = CopyString(path), .enabled = enabled};
+
+    return;
+}
+
+static void FreeAtlasManifest(AtlasManifest* manifest) {
+    for (size_t idx = 0; idx < manifest->numPages; idx++)
+        free(manifest->pages[idx]);
+    free(manifest->pages);
+
+    for (size_t idx = 0; idx < manifest->numSprites; idx++) {
+        free(manifest->sprites[idx].name);
+        free(manifest->sprites[idx].frames);
+    }
+    free(manifest->sprites);
+
+    *manifest = (AtlasManifest){0};
+    return;
+}
+
+/* Reads a line without its line break, failing if it is too long. */
+static bool ReadAtlasLine(FILE* file, char* line, bool* eof) {
+    *eof = !fgets(line, ATLAS_MAX_LINE_SIZE, file);
+    if (*eof)
+        return !ferror(file);
+
+    size_t len = strcspn(line, "\r\n");
+    if (line[len] == '\0' && !feof(file))
+        return false;
+    line[len] = '\0';
+
+    return true;
+}
+
+static bool ParseAtlasManifest(FILE* file, AtlasManifest* manifest) {
+    char line[ATLAS_MAX_LINE_SIZE];
+    char token[ATLAS_MAX_LINE_SIZE];
+    bool eof;
+    int len;
+
+    *manifest = (AtlasManifest){0};
+
+    /* Check header. */
+    uint32_t version;
+    if (!(ReadAtlasLine(file, line, &eof) && !eof &&
+          sscanf(line, "%s %u%n", token, &version, &len) == 2 &&
+          line[len] == '\0' && strcmp(token, ATLAS_MAGIC) == 0 &&
+          version == ATLAS_VERSION))
+        return false;
+
+    PackedSprite* sprite = NULL;
+    uint32_t numFramesLeft = 0;
+    while (ReadAtlasLine(file, line, &eof)) {
+        if (eof)
+            return manifest->numSprites > 0 && numFramesLeft == 0;
+
+        if (sscanf(line, "page %s%n", token, &len) == 1 && line[len] == '\0' &&
+            !sprite) {
+            manifest->pages =
+                realloc(manifest->pages,
+                        (manifest->numPages + 1) * sizeof(char*));
+            assert(manifest->pages);
+            manifest->pages[manifest->numPages++] = CopyString(token);
+            continue;
+        }
+
+        PackedSprite next = {0};
+        if (sscanf(line, "sprite %s %u %d %d %d %d%n", token, &next.numFrames,
+                   &next.size.x, &next.size.y, &next.origin.x, &next.origin.y,
+                   &len) == 6 &&
+            line[len] == '\0' && numFramesLeft == 0 && next.numFrames > 0 &&
+            next.numFrames <= ATLAS_MAX_FRAMES && next.size.x > 0 &&
+            next.size.x <= ATLAS_MAX_PAGE_SIZE && next.size.y > 0 &&
+            next.size.y <= ATLAS_MAX_PAGE_SIZE &&
+            next.origin.x >= -ATLAS_MAX_PAGE_SIZE &&
+            next.origin.x <= ATLAS_MAX_PAGE_SIZE &&
+            next.origin.y >= -ATLAS_MAX_PAGE_SIZE &&
+            next.origin.y <= ATLAS_MAX_PAGE_SIZE) {
+            manifest->sprites =
+                realloc(manifest->sprites,
+                        (manifest->numSprites + 1) * sizeof(PackedSprite));
+            assert(manifest->sprites);
+            sprite = manifest->sprites + manifest->numSprites++;
+            next.name = CopyString(token);
+            next.frames = malloc(next.numFrames * sizeof(PackedFrame));
+            assert(next.frames);
+            *sprite = next;
+            numFramesLeft = next.numFrames;
+            manifest->numFrames += next.numFrames;
+            continue;
+        }
+
+        PackedFrame frame = {0};
+        if (sscanf(line, "frame %d %d %d%n", &frame.pageIdx, &frame.left,
+                   &frame.top, &len) == 3 &&
+            line[len] == '\0' && numFramesLeft > 0 && frame.pageIdx >= 0 &&
+            (size_t)frame.pageIdx < manifest->numPages && frame.left >= 0 &&
+            frame.left <= ATLAS_MAX_PAGE_SIZE - sprite->size.x &&
+            frame.top >= 0 &&
+            frame.top <= ATLAS_MAX_PAGE_SIZE - sprite->size.y) {
+            sprite->frames[sprite->numFrames - numFramesLeft--] = frame;
+            continue;
+        }
+
+        break;
+    }
+
+    FreeAtlasManifest(manifest);
+    return false;
+}
+
+static bool AtlasNamesAreFree(const AtlasManifest* manifest) {
+    for (size_t idx = 0; idx < manifest->numSprites; idx++) {
+        const char* name = manifest->sprites[idx].name;
+        if (FoxMapMIndex(const char*, int32_t, &spriteNames, name))
+            return false;
+        for (size_t prevIdx = 0; prevIdx < idx; prevIdx++) {
+            if (strcmp(manifest->sprites[prevIdx].name, name) == 0)
+                return false;
+        }
+    }
+
+    return true;
+}
+
+/*
+ * Registers the pages as plain sprites, which the packed sprites' frames then
+ * point into. Pages which did load stay registered even if others do not.
+ */
+static bool LoadAtlasPages(const char* modName,
+                           const char* filename,
+                           AtlasManifest* manifest) {
+    /* Pages are relative to the directory of the manifest. */
+    const char* dirEnd = strrchr(filename, '/');
+    size_t dirLen = dirEnd ? (size_t)(dirEnd - filename) + 1 : 0;
+
+    HLDSprite** pages = malloc(manifest->numPages * sizeof(HLDSprite*));
+    int32_t* pageIdxs = malloc(manifest->numPages * sizeof(int32_t));
+    assert(pages && pageIdxs);
+    bool loaded = true;
+    for (size_t idx = 0; idx < manifest->numPages && loaded; idx++) {
+        size_t pageLen = strlen(manifest->pages[idx]);
+        char* relPath = malloc(dirLen + pageLen + 1);
+        assert(relPath);
+        memcpy(relPath, filename, dirLen);
+        memcpy(relPath + dirLen, manifest->pages[idx], pageLen + 1);
+
+        const char* path = CoreGetAbsAssetPath(modName, relPath);
+        pageIdxs[idx] = hldfuncs.actionSpriteAdd(path, 1, 0, 0, 0, 0, 0, 0);
+        pages[idx] = HLDSpriteLookup(pageIdxs[idx]);
+        loaded = (pages[idx] != NULL);
+        if (loaded) {
+            pages[idx]->name = CopyString(manifest->pages[idx]);
+            SetMaskSource(pageIdxs[idx], path);
+        }
+        free(relPath);
+    }
+
+    /* Resolve frames, which must lie within their page. */
+    for (size_t idx = 0; idx < manifest->numSprites && loaded; idx++) {
+        PackedSprite* sprite = manifest->sprites + idx;
+        for (uint32_t frameIdx = 0; frameIdx < sprite->numFrames; frameIdx++) {
+            PackedFrame* frame = sprite->frames + frameIdx;
+            HLDSprite* page = pages[frame->pageIdx];
+            loaded &= frame->left + sprite->size.x <= page->size.x &&
+                      frame->top + sprite->size.y <= page->size.y;
+            frame->page = page;
+            frame->pageIdx = pageIdxs[frame->pageIdx];
+        }
+    }
+    free(pages);
+    free(pageIdxs);
+
+    return loaded;
+}
+
+static void DeferReplace(int32_t spriteIdx,
+                         const char* path,
+                         size_t numFrames,
+                         uint32_t width,
+                         uint32_t height,
+                         uint32_t origX,
+                         uint32_t origY) {
+    if ((size_t)spriteIdx >= numLazyReplaces) {
+        size_t numReplaces = (size_t)spriteIdx + 1;
+        lazyReplaces =
+            realloc(lazyReplaces, numReplaces * sizeof(LazyReplace));
+        assert(lazyReplaces);
+        memset(lazyReplaces + numLazyReplaces, 0,
+               (numReplaces - numLazyReplaces) * sizeof(LazyReplace));
+        numLazyReplaces = numReplaces;
+    }
+
+    /* A later replacement of the same sprite takes precedence. */
+    LazyReplace* replace = lazyReplaces + spriteIdx;
+    if (replace->path)
+        free(replace->path);
+    else
+        numPendingReplaces++;
+    /* The engine splits the image into frames of equal width. */
+    *replace = (LazyReplace){
+        .path = CopyString(path),
+        .numFrames = numFrames,
+        .size = {.x = (int32_t)(width / numFrames), .y = (int32_t)height},
+        .origin = {.x = (int32_t)origX, .y = (int32_t)origY}};
+
+    return;
+}
+
+static inline bool IsReplacePending(int32_t spriteIdx) {
+    return spriteIdx >= 0 && (size_t)spriteIdx < numLazyReplaces &&
+           lazyReplaces[spriteIdx].path;
+}
+
+static inline LazyReplace* GetPendingReplace(int32_t spriteIdx) {
+    return (numPendingReplaces > 0 && IsReplacePending(spriteIdx))
+               ? lazyReplaces + spriteIdx
+               : NULL;
+}
+
+static bool AddMaskRow(void* ctx,
+                       uint32_t width,
+                       uint32_t height,
+                       uint32_t y,
+                       const uint8_t* pixels) {
+    SpriteMask* mask = ctx;
+    if (y == 0) {
+        mask->width = width;
+        mask->height = height;
+        mask->rowWords = (width + 63) / 64 + 2;
+        mask->bits = calloc(mask->rowWords * height, sizeof(uint64_t));
+    }
+    if (!mask->bits)
+        return false;
+
+    uint64_t* row = mask->bits + y * mask->rowWords;
+    const uint8_t* alpha = pixels + 3;
+    for (uint32_t x = 0; x < width; x++, alpha += 4)
+        row[x / 64] |= (uint64_t)(*alpha != 0) << (x % 64);
+
+    return true;
+}
+
+/* Decodes one row at a time, so only the bits are kept for the whole image. */
+static bool DecodeMask(SpriteMask* mask) {
+    FILE* file = fopen(mask->path, "rb");
+    if (!file)
+        return false;
+    uint8_t* data = NULL;
+    long size = -1;
+    if (fseek(file, 0, SEEK_END) == 0 && (size = ftell(file)) >= 0 &&
+        fseek(file, 0, SEEK_SET) == 0) {
+        data = malloc(size ? (size_t)size : 1);
+        if (!data || fread(data, 1, (size_t)size, file) != (size_t)size)
+            size = -1;
+    }
+    fclose(file);
+
+    bool decoded =
+        (size >= 0 && PNGDecodeRows(data, (size_t)size, AddMaskRow, mask));
+    free(data);
+    if (!decoded) {
+        free(mask->bits);
+        mask->bits = NULL;
+    }
+
+    return decoded;
+}
+
+static void BuildMask(void* arg) {
+    SpriteMask* mask = arg;
+    if (!DecodeMask(mask)) {
+        LogWarn("Could not build collision mask from \"%s\", so it is "
+                "treated as solid.",
+                mask->path);
+    }
+
+    return;
+}
+
+/* Pending sprites have no mask yet, so it is built along with the sprite. */
+static void ApplyReplace(int32_t spriteIdx) {
+    LazyReplace* replace = lazyReplaces + spriteIdx;
+    hldfuncs.actionSpriteReplace(spriteIdx, replace->path, replace->numFrames,
+                                 0, 0, 0, 0, (uint32_t)replace->origin.x,
+                                 (uint32_t)replace->origin.y);
+    free(replace->path);
+    replace->path = NULL;
+    numPendingReplaces--;
+
+    if ((size_t)spriteIdx < numSpriteMasks && spriteMasks[spriteIdx].enabled)
+        BuildMask(spriteMasks + spriteIdx);
+
+    return;
+}
+
+/* Falls back to treating the sprite as solid if it has no usable image. */
+static const SpriteMask* GetMask(int32_t spriteIdx,
+                                 int32_t left,
+                                 int32_t top,
+                                 int32_t width,
+                                 int32_t height) {
+    if (spriteIdx < 0 || (size_t)spriteIdx >= numSpriteMasks)
+        return NULL;
+
+    const SpriteMask* mask = spriteMasks + spriteIdx;
+    if (!mask->bits || left < 0 || top < 0 ||
+        (uint32_t)(left + width) > mask->width ||
+        (uint32_t)(top + height) > mask->height)
+        return NULL;
+
+    return mask;
+}
+
+/* Returns the number of frames of the sprite, or `0` if it is invalid. */
+static uint32_t GetFrameMask(int32_t spriteIdx,
+                             uint32_t frame,
+                             float x,
+                             float y,
+                             FrameMask* frameMask) {
+    HLDVecIntegral size;
+    HLDVecIntegral origin;
+    uint32_t numFrames;
+    int32_t imageIdx;
+    int32_t maskLeft;
+    int32_t maskTop;
+
+    PackedSprite* packed = SpriteManLookupPacked(spriteIdx);
+    if (packed) {
+        numFrames = packed->numFrames;
+        if (frame >= numFrames)
+            return numFrames;
+        size = packed->size;
+        origin = packed->origin;
+        imageIdx = packed->frames[frame].pageIdx;
+        maskLeft = packed->frames[frame].left;
+        maskTop = packed->frames[frame].top;
+    } else {
+        HLDSprite* sprite = HLDSpriteLookup(spriteIdx);
+        if (!sprite)
+            return 0;
+        /* Pending replacements count as solid until they are applied. */
+        LazyReplace* pending = GetPendingReplace(spriteIdx);
+        numFrames = pending ? pending->numFrames : sprite->numImages;
+        if (frame >= numFrames)
+            return numFrames;
+        size = pending ? pending->size : sprite->size;
+        origin = pending ? pending->origin : sprite->origin;
+        imageIdx = spriteIdx;
+        /* Frames are laid out left to right, like in the file. */
+        maskLeft = (int32_t)frame * size.x;
+        maskTop = 0;
+    }
+
+    int32_t left = (int32_t)floorf(x) - origin.x;
+    int32_t top = (int32_t)floorf(y) - origin.y;
+    *frameMask = (FrameMask){
+        .mask = GetMask(imageIdx, maskLeft, maskTop, size.x, size.y),
+        .maskLeft = maskLeft,
+        .maskTop = maskTop,
+        .left = left,
+        .top = top,
+        .right = left + size.x,
+        .bottom = top + size.y};
+
+    return numFrames;
+}
+
+static inline uint32_t WrapFrame(float frame, uint32_t numFrames) {
+    float wrapped = fmodf(floorf(frame), (float)numFrames);
+
+    return (uint32_t)((wrapped < 0.0f) ? wrapped + numFrames : wrapped);
+}
+
+/* Loads the 128 bits of a mask row starting at any bit. */
+static inline __m128i LoadMaskBits(const uint64_t* row, uint32_t bitIdx) {
+    const uint64_t* words = row + bitIdx / 64;
+    __m128i low = _mm_loadu_si128((const __m128i*)words);
+    __m128i high = _mm_loadu_si128((const __m128i*)(words + 1));
+    __m128i shift = _mm_cvtsi32_si128(bitIdx % 64);
+    __m128i carryShift = _mm_cvtsi32_si128(64 - bitIdx % 64);
+
+    return _mm_or_si128(_mm_srl_epi64(low, shift),
+                        _mm_sll_epi64(high, carryShift));
+}
+
+static bool FrameMasksOverlap(const FrameMask* a, const FrameMask* b) {
+    int32_t left = (a->left > b->left) ? a->left : b->left;
+    int32_t top = (a->top > b->top) ? a->top : b->top;
+    int32_t right = (a->right < b->right) ? a->right : b->right;
+    int32_t bottom = (a->bottom < b->bottom) ? a->bottom : b->bottom;
+    if (left >= right || top >= bottom)
+        return false;
+    if (!a->mask && !b->mask)
+        return true;
+
+    /* Only the bits of the last chunk within the overlap count. */
+    uint32_t width = (uint32_t)(right - left);
+    uint32_t numChunks = (width + 127) / 128;
+    uint32_t tailBits = width - (numChunks - 1) * 128;
+    uint64_t tail[2] = {
+        (tailBits >= 64) ? ~0ull : (1ull << tailBits) - 1,
+        (tailBits >= 128) ? ~0ull
+        : (tailBits > 64) ? (1ull << (tailBits - 64)) - 1
+                          : 0};
+    __m128i tailMask = _mm_loadu_si128((const __m128i*)tail);
+    __m128i solid = _mm_set1_epi32(-1);
+    __m128i none = _mm_setzero_si128();
+
+    uint32_t colA = (uint32_t)(a->maskLeft + left - a->left);
+    uint32_t colB = (uint32_t)(b->maskLeft + left - b->left);
+    for (int32_t y = top; y < bottom; y++) {
+        const uint64_t* rowA =
+            a->mask ? a->mask->bits + (size_t)(a->maskTop + y - a->top) *
+                                          a->mask->rowWords
+                    : NULL;
+        const uint64_t* rowB =
+            b->mask ? b->mask->bits + (size_t)(b->maskTop + y - b->top) *
+                                          b->mask->rowWords
+                    : NULL;
+
+        __m128i hits = none;
+        for (uint32_t chunk = 0; chunk < numChunks; chunk++) {
+            __m128i bitsA = rowA ? LoadMaskBits(rowA, colA + chunk * 128)
+                                 : solid;
+            __m128i bitsB = rowB ? LoadMaskBits(rowB, colB + chunk * 128)
+                                 : solid;
+            __m128i both = _mm_and_si128(bitsA, bitsB);
+            if (chunk == numChunks - 1)
+                both = _mm_and_si128(both, tailMask);
+            hits = _mm_or_si128(hits, both);
+        }
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(hits, none)) != 0xffff)
+            return true;
+    }
+
+    return false;
+}
+
+static inline double ElapsedMs(const struct timespec* start) {
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    return (end.tv_sec - start->tv_sec) * 1000.0 +
+           (end.tv_nsec - start->tv_nsec) / 1000000.0;
+}
+
 /* ----- INTERNAL FUNCTIONS ----- */
 
+PackedSprite* SpriteManLookupPacked(int32_t spriteIdx) {
+    PackedSprite* result = NULL;
+
+    if (spriteIdx >= SPRITE_PACKED_BASE &&
+        (size_t)(spriteIdx - SPRITE_PACKED_BASE) < numPackedSprites)
+        result = packedSprites + (spriteIdx - SPRITE_PACKED_BASE);
+
+    return result;
+}
+
+/*
+ * Cheap enough to call before every use of a sprite. Replacing calls into the
+ * engine, so a pending sprite is left alone (returning false) on parallel
+ * listener threads.
+ */
+bool SpriteManLoadPending(int32_t spriteIdx) {
+    if (numPendingReplaces == 0 || !IsReplacePending(spriteIdx))
+        return true;
+    if (stage == STAGE_READ_ONLY)
+        return false;
+
+    ApplyReplace(spriteIdx);
+
+    return true;
+}
+
+/*
+ * Instances may be created or change sprites at any time, so this catches
+ * pending sprites of the current room at the latest one step after their
+ * first use.
+ */
+void SpriteManLoadRoomPending(void) {
+    if (numPendingReplaces == 0)
+        return;
+
+    HLDRoom* room = *hldvars.roomCurrent;
+    HLDInstance* inst = room->instanceFirst;
+    for (int32_t idx = 0; idx < room->numInstances && inst; idx++) {
+        SpriteManLoadPending(inst->spriteIndex);
+        SpriteManLoadPending(inst->maskIndex);
+        inst = inst->instanceNext;
+    }
+
+    return;
+}
+
+void SpriteManPrefetchPending(void) {
+    if (numPendingReplaces == 0)
+        return;
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    size_t numPrevPending = numPendingReplaces;
+
+    if (opts.prefetchRoomSprites)
+        SpriteManLoadRoomPending();
+
+    /*
+     * Spread the remaining replacements over the following room changes. The
+     * game also draws sprites other than through instances, which nothing
+     * else catches, so without a budget all of them are applied right away.
+     */
+    uint32_t maxLoaded = opts.prefetchSpritesPerRoom;
+    if (maxLoaded == 0)
+        maxLoaded = UINT32_MAX;
+    for (uint32_t numLoaded = 0;
+         numLoaded < maxLoaded && numPendingReplaces > 0;
+         prefetchIdx = (prefetchIdx + 1) % (int32_t)numLazyReplaces) {
+        if (IsReplacePending(prefetchIdx)) {
+            ApplyReplace(prefetchIdx);
+            numLoaded++;
+        }
+    }
+
+    if (numPendingReplaces != numPrevPending) {
+        LogInfo(
+            "Applied %zu deferred sprite replacement(s) in %.1f ms, %zu "
+            "remain pending.",
+            numPrevPending - numPendingReplaces, ElapsedMs(&start),
+            numPendingReplaces);
+    }
+
+    return;
+}
+
+/*
+ * Masks are built up front rather than on first use so that queries, which
+ * read-only game step listeners may make, never write to them. Pending
+ * replacements are skipped, so that deferring them still saves decoding.
+ */
+void SpriteManBuildMasks(void) {
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    /* The array no longer moves, so jobs can write to their mask. */
+    uint64_t* jobs = malloc(numSpriteMasks * sizeof(uint64_t));
+    assert(jobs || numSpriteMasks == 0);
+    size_t numJobs = 0;
+    for (size_t idx = 0; idx < numSpriteMasks; idx++) {
+        if (spriteMasks[idx].enabled && spriteMasks[idx].path &&
+            !IsReplacePending((int32_t)idx)) {
+            jobs[numJobs++] =
+                JobManSubmit(BuildMask, spriteMasks + idx, MOD_NULL);
+        }
+    }
+    for (size_t idx = 0; idx < numJobs; idx++)
+        JobManWait(jobs[idx]);
+    free(jobs);
+
+    if (numJobs > 0) {
+        LogInfo("Built %zu sprite collision mask(s) in %.1f ms.", numJobs,
+                ElapsedMs(&start));
+    }
+
+    return;
+}
+
+/* Frames wrap around like the engine's image index, and no sprite is empty. */
+bool SpriteManMasksOverlap(int32_t spriteIdxA,
+                           float frameA,
+                           float xA,
+                           float yA,
+                           int32_t spriteIdxB,
+                           float frameB,
+                           float xB,
+                           float yB) {
+    FrameMask maskA;
+    FrameMask maskB;
+    uint32_t numFramesA = GetFrameMask(spriteIdxA, UINT32_MAX, xA, yA, &maskA);
+    uint32_t numFramesB = GetFrameMask(spriteIdxB, UINT32_MAX, xB, yB, &maskB);
+    if (numFramesA == 0 || numFramesB == 0)
+        return false;
+
+    GetFrameMask(spriteIdxA, WrapFrame(frameA, numFramesA), xA, yA, &maskA);
+    GetFrameMask(spriteIdxB, WrapFrame(frameB, numFramesB), xB, yB, &maskB);
+
+    return FrameMasksOverlap(&maskA, &maskB);
+}
+
 void SpriteManBuildNameTable(void) {
     size_t numSprites = hldvars.spriteTable->size;
     for (uint32_t spriteIdx = 0; spriteIdx < numSprites; spriteIdx++) {
@@ -61,6 +753,33 @@ void SpriteManDestructor(void) {
     FoxMapMDeinit(const char*, int32_t, &spriteNames);
     spriteNames = (FoxMap){0};
 
+    /* Deinitialize packed sprites. */
+    for (size_t idx = 0; idx < numPackedSprites; idx++) {
+        free(packedSprites[idx].name);
+        free(packedSprites[idx].frames);
+    }
+    free(packedSprites);
+    packedSprites = NULL;
+    numPackedSprites = 0;
+
+    /* Deinitialize deferred replacements. */
+    for (size_t idx = 0; idx < numLazyReplaces; idx++)
+        free(lazyReplaces[idx].path);
+    free(lazyReplaces);
+    lazyReplaces = NULL;
+    numLazyReplaces = 0;
+    numPendingReplaces = 0;
+    prefetchIdx = 0;
+
+    /* Deinitialize collision masks. */
+    for (size_t idx = 0; idx < numSpriteMasks; idx++) {
+        free(spriteMasks[idx].path);
+        free(spriteMasks[idx].bits);
+    }
+    free(spriteMasks);
+    spriteMasks = NULL;
+    numSpriteMasks = 0;
+
     LogInfo("Done deinitializing sprite module.");
     return;
 }
@@ -82,9 +801,10 @@ AER_EXPORT int32_t AERSpriteRegister(const char* name,
     Ensure(!FoxMapMIndex(const char*, int32_t, &spriteNames, name),
            AER_BAD_VAL);
 
-    int32_t spriteIdx =
-        hldfuncs.actionSpriteAdd(CoreGetAbsAssetPath(modName, filename),
-                                 numFrames, 0, 0, 0, 0, origX, origY);
+    const char* path = CoreGetAbsAssetPath(modName, filename);
+    Ensure(AssetManValidate(path, NULL, NULL), AER_BAD_FILE);
+    int32_t spriteIdx = hldfuncs.actionSpriteAdd(path, numFrames, 0, 0, 0, 0,
+                                                 origX, origY);
     HLDSprite* sprite = HLDSpriteLookup(spriteIdx);
     Ensure(sprite, AER_BAD_FILE);
     *FoxMapMInsert(const char*, int32_t, &spriteNames, name) = spriteIdx;
@@ -93,6 +813,7 @@ AER_EXPORT int32_t AERSpriteRegister(const char* name,
     char* tmpName = malloc(strlen(name) + 1);
     assert(tmpName);
     sprite->name = strcpy(tmpName, name);
+    SetMaskSource(spriteIdx, path);
 
     LogInfo("Successfully registered sprite to index %i.", spriteIdx);
 
@@ -100,6 +821,59 @@ AER_EXPORT int32_t AERSpriteRegister(const char* name,
 #undef errRet
 }
 
+AER_EXPORT size_t AERSpriteRegisterAtlas(const char* filename) {
+#define errRet 0
+    EnsureArg(filename);
+    const char* modName = ModManGetCurrentMod()->name;
+    LogInfo("Registering sprite atlas \"%s\" for mod \"%s\"...", filename,
+            modName);
+    EnsureStageStrict(STAGE_SPRITE_REG);
+
+    FILE* file = fopen(CoreGetAbsAssetPath(modName, filename), "r");
+    Ensure(file, AER_BAD_FILE);
+    AtlasManifest manifest;
+    bool parsed = ParseAtlasManifest(file, &manifest);
+    fclose(file);
+    Ensure(parsed, AER_FAILED_PARSE);
+
+    bool namesFree = AtlasNamesAreFree(&manifest);
+    if (!namesFree)
+        FreeAtlasManifest(&manifest);
+    Ensure(namesFree, AER_BAD_VAL);
+
+    bool loaded = LoadAtlasPages(modName, filename, &manifest);
+    if (!loaded)
+        FreeAtlasManifest(&manifest);
+    Ensure(loaded, AER_BAD_FILE);
+
+    /* Hand the sprites over from the manifest. */
+    int32_t firstIdx = SPRITE_PACKED_BASE + (int32_t)numPackedSprites;
+    packedSprites =
+        realloc(packedSprites, (numPackedSprites + manifest.numSprites) *
+                                   sizeof(PackedSprite));
+    assert(packedSprites);
+    for (size_t idx = 0; idx < manifest.numSprites; idx++) {
+        PackedSprite* sprite = packedSprites + numPackedSprites;
+        *sprite = manifest.sprites[idx];
+        *FoxMapMInsert(const char*, int32_t, &spriteNames, sprite->name) =
+            SPRITE_PACKED_BASE + (int32_t)numPackedSprites++;
+    }
+    size_t numSprites = manifest.numSprites;
+    free(manifest.sprites);
+    manifest.sprites = NULL;
+    manifest.numSprites = 0;
+
+    LogInfo(
+        "Successfully registered %zu sprite(s) with %zu frame(s) to indices "
+        "%i through %i, using %zu texture page(s) instead of %zu.",
+        numSprites, manifest.numFrames, firstIdx,
+        firstIdx + (int32_t)numSprites - 1, manifest.numPages, numSprites);
+    FreeAtlasManifest(&manifest);
+
+    Ok(numSprites);
+#undef errRet
+}
+
 AER_EXPORT void AERSpriteReplace(int32_t spriteIdx,
                                  const char* filename,
                                  size_t numFrames,
@@ -115,10 +889,20 @@ AER_EXPORT void AERSpriteReplace(int32_t spriteIdx,
     EnsureArg(filename);
     EnsureMin(numFrames, 1);
 
-    hldfuncs.actionSpriteReplace(spriteIdx,
-                                 CoreGetAbsAssetPath(modName, filename),
-                                 numFrames, 0, 0, 0, 0, origX, origY);
-    /* TODO Check if replacement was successful. */
+    /* The engine does not report whether replacing worked, so check first. */
+    const char* path = CoreGetAbsAssetPath(modName, filename);
+    uint32_t width, height;
+    Ensure(AssetManValidate(path, &width, &height), AER_BAD_FILE);
+    SetMaskSource(spriteIdx, path);
+    /* Only defer when the sprite's size is known ahead of loading it. */
+    if (opts.lazySpriteReplace && width >= numFrames && height > 0) {
+        DeferReplace(spriteIdx, path, numFrames, width, height, origX, origY);
+        LogInfo("Deferred replacing sprite at index %i until it is used.",
+                spriteIdx);
+        Ok();
+    }
+    hldfuncs.actionSpriteReplace(spriteIdx, path, numFrames, 0, 0, 0, 0, origX,
+                                 origY);
 
     LogInfo("Successfully replaced sprite at index %i.", spriteIdx);
 
@@ -150,6 +934,10 @@ AER_EXPORT const char* AERSpriteGetName(int32_t spriteIdx) {
 #define errRet NULL
     EnsureStage(STAGE_SPRITE_REG);
 
+    PackedSprite* packed = SpriteManLookupPacked(spriteIdx);
+    if (packed)
+        Ok(packed->name);
+
     HLDSprite* sprite = HLDSpriteLookup(spriteIdx);
     EnsureLookup(sprite);
 
@@ -161,10 +949,15 @@ AER_EXPORT size_t AERSpriteGetNumFrames(int32_t spriteIdx) {
 #define errRet 0
     EnsureStage(STAGE_SPRITE_REG);
 
+    PackedSprite* packed = SpriteManLookupPacked(spriteIdx);
+    if (packed)
+        Ok(packed->numFrames);
+
     HLDSprite* sprite = HLDSpriteLookup(spriteIdx);
     EnsureLookup(sprite);
+    LazyReplace* pending = GetPendingReplace(spriteIdx);
 
-    Ok(sprite->numImages);
+    Ok(pending ? pending->numFrames : sprite->numImages);
 #undef errRet
 }
 
@@ -174,14 +967,19 @@ void AERSpriteGetSize(int32_t spriteIdx, size_t* width, size_t* height) {
     EnsureStage(STAGE_SPRITE_REG);
     EnsureArg(width || height);
 
-    HLDSprite* sprite = HLDSpriteLookup(spriteIdx);
-    EnsureLookup(sprite);
+    PackedSprite* packed = SpriteManLookupPacked(spriteIdx);
+    HLDSprite* sprite = packed ? NULL : HLDSpriteLookup(spriteIdx);
+    EnsureLookup(packed || sprite);
+    LazyReplace* pending = GetPendingReplace(spriteIdx);
+    HLDVecIntegral size = packed    ? packed->size
+                          : pending ? pending->size
+                                    : sprite->size;
 
     if (width) {
-        *width = sprite->size.x;
+        *width = size.x;
     }
     if (height) {
-        *height = sprite->size.y;
+        *height = size.y;
     }
 
     Ok();
@@ -193,14 +991,19 @@ AER_EXPORT void AERSpriteGetOrigin(int32_t spriteIdx, int32_t* x, int32_t* y) {
     EnsureStage(STAGE_SPRITE_REG);
     EnsureArg(x || y);
 
-    HLDSprite* sprite = HLDSpriteLookup(spriteIdx);
-    EnsureLookup(sprite);
+    PackedSprite* packed = SpriteManLookupPacked(spriteIdx);
+    HLDSprite* sprite = packed ? NULL : HLDSpriteLookup(spriteIdx);
+    EnsureLookup(packed || sprite);
+    LazyReplace* pending = GetPendingReplace(spriteIdx);
+    HLDVecIntegral origin = packed    ? packed->origin
+                            : pending ? pending->origin
+                                      : sprite->origin;
 
     if (x) {
-        *x = sprite->origin.x;
+        *x = origin.x;
     }
     if (y) {
-        *y = sprite->origin.y;
+        *y = origin.y;
     }
 
     Ok();
@@ -209,13 +1012,60 @@ AER_EXPORT void AERSpriteGetOrigin(int32_t spriteIdx, int32_t* x, int32_t* y) {
 
 AER_EXPORT void AERSpriteSetOrigin(int32_t spriteIdx, int32_t x, int32_t y) {
 #define errRet
-    EnsureStage(STAGE_SPRITE_REG);
+    EnsureStageMut(STAGE_SPRITE_REG);
 
-    HLDSprite* sprite = HLDSpriteLookup(spriteIdx);
-    EnsureLookup(sprite);
+    PackedSprite* packed = SpriteManLookupPacked(spriteIdx);
+    HLDSprite* sprite = packed ? NULL : HLDSpriteLookup(spriteIdx);
+    EnsureLookup(packed || sprite);
+    LazyReplace* pending = GetPendingReplace(spriteIdx);
 
-    sprite->origin = (HLDVecIntegral){.x = x, .y = y};
+    /* A pending replacement would overwrite the origin once applied. */
+    *(packed    ? &packed->origin
+      : pending ? &pending->origin
+                : &sprite->origin) = (HLDVecIntegral){.x = x, .y = y};
 
     Ok();
 #undef errRet
-}
\ No newline at end of file
+}
+
+AER_EXPORT void AERSpriteEnableMask(int32_t spriteIdx) {
+#define errRet
+    EnsureStageStrict(STAGE_SPRITE_REG);
+
+    PackedSprite* packed = SpriteManLookupPacked(spriteIdx);
+    if (packed) {
+        /* Packed sprites are tested against their pages' masks. */
+        for (uint32_t frame = 0; frame < packed->numFrames; frame++)
+            AddSpriteMask(packed->frames[frame].pageIdx)->enabled = true;
+        Ok();
+    }
+    EnsureLookup(HLDSpriteLookup(spriteIdx));
+    AddSpriteMask(spriteIdx)->enabled = true;
+
+    Ok();
+#undef errRet
+}
+
+AER_EXPORT bool AERSpriteMasksOverlap(int32_t spriteIdxA,
+                                      uint32_t frameA,
+                                      float xA,
+                                      float yA,
+                                      int32_t spriteIdxB,
+                                      uint32_t frameB,
+                                      float xB,
+                                      float yB) {
+#define errRet false
+    EnsureStagePast(STAGE_SPRITE_REG);
+
+    FrameMask maskA;
+    uint32_t numFrames = GetFrameMask(spriteIdxA, frameA, xA, yA, &maskA);
+    EnsureLookup(numFrames > 0);
+    EnsureMaxExc(frameA, numFrames);
+    FrameMask maskB;
+    numFrames = GetFrameMask(spriteIdxB, frameB, xB, yB, &maskB);
+    EnsureLookup(numFrames > 0);
+    EnsureMaxExc(frameB, numFrames);
+
+    Ok(FrameMasksOverlap(&maskA, &maskB));
+#undef errRet
+}
@@ -0,0 +1,708 @@
+/**
+ * @copyright 2021 the libaermre authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Packs PNG sprites into atlas pages and writes a manifest describing them
+ * (see `internal/atlas.h`), which mods register with `AERSpriteRegisterAtlas`.
+ *
+ * Usage: aeratlaspack [-s <page size>] [-p <padding>] <output> <sprite>...
+ *
+ * Each sprite is given as `[<name>=]<file>[:<frames>[:<x>:<y>]]`, where the
+ * image is a horizontal strip of `<frames>` frames with origin `<x>`, `<y>`,
+ * just like the arguments of `AERSpriteRegister`. The name defaults to the
+ * filename without its directory and extension. Writes `<output>.atlas` and
+ * one `<output>_<n>.png` per page.
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "internal/atlas.h"
+#include "internal/png.h"
+
+/* ----- PRIVATE MACROS ----- */
+
+#define DEFLATE_WINDOW_SIZE 32768
+
+#define DEFLATE_HASH_SIZE 65536
+
+#define DEFLATE_MAX_CHAIN 64
+
+/* ----- PRIVATE TYPES ----- */
+
+typedef struct Sprite {
+    char* name;
+    PNGImage image;
+    uint32_t numFrames;
+    uint32_t frameWidth;
+    int32_t origX;
+    int32_t origY;
+} Sprite;
+
+typedef struct Frame {
+    uint32_t spriteIdx;
+    uint32_t frameIdx;
+    uint32_t page;
+    uint32_t left;
+    uint32_t top;
+} Frame;
+
+typedef struct Page {
+    uint32_t width;
+    uint32_t height;
+    /* Shelf packing state. */
+    uint32_t shelfTop;
+    uint32_t shelfHeight;
+    uint32_t shelfLeft;
+} Page;
+
+typedef struct BitWriter {
+    uint8_t* data;
+    size_t size;
+    size_t capacity;
+    uint32_t bits;
+    uint32_t numBits;
+} BitWriter;
+
+/* ----- PRIVATE CONSTANTS ----- */
+
+static const uint8_t PNG_SIGNATURE[8] = {0x89, 'P',  'N',  'G',
+                                         '\r', '\n', 0x1a, '\n'};
+
+static const uint16_t LENGTH_BASES[29] = {
+    3,  4,  5,  6,  7,  8,  9,  10, 11,  13,  15,  17,  19,  23, 27,
+    31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+
+static const uint8_t LENGTH_EXTRAS[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1,
+                                          1, 1, 2, 2, 2, 2, 3, 3, 3, 3,
+                                          4, 4, 4, 4, 5, 5, 5, 5, 0};
+
+static const uint16_t DIST_BASES[30] = {
+    1,   2,   3,   4,   5,   7,    9,    13,   17,   25,
+    33,  49,  65,  97,  129, 193,  257,  385,  513,  769,
+    1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+
+static const uint8_t DIST_EXTRAS[30] = {0, 0, 0, 0, 1, 1, 2,  2,  3,  3,
+                                        4, 4, 5, 5, 6, 6, 7,  7,  8,  8,
+                                        9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+/* ----- PRIVATE GLOBALS ----- */
+
+static uint32_t crcTable[256];
+
+/* Sprites that frames refer to while sorting them. */
+static const Sprite* sortSprites;
+
+/* ----- PRIVATE FUNCTIONS ----- */
+
+static void* Alloc(size_t size) {
+    void* result = calloc(1, size ? size : 1);
+    if (!result) {
+        fputs("Out of memory.\n", stderr);
+        exit(1);
+    }
+
+    return result;
+}
+
+static void* Realloc(void* ptr, size_t size) {
+    void* result = realloc(ptr, size ? size : 1);
+    if (!result) {
+        fputs("Out of memory.\n", stderr);
+        exit(1);
+    }
+
+    return result;
+}
+
+static uint8_t* ReadFile(const char* path, size_t* size) {
+    FILE* file = fopen(path, "rb");
+    if (!file)
+        return NULL;
+
+    uint8_t* data = NULL;
+    long fileSize = -1;
+    if (fseek(file, 0, SEEK_END) == 0 && (fileSize = ftell(file)) >= 0 &&
+        fseek(file, 0, SEEK_SET) == 0) {
+        data = Alloc((size_t)fileSize);
+        if (fread(data, 1, (size_t)fileSize, file) != (size_t)fileSize) {
+            free(data);
+            data = NULL;
+        }
+    }
+    fclose(file);
+    *size = (size_t)fileSize;
+
+    return data;
+}
+
+static inline void WriteU32BE(uint8_t* data, uint32_t val) {
+    data[0] = (uint8_t)(val >> 24);
+    data[1] = (uint8_t)(val >> 16);
+    data[2] = (uint8_t)(val >> 8);
+    data[3] = (uint8_t)val;
+
+    return;
+}
+
+static void InitCrcTable(void) {
+    for (uint32_t idx = 0; idx < 256; idx++) {
+        uint32_t crc = idx;
+        for (uint32_t bit = 0; bit < 8; bit++)
+            crc = (crc & 1) ? 0xedb88320 ^ (crc >> 1) : crc >> 1;
+        crcTable[idx] = crc;
+    }
+
+    return;
+}
+
+static uint32_t Crc32(uint32_t crc, const uint8_t* data, size_t size) {
+    crc = ~crc;
+    for (size_t idx = 0; idx < size; idx++)
+        crc = crcTable[(crc ^ data[idx]) & 0xff] ^ (crc >> 8);
+
+    return ~crc;
+}
+
+static uint32_t Adler32(const uint8_t* data, size_t size) {
+    uint32_t a = 1;
+    uint32_t b = 0;
+    for (size_t idx = 0; idx < size; idx++) {
+        a = (a + data[idx]) % 65521;
+        b = (b + a) % 65521;
+    }
+
+    return (b << 16) | a;
+}
+
+static void WriteBits(BitWriter* writer, uint32_t bits, uint32_t numBits) {
+    writer->bits |= bits << writer->numBits;
+    writer->numBits += numBits;
+    while (writer->numBits >= 8) {
+        if (writer->size == writer->capacity) {
+            writer->capacity = writer->capacity * 2 + 1024;
+            writer->data = Realloc(writer->data, writer->capacity);
+        }
+        writer->data[writer->size++] = (uint8_t)writer->bits;
+        writer->bits >>= 8;
+        writer->numBits -= 8;
+    }
+
+    return;
+}
+
+/* Huffman codes are written starting with their most significant bit. */
+static void WriteCode(BitWriter* writer, uint32_t code, uint32_t numBits) {
+    uint32_t reversed = 0;
+    for (uint32_t bit = 0; bit < numBits; bit++)
+        reversed |= ((code >> bit) & 1) << (numBits - 1 - bit);
+    WriteBits(writer, reversed, numBits);
+
+    return;
+}
+
+static void WriteFixedLiteral(BitWriter* writer, uint32_t sym) {
+    if (sym < 144)
+        WriteCode(writer, 0x30 + sym, 8);
+    else if (sym < 256)
+        WriteCode(writer, 0x190 + sym - 144, 9);
+    else if (sym < 280)
+        WriteCode(writer, sym - 256, 7);
+    else
+        WriteCode(writer, 0xc0 + sym - 280, 8);
+
+    return;
+}
+
+static void WriteMatch(BitWriter* writer, uint32_t length, uint32_t dist) {
+    uint32_t lenSym = 28;
+    while (LENGTH_BASES[lenSym] > length)
+        lenSym--;
+    WriteFixedLiteral(writer, 257 + lenSym);
+    WriteBits(writer, length - LENGTH_BASES[lenSym], LENGTH_EXTRAS[lenSym]);
+
+    uint32_t distSym = 29;
+    while (DIST_BASES[distSym] > dist)
+        distSym--;
+    WriteCode(writer, distSym, 5);
+    WriteBits(writer, dist - DIST_BASES[distSym], DIST_EXTRAS[distSym]);
+
+    return;
+}
+
+/* A single fixed-Huffman block with greedy LZ77 matching. */
+static uint8_t* Deflate(const uint8_t* data, size_t size, size_t* outSize) {
+    BitWriter writer = {0};
+    WriteBits(&writer, 0x78, 8);
+    WriteBits(&writer, 0x01, 8);
+    WriteBits(&writer, 1, 1);
+    WriteBits(&writer, 1, 2);
+
+    int32_t* head = Alloc(DEFLATE_HASH_SIZE * sizeof(int32_t));
+    int32_t* prev = Alloc(DEFLATE_WINDOW_SIZE * sizeof(int32_t));
+    memset(head, 0xff, DEFLATE_HASH_SIZE * sizeof(int32_t));
+
+    size_t pos = 0;
+    while (pos < size) {
+        uint32_t bestLen = 0;
+        uint32_t bestDist = 0;
+        if (pos + 3 <= size) {
+            uint32_t hash =
+                ((data[pos] << 16 | data[pos + 1] << 8 | data[pos + 2]) *
+                 2654435761u) >>
+                16;
+            size_t maxLen = (size - pos < 258) ? size - pos : 258;
+            int32_t cand = head[hash];
+            for (uint32_t chain = 0; cand >= 0 && chain < DEFLATE_MAX_CHAIN;
+                 chain++) {
+                size_t dist = pos - (size_t)cand;
+                if (dist > DEFLATE_WINDOW_SIZE)
+                    break;
+                uint32_t len = 0;
+                while (len < maxLen && data[cand + len] == data[pos + len])
+                    len++;
+                if (len > bestLen) {
+                    bestLen = len;
+                    bestDist = (uint32_t)dist;
+                    if (len == maxLen)
+                        break;
+                }
+                int32_t next = prev[cand % DEFLATE_WINDOW_SIZE];
+                if (next >= cand)
+                    break;
+                cand = next;
+            }
+            prev[pos % DEFLATE_WINDOW_SIZE] = head[hash];
+            head[hash] = (int32_t)pos;
+        }
+
+        if (bestLen >= 3) {
+            WriteMatch(&writer, bestLen, bestDist);
+            /* Index the skipped positions so later matches can find them. */
+            for (size_t idx = pos + 1; idx < pos + bestLen && idx + 3 <= size;
+                 idx++) {
+                uint32_t hash =
+                    ((data[idx] << 16 | data[idx + 1] << 8 | data[idx + 2]) *
+                     2654435761u) >>
+                    16;
+                prev[idx % DEFLATE_WINDOW_SIZE] = head[hash];
+                head[hash] = (int32_t)idx;
+            }
+            pos += bestLen;
+        } else {
+            WriteFixedLiteral(&writer, data[pos++]);
+        }
+    }
+    WriteFixedLiteral(&writer, 256);
+    WriteBits(&writer, 0, (8 - writer.numBits) % 8);
+
+    uint32_t adler = Adler32(data, size);
+    for (int32_t shift = 24; shift >= 0; shift -= 8)
+        WriteBits(&writer, (adler >> shift) & 0xff, 8);
+
+    free(head);
+    free(prev);
+    *outSize = writer.size;
+
+    return writer.data;
+}
+
+static inline uint8_t Paeth(uint8_t a, uint8_t b, uint8_t c) {
+    int32_t p = (int32_t)a + b - c;
+    int32_t pa = abs(p - a);
+    int32_t pb = abs(p - b);
+    int32_t pc = abs(p - c);
+
+    return (pa <= pb && pa <= pc) ? a : (pb <= pc) ? b : c;
+}
+
+static void WriteChunk(FILE* file,
+                       const char* type,
+                       const uint8_t* body,
+                       size_t length) {
+    uint8_t header[8];
+    WriteU32BE(header, (uint32_t)length);
+    memcpy(header + 4, type, 4);
+    uint32_t crc = Crc32(Crc32(0, header + 4, 4), body, length);
+    uint8_t footer[4];
+    WriteU32BE(footer, crc);
+
+    fwrite(header, 1, 8, file);
+    fwrite(body, 1, length, file);
+    fwrite(footer, 1, 4, file);
+
+    return;
+}
+
+static bool EncodePNG(const char* path, const PNGImage* image) {
+    size_t stride = (size_t)image->width * 4;
+    size_t rawSize = (stride + 1) * image->height;
+    uint8_t* raw = Alloc(rawSize);
+
+    /* Pick each row's filter by the smallest sum of absolute residuals. */
+    uint8_t* candidates = Alloc(stride * 5);
+    for (uint32_t y = 0; y < image->height; y++) {
+        const uint8_t* row = image->pixels + y * stride;
+        const uint8_t* prevRow = (y > 0) ? row - stride : NULL;
+        uint32_t bestFilter = 0;
+        uint64_t bestSum = UINT64_MAX;
+        for (uint32_t filter = 0; filter < 5; filter++) {
+            uint8_t* out = candidates + filter * stride;
+            uint64_t sum = 0;
+            for (size_t x = 0; x < stride; x++) {
+                uint8_t a = (x >= 4) ? row[x - 4] : 0;
+                uint8_t b = prevRow ? prevRow[x] : 0;
+                uint8_t c = (prevRow && x >= 4) ? prevRow[x - 4] : 0;
+                uint8_t pred = (filter == 0)   ? 0
+                               : (filter == 1) ? a
+                               : (filter == 2) ? b
+                               : (filter == 3) ? (uint8_t)((a + b) / 2)
+                                               : Paeth(a, b, c);
+                out[x] = row[x] - pred;
+                sum += (out[x] < 128) ? out[x] : 256 - out[x];
+            }
+            if (sum < bestSum) {
+                bestSum = sum;
+                bestFilter = filter;
+            }
+        }
+        raw[y * (stride + 1)] = (uint8_t)bestFilter;
+        memcpy(raw + y * (stride + 1) + 1, candidates + bestFilter * stride,
+               stride);
+    }
+    free(candidates);
+
+    size_t compressedSize;
+    uint8_t* compressed = Deflate(raw, rawSize, &compressedSize);
+    free(raw);
+
+    FILE* file = fopen(path, "wb");
+    if (!file) {
+        free(compressed);
+        return false;
+    }
+
+    uint8_t ihdr[13] = {0};
+    WriteU32BE(ihdr, image->width);
+    WriteU32BE(ihdr + 4, image->height);
+    ihdr[8] = 8;
+    ihdr[9] = 6;
+    fwrite(PNG_SIGNATURE, 1, 8, file);
+    WriteChunk(file, "IHDR", ihdr, sizeof(ihdr));
+    WriteChunk(file, "IDAT", compressed, compressedSize);
+    WriteChunk(file, "IEND", NULL, 0);
+    free(compressed);
+
+    return fclose(file) == 0;
+}
+
+static bool ParseSpriteArg(const char* arg, Sprite* sprite, char** path) {
+    const char* eq = strchr(arg, '=');
+    const char* file = eq ? eq + 1 : arg;
+    const char* colon = strchr(file, ':');
+    size_t pathLen = colon ? (size_t)(colon - file) : strlen(file);
+
+    *path = Alloc(pathLen + 1);
+    memcpy(*path, file, pathLen);
+
+    if (eq) {
+        sprite->name = Alloc((size_t)(eq - arg) + 1);
+        memcpy(sprite->name, arg, (size_t)(eq - arg));
+    } else {
+        const char* base = strrchr(*path, '/');
+        base = base ? base + 1 : *path;
+        const char* ext = strrchr(base, '.');
+        size_t nameLen = ext ? (size_t)(ext - base) : strlen(base);
+        sprite->name = Alloc(nameLen + 1);
+        memcpy(sprite->name, base, nameLen);
+    }
+
+    sprite->numFrames = 1;
+    sprite->origX = 0;
+    sprite->origY = 0;
+    if (colon) {
+        int numRead = 0;
+        int numMatched = sscanf(colon, ":%u%n:%d:%d%n", &sprite->numFrames,
+                                &numRead, &sprite->origX, &sprite->origY,
+                                &numRead);
+        if ((numMatched != 1 && numMatched != 3) || colon[numRead] != '\0')
+            return false;
+    }
+
+    return sprite->name[0] != '\0' && !strpbrk(sprite->name, " \t\r\n") &&
+           sprite->numFrames > 0;
+}
+
+static int CompareFrames(const void* a, const void* b) {
+    const Frame* frameA = a;
+    const Frame* frameB = b;
+    const Sprite* spriteA = sortSprites + frameA->spriteIdx;
+    const Sprite* spriteB = sortSprites + frameB->spriteIdx;
+
+    if (spriteA->image.height != spriteB->image.height)
+        return (spriteA->image.height > spriteB->image.height) ? -1 : 1;
+    if (spriteA->frameWidth != spriteB->frameWidth)
+        return (spriteA->frameWidth > spriteB->frameWidth) ? -1 : 1;
+    if (frameA->spriteIdx != frameB->spriteIdx)
+        return (frameA->spriteIdx < frameB->spriteIdx) ? -1 : 1;
+
+    return (frameA->frameIdx < frameB->frameIdx) ? -1 : 1;
+}
+
+/*
+ * Shelf packing of frames sorted by decreasing height: frames fill a shelf
+ * from left to right, and a new shelf (or page) starts once one doesn't fit.
+ */
+static uint32_t PackFrames(const Sprite* sprites,
+                           Frame* frames,
+                           size_t numFrames,
+                           uint32_t pageSize,
+                           uint32_t padding,
+                           Page** pages) {
+    uint32_t numPages = 0;
+    *pages = NULL;
+
+    sortSprites = sprites;
+    qsort(frames, numFrames, sizeof(Frame), CompareFrames);
+    for (size_t idx = 0; idx < numFrames; idx++) {
+        Frame* frame = frames + idx;
+        const Sprite* sprite = sprites + frame->spriteIdx;
+        uint32_t width = sprite->frameWidth + padding;
+        uint32_t height = sprite->image.height + padding;
+
+        Page* page = (numPages > 0) ? *pages + numPages - 1 : NULL;
+        if (page && page->shelfLeft + width > pageSize) {
+            page->shelfTop += page->shelfHeight;
+            page->shelfLeft = 0;
+            page->shelfHeight = 0;
+        }
+        if (!page || page->shelfTop + height > pageSize) {
+            *pages = Realloc(*pages, (numPages + 1) * sizeof(Page));
+            page = *pages + numPages++;
+            *page = (Page){0};
+        }
+
+        frame->page = numPages - 1;
+        frame->left = page->shelfLeft;
+        frame->top = page->shelfTop;
+        page->shelfLeft += width;
+        if (height > page->shelfHeight)
+            page->shelfHeight = height;
+        if (frame->left + sprite->frameWidth > page->width)
+            page->width = frame->left + sprite->frameWidth;
+        if (frame->top + sprite->image.height > page->height)
+            page->height = frame->top + sprite->image.height;
+    }
+
+    return numPages;
+}
+
+static int CompareFrameOrder(const void* a, const void* b) {
+    const Frame* frameA = a;
+    const Frame* frameB = b;
+
+    if (frameA->spriteIdx != frameB->spriteIdx)
+        return (frameA->spriteIdx < frameB->spriteIdx) ? -1 : 1;
+
+    return (frameA->frameIdx < frameB->frameIdx) ? -1 : 1;
+}
+
+static void PrintUsage(const char* prog) {
+    fprintf(stderr,
+            "Usage: %s [-s <page size>] [-p <padding>] <output> "
+            "<sprite>...\n"
+            "Sprites are given as [<name>=]<file>[:<frames>[:<x>:<y>]].\n",
+            prog);
+
+    return;
+}
+
+/* ----- PUBLIC FUNCTIONS ----- */
+
+int main(int argc, char** argv) {
+    uint32_t pageSize = 2048;
+    uint32_t padding = 2;
+
+    int argIdx = 1;
+    while (argIdx + 1 < argc && argv[argIdx][0] == '-') {
+        char* end;
+        unsigned long val = strtoul(argv[argIdx + 1], &end, 10);
+        if (*end != '\0' || val > ATLAS_MAX_PAGE_SIZE) {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+        if (strcmp(argv[argIdx], "-s") == 0) {
+            pageSize = (uint32_t)val;
+        } else if (strcmp(argv[argIdx], "-p") == 0) {
+            padding = (uint32_t)val;
+        } else {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+        argIdx += 2;
+    }
+    if (argc - argIdx < 2) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+    const char* output = argv[argIdx++];
+
+    InitCrcTable();
+
+    /* Load sprites. */
+    size_t numSprites = (size_t)(argc - argIdx);
+    Sprite* sprites = Alloc(numSprites * sizeof(Sprite));
+    size_t numFrames = 0;
+    for (size_t idx = 0; idx < numSprites; idx++) {
+        Sprite* sprite = sprites + idx;
+        char* path;
+        if (!ParseSpriteArg(argv[argIdx + idx], sprite, &path)) {
+            fprintf(stderr, "Invalid sprite \"%s\".\n", argv[argIdx + idx]);
+            return 1;
+        }
+        for (size_t prevIdx = 0; prevIdx < idx; prevIdx++) {
+            if (strcmp(sprites[prevIdx].name, sprite->name) == 0) {
+                fprintf(stderr, "Sprite name \"%s\" is used twice.\n",
+                        sprite->name);
+                return 1;
+            }
+        }
+
+        size_t size;
+        uint8_t* data = ReadFile(path, &size);
+        if (!data || !PNGDecode(data, size, &sprite->image)) {
+            fprintf(stderr,
+                    "Could not read PNG \"%s\" (only non-interlaced images "
+                    "with 8 bits per channel, or fewer for grayscale and "
+                    "palette images, are supported).\n",
+                    path);
+            return 1;
+        }
+        free(data);
+        free(path);
+
+        sprite->frameWidth = sprite->image.width / sprite->numFrames;
+        if (sprite->frameWidth == 0 ||
+            sprite->frameWidth + padding > pageSize ||
+            sprite->image.height + padding > pageSize) {
+            fprintf(stderr, "Frames of sprite \"%s\" do not fit a page.\n",
+                    sprite->name);
+            return 1;
+        }
+        numFrames += sprite->numFrames;
+    }
+
+    /* Pack frames. */
+    Frame* frames = Alloc(numFrames * sizeof(Frame));
+    size_t frameIdx = 0;
+    for (uint32_t spriteIdx = 0; spriteIdx < numSprites; spriteIdx++) {
+        for (uint32_t idx = 0; idx < sprites[spriteIdx].numFrames; idx++)
+            frames[frameIdx++] = (Frame){.spriteIdx = spriteIdx,
+                                         .frameIdx = idx};
+    }
+    Page* pages;
+    uint32_t numPages =
+        PackFrames(sprites, frames, numFrames, pageSize, padding, &pages);
+    qsort(frames, numFrames, sizeof(Frame), CompareFrameOrder);
+
+    /* Write pages. */
+    size_t pathSize = strlen(output) + 32;
+    char* path = Alloc(pathSize);
+    uint64_t usedPixels = 0;
+    uint64_t pagePixels = 0;
+    for (uint32_t pageIdx = 0; pageIdx < numPages; pageIdx++) {
+        Page* page = pages + pageIdx;
+        PNGImage image = {.width = page->width,
+                       .height = page->height,
+                       .pixels = Alloc((size_t)page->width * page->height * 4)};
+        for (size_t idx = 0; idx < numFrames; idx++) {
+            const Frame* frame = frames + idx;
+            const Sprite* sprite = sprites + frame->spriteIdx;
+            if (frame->page != pageIdx)
+                continue;
+
+            size_t rowSize = (size_t)sprite->frameWidth * 4;
+            for (uint32_t y = 0; y < sprite->image.height; y++) {
+                const uint8_t* src =
+                    sprite->image.pixels +
+                    ((size_t)y * sprite->image.width +
+                     (size_t)frame->frameIdx * sprite->frameWidth) *
+                        4;
+                uint8_t* dst = image.pixels +
+                               ((size_t)(frame->top + y) * image.width +
+                                frame->left) *
+                                   4;
+                memcpy(dst, src, rowSize);
+            }
+            usedPixels += (uint64_t)sprite->frameWidth * sprite->image.height;
+        }
+        pagePixels += (uint64_t)page->width * page->height;
+
+        snprintf(path, pathSize, "%s_%u.png", output, pageIdx);
+        if (!EncodePNG(path, &image)) {
+            fprintf(stderr, "Could not write \"%s\".\n", path);
+            return 1;
+        }
+        free(image.pixels);
+    }
+
+    /* Write manifest. */
+    snprintf(path, pathSize, "%s.atlas", output);
+    FILE* manifest = fopen(path, "w");
+    if (!manifest) {
+        fprintf(stderr, "Could not write \"%s\".\n", path);
+        return 1;
+    }
+    const char* baseName = strrchr(output, '/');
+    baseName = baseName ? baseName + 1 : output;
+    fprintf(manifest, "%s %u\n", ATLAS_MAGIC, ATLAS_VERSION);
+    for (uint32_t pageIdx = 0; pageIdx < numPages; pageIdx++)
+        fprintf(manifest, "page %s_%u.png\n", baseName, pageIdx);
+    frameIdx = 0;
+    for (size_t spriteIdx = 0; spriteIdx < numSprites; spriteIdx++) {
+        const Sprite* sprite = sprites + spriteIdx;
+        fprintf(manifest, "sprite %s %u %u %u %d %d\n", sprite->name,
+                sprite->numFrames, sprite->frameWidth, sprite->image.height,
+                sprite->origX, sprite->origY);
+        for (uint32_t idx = 0; idx < sprite->numFrames; idx++, frameIdx++) {
+            const Frame* frame = frames + frameIdx;
+            fprintf(manifest, "frame %u %u %u\n", frame->page, frame->left,
+                    frame->top);
+        }
+    }
+    if (fclose(manifest) != 0) {
+        fprintf(stderr, "Could not write \"%s\".\n", path);
+        return 1;
+    }
+
+    printf("Packed %zu sprite(s) with %zu frame(s) into %u page(s) (%.1f%% "
+           "of page area used) instead of %zu separate image(s).\n",
+           numSprites, numFrames, numPages,
+           pagePixels ? 100.0 * usedPixels / pagePixels : 0.0, numSprites);
+
+    for (size_t idx = 0; idx < numSprites; idx++) {
+        free(sprites[idx].name);
+        free(sprites[idx].image.pixels);
+    }
+    free(sprites);
+    free(frames);
+    free(pages);
+    free(path);
+
+    return 0;
+}
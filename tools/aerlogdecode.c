@@ -0,0 +1,434 @@
+/**
+ * @copyright 2021 the libaermre authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Decodes binary logs written by the MRE (see `log.binary.path`) back into
+ * the same text the regular log would have contained.
+ *
+ * Usage: aerlogdecode <binary log>
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "internal/binlog.h"
+
+/* ----- PRIVATE MACROS ----- */
+
+#define MAX_SPEC_SIZE 64
+
+/* ----- PRIVATE TYPES ----- */
+
+typedef struct StringTable {
+    size_t size;
+    char** strs;
+} StringTable;
+
+typedef struct ArgReader {
+    const uint8_t* cur;
+    const uint8_t* end;
+    bool failed;
+} ArgReader;
+
+/* ----- PRIVATE CONSTANTS ----- */
+
+static const char* MSG_FMT = "[%s][aer][%s] (%s) ";
+
+static const char* LVL_STRS[3] = {"INFO", "WARNING", "ERROR"};
+
+/* ----- PRIVATE GLOBALS ----- */
+
+static BinLogHeader header;
+
+static StringTable formats = {0};
+
+static StringTable modules = {0};
+
+/* ----- PRIVATE FUNCTIONS ----- */
+
+static void TableSet(StringTable* table, uint32_t id, const char* str) {
+    if (id >= table->size) {
+        size_t newSize = id + 1;
+        table->strs = realloc(table->strs, newSize * sizeof(char*));
+        if (!table->strs) {
+            fputs("Out of memory.\n", stderr);
+            exit(1);
+        }
+        memset(table->strs + table->size, 0,
+               (newSize - table->size) * sizeof(char*));
+        table->size = newSize;
+    }
+    free(table->strs[id]);
+    table->strs[id] = strdup(str);
+
+    return;
+}
+
+static const char* TableGet(const StringTable* table, uint32_t id) {
+    return (id < table->size && table->strs[id]) ? table->strs[id] : NULL;
+}
+
+static void TableFree(StringTable* table) {
+    for (size_t idx = 0; idx < table->size; idx++)
+        free(table->strs[idx]);
+    free(table->strs);
+    *table = (StringTable){0};
+
+    return;
+}
+
+static bool ReadBytes(ArgReader* reader, void* dest, size_t size) {
+    if (reader->failed || (size_t)(reader->end - reader->cur) < size) {
+        reader->failed = true;
+        memset(dest, 0, size);
+        return false;
+    }
+    memcpy(dest, reader->cur, size);
+    reader->cur += size;
+
+    return true;
+}
+
+static int64_t ReadInt(ArgReader* reader) {
+    int64_t val;
+    ReadBytes(reader, &val, sizeof(val));
+
+    return val;
+}
+
+/* Narrow a stored integer back down to the size its conversion expected. */
+static uint64_t NarrowInt(int64_t val, uint32_t bits, bool isSigned) {
+    if (bits >= 64)
+        return val;
+    uint64_t mask = (UINT64_C(1) << bits) - 1;
+    uint64_t result = (uint64_t)val & mask;
+    if (isSigned && (result >> (bits - 1)) & 1)
+        result |= ~mask;
+
+    return result;
+}
+
+static void PrintSpec(const char* spec,
+                      int numStars,
+                      const int* stars,
+                      bool isInt,
+                      long long intVal,
+                      double doubleVal,
+                      const char* strVal) {
+    switch (numStars * 3 + (isInt ? 0 : (strVal ? 1 : 2))) {
+        case 0:
+            printf(spec, intVal);
+            break;
+        case 1:
+            printf(spec, strVal);
+            break;
+        case 2:
+            printf(spec, doubleVal);
+            break;
+        case 3:
+            printf(spec, stars[0], intVal);
+            break;
+        case 4:
+            printf(spec, stars[0], strVal);
+            break;
+        case 5:
+            printf(spec, stars[0], doubleVal);
+            break;
+        case 6:
+            printf(spec, stars[0], stars[1], intVal);
+            break;
+        case 7:
+            printf(spec, stars[0], stars[1], strVal);
+            break;
+        default:
+            printf(spec, stars[0], stars[1], doubleVal);
+    }
+
+    return;
+}
+
+/*
+ * Print a message by walking its format string and printing one conversion
+ * at a time, so that each stored argument can be passed with a known type.
+ */
+static void PrintMessage(const char* fmt, ArgReader* reader) {
+    const char* cur = fmt;
+    while (*cur) {
+        if (*cur != '%') {
+            putchar(*cur++);
+            continue;
+        }
+        if (cur[1] == '%') {
+            putchar('%');
+            cur += 2;
+            continue;
+        }
+
+        /* Copy flags, width and precision, reading any `*` arguments. */
+        char spec[MAX_SPEC_SIZE];
+        size_t specSize = 0;
+        int stars[2];
+        int numStars = 0;
+        spec[specSize++] = *cur++;
+        while (*cur && strchr("-+ #0'.*0123456789", *cur) &&
+               specSize < MAX_SPEC_SIZE - 4) {
+            if (*cur == '*' && numStars < 2)
+                stars[numStars++] = (int)ReadInt(reader);
+            spec[specSize++] = *cur++;
+        }
+
+        /* Work out the size of integer arguments from the length. */
+        uint32_t bits = header.sizeofInt * 8;
+        switch (*cur) {
+            case 'h':
+                bits = (cur[1] == 'h') ? 8 : 16;
+                cur += (cur[1] == 'h') ? 2 : 1;
+                break;
+            case 'l':
+                bits = (cur[1] == 'l') ? 64 : header.sizeofLong * 8;
+                cur += (cur[1] == 'l') ? 2 : 1;
+                break;
+            case 'q':
+            case 'j':
+                bits = 64;
+                cur++;
+                break;
+            case 'z':
+            case 't':
+                bits = header.sizeofSize * 8;
+                cur++;
+                break;
+            default:
+                break;
+        }
+
+        char conv = *cur;
+        if (conv)
+            cur++;
+        switch (conv) {
+            case 'd':
+            case 'i':
+            case 'u':
+            case 'o':
+            case 'x':
+            case 'X': {
+                bool isSigned = (conv == 'd' || conv == 'i');
+                uint64_t val = NarrowInt(ReadInt(reader), bits, isSigned);
+                spec[specSize++] = 'l';
+                spec[specSize++] = 'l';
+                spec[specSize++] = conv;
+                spec[specSize] = '\0';
+                PrintSpec(spec, numStars, stars, true, (long long)val, 0.0,
+                          NULL);
+                break;
+            }
+
+            case 'c':
+                spec[specSize++] = 'c';
+                spec[specSize] = '\0';
+                PrintSpec(spec, numStars, stars, true,
+                          (unsigned char)ReadInt(reader), 0.0, NULL);
+                break;
+
+            case 'e':
+            case 'E':
+            case 'f':
+            case 'F':
+            case 'g':
+            case 'G':
+            case 'a':
+            case 'A': {
+                double val;
+                ReadBytes(reader, &val, sizeof(val));
+                spec[specSize++] = conv;
+                spec[specSize] = '\0';
+                PrintSpec(spec, numStars, stars, false, 0, val, NULL);
+                break;
+            }
+
+            case 's': {
+                uint32_t len;
+                ReadBytes(reader, &len, sizeof(len));
+                char* str = malloc((size_t)len + 1);
+                if (!str || !ReadBytes(reader, str, len)) {
+                    free(str);
+                    reader->failed = true;
+                    break;
+                }
+                str[len] = '\0';
+                spec[specSize++] = 's';
+                spec[specSize] = '\0';
+                PrintSpec(spec, numStars, stars, false, 0, 0.0, str);
+                free(str);
+                break;
+            }
+
+            case 'p': {
+                uint64_t val;
+                ReadBytes(reader, &val, sizeof(val));
+                if (val)
+                    printf("0x%llx", (unsigned long long)val);
+                else
+                    fputs("(nil)", stdout);
+                break;
+            }
+
+            default:
+                reader->failed = true;
+        }
+
+        if (reader->failed) {
+            fputs("<truncated>", stdout);
+            return;
+        }
+    }
+
+    return;
+}
+
+static void PrintPrefix(const BinLogMessageRecord* rec) {
+    char timeBuf[9] = "??:??:??";
+    time_t rawTime = (time_t)rec->time;
+    struct tm timeInfo;
+    if (localtime_r(&rawTime, &timeInfo))
+        strftime(timeBuf, sizeof(timeBuf), "%H:%M:%S", &timeInfo);
+
+    const char* moduleName = TableGet(&modules, rec->moduleId);
+    uint8_t lvl = rec->base.level;
+    printf(MSG_FMT, timeBuf, moduleName ? moduleName : "?",
+           (lvl < 3) ? LVL_STRS[lvl] : "?");
+
+    return;
+}
+
+static int Decode(const uint8_t* data, size_t size) {
+    if (size < sizeof(BinLogHeader)) {
+        fputs("File is too small to be a binary log.\n", stderr);
+        return 1;
+    }
+    memcpy(&header, data, sizeof(header));
+    if (memcmp(header.magic, BINLOG_MAGIC, sizeof(BINLOG_MAGIC)) != 0) {
+        fputs("File is not a binary log.\n", stderr);
+        return 1;
+    }
+    if (header.version != BINLOG_VERSION) {
+        fprintf(stderr, "Unsupported binary log version %u.\n",
+                header.version);
+        return 1;
+    }
+
+    size_t offset = header.headerSize;
+    while (offset + sizeof(BinLogRecordHeader) <= size) {
+        const uint8_t* recData = data + offset;
+        BinLogRecordHeader base;
+        memcpy(&base, recData, sizeof(base));
+        if (base.kind == BINLOG_NONE)
+            break;
+        if (base.size < sizeof(BinLogRecordHeader) ||
+            base.size > size - offset) {
+            fprintf(stderr, "Corrupt record at offset %zu.\n", offset);
+            return 1;
+        }
+        const uint8_t* recEnd = recData + base.size;
+
+        switch (base.kind) {
+            case BINLOG_FORMAT:
+            case BINLOG_MODULE: {
+                BinLogFormatRecord rec;
+                if (base.size <= sizeof(rec) || recEnd[-1] != '\0')
+                    break;
+                memcpy(&rec, recData, sizeof(rec));
+                TableSet((base.kind == BINLOG_FORMAT) ? &formats : &modules,
+                         rec.formatId, (const char*)recData + sizeof(rec));
+                break;
+            }
+
+            case BINLOG_MESSAGE:
+            case BINLOG_TEXT: {
+                BinLogMessageRecord rec;
+                if (base.size < sizeof(rec))
+                    break;
+                memcpy(&rec, recData, sizeof(rec));
+                PrintPrefix(&rec);
+                if (base.kind == BINLOG_TEXT) {
+                    fwrite(recData + sizeof(rec), 1,
+                           strnlen((const char*)recData + sizeof(rec),
+                                   base.size - sizeof(rec)),
+                           stdout);
+                } else {
+                    const char* fmt = TableGet(&formats, rec.formatId);
+                    ArgReader reader = {.cur = recData + sizeof(rec),
+                                        .end = recEnd};
+                    if (fmt)
+                        PrintMessage(fmt, &reader);
+                    else
+                        printf("<unknown format %u>", rec.formatId);
+                }
+                putchar('\n');
+                break;
+            }
+
+            default:
+                /* Skip unknown records. */
+                break;
+        }
+
+        offset += base.size;
+    }
+
+    if (header.numDropped > 0)
+        fprintf(stderr, "%llu message(s) were dropped (log was full).\n",
+                (unsigned long long)header.numDropped);
+
+    return 0;
+}
+
+/* ----- PUBLIC FUNCTIONS ----- */
+
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        fprintf(stderr, "Usage: %s <binary log>\n", argv[0]);
+        return 1;
+    }
+
+    FILE* file = fopen(argv[1], "rb");
+    if (!file) {
+        fprintf(stderr, "Could not open \"%s\".\n", argv[1]);
+        return 1;
+    }
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    uint8_t* data = malloc((size > 0) ? (size_t)size : 1);
+    if (!data || size < 0 || fread(data, 1, size, file) != (size_t)size) {
+        fprintf(stderr, "Could not read \"%s\".\n", argv[1]);
+        fclose(file);
+        free(data);
+        return 1;
+    }
+    fclose(file);
+
+    int result = Decode(data, size);
+
+    TableFree(&formats);
+    TableFree(&modules);
+    free(data);
+
+    return result;
+}